@@ -10,6 +10,7 @@
 #define THIS_DEVICE_ADDRESS {0xed,0xc0,0xbb,0x25}
 #endif // THIS_DEVICE_ADDRESS
 // USE_LCD_CHARGE_PUMP is not set
+// USE_LCD_DOUBLE_BUFFER is not set
 #define USE_WATCHDOG
 // DEBUG is not set
 #define CONFIG_DAY_OF_WEEK
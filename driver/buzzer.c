@@ -68,7 +68,6 @@ struct buzzer sBuzzer;
 
 // *************************************************************************************************
 // Extern section
-//extern u16 timer0_A3_ticks_g;
 
 
 
@@ -117,12 +116,8 @@ void start_buzzer(u8 cycles, u16 on_time, u16 off_time)
 		// Allow buzzer PWM output on P2.7
 		P2SEL |= BIT7;
 
-		// Activate Timer0_A3 periodic interrupts
-		fptr_Timer0_A3_function = toggle_buzzer;
-		Timer0_A3_Start(sBuzzer.on_time);
-
-		// Preload timer advance variable
-		sTimer.timer0_A3_ticks = sBuzzer.off_time;
+		// Turn off output after on_time
+		Timer0_A4_Start(TIMER0_A4_BUZZER, sBuzzer.on_time, 0, toggle_buzzer);
 
 		// Start with buzzer output on
 		sBuzzer.state 	 	= BUZZER_ON_OUTPUT_ENABLED;
@@ -156,15 +151,15 @@ void toggle_buzzer(void)
 		// Update buzzer state
 		sBuzzer.state = BUZZER_ON_OUTPUT_DISABLED;
 		
-		// Reload Timer0_A4 IRQ to restart output
-		sTimer.timer0_A3_ticks = sBuzzer.on_time;
+		// Restart output after off_time
+		Timer0_A4_Start(TIMER0_A4_BUZZER, sBuzzer.off_time, 0, toggle_buzzer);
 	}
 	else // Turn on buzzer
 	{
 		// Decrement buzzer total cycles
 		countdown_buzzer();
 		
-		// Reload Timer0_A4 to stop output if sBuzzer.time > 0
+		// Restart output if sBuzzer.time > 0
 		if (sBuzzer.state != BUZZER_OFF) 
 		{
 			// Reset timer TA1
@@ -177,8 +172,8 @@ void toggle_buzzer(void)
 			// Update buzzer state
 			sBuzzer.state = BUZZER_ON_OUTPUT_ENABLED;
 	
-			// Reload Timer0_A4 IRQ to turn off output
-			sTimer.timer0_A3_ticks = sBuzzer.off_time;
+			// Turn off output after on_time
+			Timer0_A4_Start(TIMER0_A4_BUZZER, sBuzzer.on_time, 0, toggle_buzzer);
 		}
 	}
 }
@@ -202,8 +197,8 @@ void stop_buzzer(void)
 	// Clear PWM timer interrupt    
 	TA1CCTL0 &= ~CCIE; 
 
-	// Disable periodic start/stop interrupts
-	Timer0_A3_Stop();
+	// Disable start/stop timer
+	Timer0_A4_Stop(TIMER0_A4_BUZZER);
 
 	// Clear variables
 	reset_buzzer();
@@ -0,0 +1,235 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Calendar arithmetic shared by date, time sync, sidereal time and alarms. Dates are converted to
+// a day count since the epoch with a table of month offsets; the way back needs one division by 
+// the seconds of a day and short corrections instead of year by year loops.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "calendar.h"
+
+// logic
+#include "clock.h"
+#include "date.h"
+
+
+// *************************************************************************************************
+// Prototypes section
+u8 calendar_month_days(u16 year, u8 month);
+u16 calendar_days(u16 year, u8 month, u8 day);
+u32 calendar_seconds(u16 year, u8 month, u8 day, u8 hour, u8 minute, u8 second);
+void calendar_split(u32 seconds, struct calendar * cal);
+u8 calendar_weekday(u16 days);
+u32 calendar_now(void);
+u8 calendar_is_leap(u16 year);
+u16 calendar_year_days(u16 year);
+
+
+// *************************************************************************************************
+// Defines section
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Days before first day of month in a non-leap year
+const u16 calendar_month_offset[13] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365};
+
+
+// *************************************************************************************************
+// Extern section
+
+
+// *************************************************************************************************
+// @fn          calendar_is_leap
+// @brief       Check for leap year. Within 2000 .. 2135 only 2100 is an exception to the 4 year rule.
+// @param       u16 year		2000 .. 2135
+// @return      u8				1 = leap year
+// *************************************************************************************************
+u8 calendar_is_leap(u16 year)
+{
+	return (((year & 3) == 0) && (year != 2100));
+}
+
+
+// *************************************************************************************************
+// @fn          calendar_month_days
+// @brief       Return number of days of a month.
+// @param       u16 year		2000 .. 2135
+//				u8 month		1 .. 12
+// @return      u8				Day count of month, 0 for invalid month
+// *************************************************************************************************
+u8 calendar_month_days(u16 year, u8 month)
+{
+	if ((month < 1) || (month > 12)) return (0);
+	if ((month == 2) && calendar_is_leap(year)) return (29);
+	
+	return (u8)(calendar_month_offset[month] - calendar_month_offset[month-1]);
+}
+
+
+// *************************************************************************************************
+// @fn          calendar_year_days
+// @brief       Days from the epoch to 1. Jan of a year.
+// @param       u16 year		2000 .. 2135
+// @return      u16				Day count
+// *************************************************************************************************
+u16 calendar_year_days(u16 year)
+{
+	u16 years = year - CALENDAR_EPOCH_YEAR;
+	u16 days;
+	
+	// Epoch year is a leap year, so every year after a multiple of 4 adds a leap day
+	days = years * 365 + ((years + 3) >> 2);
+	if (year > 2100) days--;
+	
+	return (days);
+}
+
+
+// *************************************************************************************************
+// @fn          calendar_days
+// @brief       Days from the epoch to a date.
+// @param       u16 year		2000 .. 2135
+//				u8 month		1 .. 12
+//				u8 day			1 .. 31
+// @return      u16				Day count (0 = 1. Jan 2000)
+// *************************************************************************************************
+u16 calendar_days(u16 year, u8 month, u8 day)
+{
+	u16 days = calendar_year_days(year) + calendar_month_offset[month-1] + day - 1;
+	
+	if ((month > 2) && calendar_is_leap(year)) days++;
+	
+	return (days);
+}
+
+
+// *************************************************************************************************
+// @fn          calendar_seconds
+// @brief       Seconds from the epoch to a date and time.
+// @param       u16 year		2000 .. 2135
+//				u8 month		1 .. 12
+//				u8 day			1 .. 31
+//				u8 hour			0 .. 23
+//				u8 minute		0 .. 59
+//				u8 second		0 .. 59
+// @return      u32				Seconds since 1. Jan 2000 00:00:00
+// *************************************************************************************************
+u32 calendar_seconds(u16 year, u8 month, u8 day, u8 hour, u8 minute, u8 second)
+{
+	return (calendar_days(year, month, day) * CALENDAR_DAY 
+			+ (u32)(hour * 60u + minute) * 60u + second);
+}
+
+
+// *************************************************************************************************
+// @fn          calendar_split
+// @brief       Convert seconds since the epoch to date and time.
+// @param       u32 seconds				Seconds since 1. Jan 2000 00:00:00
+//				struct calendar * cal	Date and time
+// @return      none
+// *************************************************************************************************
+void calendar_split(u32 seconds, struct calendar * cal)
+{
+	u16 days = seconds / CALENDAR_DAY;
+	u32 time = seconds - days * CALENDAR_DAY;
+	u16 rest;
+	u16 year_days;
+	u8 month;
+	u8 leap;
+	
+	// Time of day
+	cal->hour   = time / 3600u;
+	rest        = time - cal->hour * 3600u;
+	cal->minute = rest / 60u;
+	cal->second = rest - cal->minute * 60u;
+	
+	// Estimate year from average year length, correct by one year at most (leap year rule of 2100)
+	cal->year = CALENDAR_EPOCH_YEAR + (u16)(((u32)days * 4u) / 1461u);
+	year_days = calendar_year_days(cal->year);
+	if (year_days > days) 
+	{
+		cal->year--;
+		year_days = calendar_year_days(cal->year);
+	}
+	else if (calendar_year_days(cal->year + 1) <= days)
+	{
+		cal->year++;
+		year_days = calendar_year_days(cal->year);
+	}
+	days -= year_days;
+	
+	// Find month in table, skip leap day after February
+	leap = calendar_is_leap(cal->year);
+	for (month = 12; month > 1; month--)
+	{
+		if (days >= calendar_month_offset[month-1] + ((month > 2) ? leap : 0)) break;
+	}
+	if (month > 2) days -= leap;
+	cal->month = month;
+	cal->day   = days - calendar_month_offset[month-1] + 1;
+}
+
+
+// *************************************************************************************************
+// @fn          calendar_weekday
+// @brief       Day of week of a day count.
+// @param       u16 days		Days since the epoch
+// @return      u8				Day of week, 0 = sunday .. 6 = saturday
+// *************************************************************************************************
+u8 calendar_weekday(u16 days)
+{
+	return ((days + CALENDAR_EPOCH_WEEKDAY) % 7);
+}
+
+
+// *************************************************************************************************
+// @fn          calendar_now
+// @brief       Current date and time as seconds since the epoch. Cheap timestamp for logged data.
+// @param       none
+// @return      u32				Seconds since 1. Jan 2000 00:00:00
+// *************************************************************************************************
+u32 calendar_now(void)
+{
+	return (calendar_seconds(sDate.year, sDate.month, sDate.day, sTime.hour, sTime.minute, sTime.second));
+}
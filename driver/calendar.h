@@ -0,0 +1,91 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Calendar arithmetic. Converts between broken-down date and time and seconds since the calendar
+// epoch (1. Jan 2000 00:00:00). Valid for the years 2000 .. 2135, the range of RTC_A and u32.
+// *************************************************************************************************
+
+#ifndef CALENDAR_H_
+#define CALENDAR_H_
+
+
+// *************************************************************************************************
+// Include section
+
+
+// *************************************************************************************************
+// Defines section
+
+// First year of calendar epoch (1. Jan, a saturday)
+#define CALENDAR_EPOCH_YEAR					(2000u)
+#define CALENDAR_EPOCH_WEEKDAY				(6u)
+#define CALENDAR_LAST_YEAR					(2135u)
+
+#define CALENDAR_DAY						(86400ul)
+
+// Day of week as returned by calendar_weekday()
+#define CALENDAR_SUNDAY						(0u)
+#define CALENDAR_SATURDAY					(6u)
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Broken-down date and time
+struct calendar
+{
+	u16		year;
+	u8		month;			// 1 .. 12
+	u8		day;			// 1 .. 31
+	u8		hour;
+	u8		minute;
+	u8		second;
+};
+
+
+// *************************************************************************************************
+// Prototypes section
+extern u8 calendar_month_days(u16 year, u8 month);
+extern u16 calendar_days(u16 year, u8 month, u8 day);
+extern u32 calendar_seconds(u16 year, u8 month, u8 day, u8 hour, u8 minute, u8 second);
+extern void calendar_split(u32 seconds, struct calendar * cal);
+extern u8 calendar_weekday(u16 days);
+extern u32 calendar_now(void);
+
+
+// *************************************************************************************************
+// Extern section
+
+
+#endif /*CALENDAR_H_*/
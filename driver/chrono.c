@@ -0,0 +1,431 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Timer engine shared by stopwatch, eggtimer and strength timer. Each instance counts up from its
+// start time stamp; count-down timers subtract the counted time from their duration. TA0CCR2 is
+// programmed for the nearest expiry of all running instances and a Timer0_A4 software timer 
+// refreshes the display of a visible instance.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+#ifdef FEATURE_CHRONO
+
+// driver
+#include "chrono.h"
+#include "timer.h"
+#include "event.h"
+#include "display.h"
+
+
+// *************************************************************************************************
+// Prototypes section
+void chrono_start(u8 id, u32 ticks);
+void chrono_stop(u8 id, u32 ticks);
+void chrono_reset(u8 id);
+void chrono_rewind(u8 id, u32 ticks);
+u32 chrono_elapsed(u8 id);
+u32 chrono_elapsed_at(u8 id, u32 ticks);
+void chrono_set_function(u8 id, u32 due, u32 period, void (*fptr)(void));
+void chrono_expire(void);
+void chrono_program(void);
+void chrono_digits(u32 ticks, u8 * time);
+u16 chrono_digit_delay(u32 ticks, u8 rate, u8 down);
+void chrono_refresh(u16 (*delay)(void));
+void chrono_stop_refresh(void);
+void chrono_refresh_tick(void);
+
+
+// *************************************************************************************************
+// Defines section
+
+
+// *************************************************************************************************
+// Global Variable section
+struct chrono sChrono[CHRONO_CHANNELS];
+
+// Ticks to next digit change of the visible timer
+u16 (*fptr_chrono_refresh)(void);
+
+
+// *************************************************************************************************
+// Extern section
+
+
+// *************************************************************************************************
+// @fn          chrono_start
+// @brief       Start or resume counting.
+// @param       u8 id			CHRONO_STOPWATCH .. CHRONO_STRENGTH
+//				u32 ticks		Time stamp of start (Timer0_Ticks)
+// @return      none
+// *************************************************************************************************
+void chrono_start(u8 id, u32 ticks)
+{
+	istate_t int_state;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	if (!sChrono[id].running)
+	{
+		sChrono[id].start   = ticks - sChrono[id].elapsed;
+		sChrono[id].running = 1;
+	}
+	chrono_program();
+	
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_stop
+// @brief       Stop counting. Counted time is kept.
+// @param       u8 id			CHRONO_STOPWATCH .. CHRONO_STRENGTH
+//				u32 ticks		Time stamp of stop (Timer0_Ticks)
+// @return      none
+// *************************************************************************************************
+void chrono_stop(u8 id, u32 ticks)
+{
+	istate_t int_state;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	if (sChrono[id].running)
+	{
+		sChrono[id].elapsed = ticks - sChrono[id].start;
+		sChrono[id].running = 0;
+	}
+	chrono_program();
+	
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_reset
+// @brief       Stop counting, clear counted time and expiry function.
+// @param       u8 id			CHRONO_STOPWATCH .. CHRONO_STRENGTH
+// @return      none
+// *************************************************************************************************
+void chrono_reset(u8 id)
+{
+	istate_t int_state;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	sChrono[id].running  = 0;
+	sChrono[id].elapsed  = 0;
+	sChrono[id].function = 0;
+	chrono_program();
+	
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_rewind
+// @brief       Subtract time from counted time and expiry time, e.g. to start over after the 
+//				largest value that can be displayed. Keeps counting.
+// @param       u8 id			CHRONO_STOPWATCH .. CHRONO_STRENGTH
+//				u32 ticks		Time to subtract (1/32768 sec)
+// @return      none
+// *************************************************************************************************
+void chrono_rewind(u8 id, u32 ticks)
+{
+	istate_t int_state;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	if (sChrono[id].running)	sChrono[id].start   += ticks;
+	else						sChrono[id].elapsed -= ticks;
+	sChrono[id].due -= ticks;
+	chrono_program();
+	
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_elapsed
+// @brief       Counted time. Valid up to 36 hours.
+// @param       u8 id			CHRONO_STOPWATCH .. CHRONO_STRENGTH
+// @return      u32				Counted time in 1/32768 sec
+// *************************************************************************************************
+u32 chrono_elapsed(u8 id)
+{
+	return (chrono_elapsed_at(id, Timer0_Ticks()));
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_elapsed_at
+// @brief       Counted time at a time stamp, e.g. of a button edge.
+// @param       u8 id			CHRONO_STOPWATCH .. CHRONO_STRENGTH
+//				u32 ticks		Time stamp (Timer0_Ticks)
+// @return      u32				Counted time in 1/32768 sec
+// *************************************************************************************************
+u32 chrono_elapsed_at(u8 id, u32 ticks)
+{
+	istate_t int_state;
+	
+	// Start time may be changed by expiry function
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	if (sChrono[id].running)	ticks -= sChrono[id].start;
+	else						ticks  = sChrono[id].elapsed;
+	
+	__set_interrupt_state(int_state);
+	
+	return (ticks);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_set_function
+// @brief       Call a function when counted time reaches a value, e.g. end of a count-down. 
+//				Function is called in ISR context while the instance is running.
+// @param       u8 id			CHRONO_STOPWATCH .. CHRONO_STRENGTH
+//				u32 due			Counted time of first call (1/32768 sec)
+//				u32 period		Counted time between further calls, 0 = call only once
+//				fptr			Function to call, 0 = none
+// @return      none
+// *************************************************************************************************
+void chrono_set_function(u8 id, u32 due, u32 period, void (*fptr)(void))
+{
+	istate_t int_state;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	sChrono[id].due      = due;
+	sChrono[id].period   = period;
+	sChrono[id].function = fptr;
+	chrono_program();
+	
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_program
+// @brief       Load TA0CCR2 with nearest expiry of all running instances. For expiries further 
+//				away than CHRONO_STEP_MAX, TA0CCR2 is off and the seconds deadline slot TICK_CHRONO 
+//				calls this function again when the expiry is within one step. 
+//				Called with IRQs disabled.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void chrono_program(void)
+{
+	u32 now, left, far = 0;
+	u16 next = 0;
+	u16 value;
+	u8 i;
+	
+	now   = Timer0_Ticks();
+	value = TA0R;
+	
+	for (i=0; i<CHRONO_CHANNELS; i++)
+	{
+		if (!sChrono[i].running || (sChrono[i].function == 0)) continue;
+		
+		left = sChrono[i].due - (now - sChrono[i].start);
+		if ((s32)left <= 0)						left = 1;
+		if (left > CHRONO_STEP_MAX)
+		{
+			if ((far == 0) || (left < far))		far = left;
+			continue;
+		}
+		if ((next == 0) || ((u16)left < next))	next = (u16)left;
+	}
+	
+	if (next == 0)
+	{
+		// No running instance with expiry function within one step
+		TA0CCTL2 &= ~CCIE;
+		
+		// Slot is due when less than two seconds are left (>= 1 sec from now)
+		if (far != 0)	Timer0_A0_Schedule(TICK_CHRONO, (far - TIMER0_A0_LATE) / CHRONO_SECOND);
+		else			Timer0_A0_Cancel(TICK_CHRONO);
+		return;
+	}
+	Timer0_A0_Cancel(TICK_CHRONO);
+	
+	TA0CCR2 = value + next;
+	TA0CCTL2 &= ~CCIFG;
+	
+	// Expiry already passed while CCR was loaded - request IRQ now
+	if ((u16)(TA0R - value) >= next) TA0CCTL2 |= CCIFG;
+	
+	TA0CCTL2 |= CCIE;
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_expire
+// @brief       Called by TA0CCR2 IRQ. Calls functions of expired instances and loads TA0CCR2 
+//				with next expiry.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void chrono_expire(void)
+{
+	void (*fptr)(void);
+	u32 now;
+	u8 i;
+	
+	now = Timer0_Ticks();
+	
+	for (i=0; i<CHRONO_CHANNELS; i++)
+	{
+		if (!sChrono[i].running || (sChrono[i].function == 0)) continue;
+		if ((s32)(sChrono[i].due - (now - sChrono[i].start)) > 0) continue;
+		
+		fptr = sChrono[i].function;
+		if (sChrono[i].period != 0)
+		{
+			// Count next period from this expiry to avoid drift
+			sChrono[i].due += sChrono[i].period;
+		}
+		else
+		{
+			sChrono[i].function = 0;
+		}
+		fptr();
+	}
+	
+	chrono_program();
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_digits
+// @brief       Convert timer value to ASCII digits HHMMSShh.
+// @param       u32 ticks		Timer value in 1/32768 sec (< 100 hours)
+//				u8 * time		8 ASCII digits
+// @return      none
+// *************************************************************************************************
+void chrono_digits(u32 ticks, u8 * time)
+{
+	u32 seconds = ticks >> 15;
+	u8 hundredths = ((ticks & 0x7FFF) * 100) >> 15;
+	u8 hours = seconds / 3600;
+	u16 rest = seconds - hours * 3600u;
+	u8 minutes = rest / 60;
+	
+	rest -= minutes * 60;
+	
+	time[0] = '0' + hours / 10;
+	time[1] = '0' + hours % 10;
+	time[2] = '0' + minutes / 10;
+	time[3] = '0' + minutes % 10;
+	time[4] = '0' + rest / 10;
+	time[5] = '0' + rest % 10;
+	time[6] = '0' + hundredths / 10;
+	time[7] = '0' + hundredths % 10;
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_digit_delay
+// @brief       Time from a timer value to the change of its last visible digit.
+// @param       u32 ticks		Timer value in 1/32768 sec
+//				u8 rate			CHRONO_10HZ (1/10 sec digit) or CHRONO_1HZ (second digit)
+//				u8 down			1 = timer counts down
+// @return      u16				Ticks to digit change (1 .. 32768)
+// *************************************************************************************************
+u16 chrono_digit_delay(u32 ticks, u8 rate, u8 down)
+{
+	u16 frac = (u16)ticks & 0x7FFF;
+	u8 digit = ((u32)frac * rate) >> 15;
+	
+	// Digit n is shown from ceil(n * 32768 / rate) on
+	if (down)	return (frac + 1 - (((u32)digit << 15) + rate - 1) / rate);
+	else		return ((((u32)digit + 1) << 15) + rate - 1) / rate - frac;
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_refresh
+// @brief       Refresh display of a visible timer at its digit changes. Called by the idle loop, so 
+//				the refresh stops as soon as the idle loop calls chrono_stop_refresh().
+// @param       u16 (*delay)(void)	Returns ticks to next digit change of the visible timer
+// @return      none
+// *************************************************************************************************
+void chrono_refresh(u16 (*delay)(void))
+{
+	// Keep running refresh of the same timer, restart it when another timer becomes visible
+	if (Timer0_A4_Is_Active(TIMER0_A4_CHRONO) && (fptr_chrono_refresh == delay)) return;
+	
+	fptr_chrono_refresh = delay;
+	Timer0_A4_Start(TIMER0_A4_CHRONO, delay(), 0, chrono_refresh_tick);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_stop_refresh
+// @brief       Stop display refresh when no running timer is visible.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void chrono_stop_refresh(void)
+{
+	Timer0_A4_Stop(TIMER0_A4_CHRONO);
+}
+
+
+// *************************************************************************************************
+// @fn          chrono_refresh_tick
+// @brief       Called by Timer0_A4 to redraw the visible timer. The one-shot is rearmed from the 
+//				current timer value, so the refresh cannot drift away from the digit changes.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void chrono_refresh_tick(void)
+{
+	event_push_level(EVENT_STOPWATCH);
+	
+	Timer0_A4_Start(TIMER0_A4_CHRONO, fptr_chrono_refresh(), 0, chrono_refresh_tick);
+}
+
+#endif /* FEATURE_CHRONO */
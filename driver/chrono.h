@@ -0,0 +1,106 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Timer engine for count-up and count-down timers (stopwatch, eggtimer, strength timer). Time is
+// measured with monotonic time stamps, so counting needs no interrupts. TA0CCR2 is only used to
+// call the expiry functions of the running timers.
+// *************************************************************************************************
+
+#ifndef CHRONO_H_
+#define CHRONO_H_
+
+
+// *************************************************************************************************
+// Include section
+
+
+// *************************************************************************************************
+// Defines section
+
+// Timer instances
+#define CHRONO_STOPWATCH					(0u)
+#define CHRONO_EGGTIMER						(1u)
+#define CHRONO_STRENGTH						(2u)
+#define CHRONO_CHANNELS						(3u)
+
+// Ticks per second of timer values
+#define CHRONO_SECOND						(32768ul)
+
+// Longest step of TA0CCR2 - later expiries wait for deadline slot TICK_CHRONO of Timer0_A0
+#define CHRONO_STEP_MAX						(0xFFFFu)
+
+// Digit changes per second of views that show 1/100 sec or seconds
+#define CHRONO_10HZ							(10u)
+#define CHRONO_1HZ							(1u)
+
+
+// *************************************************************************************************
+// Global Variable section
+struct chrono
+{
+	// Time stamp of start (Timer0_Ticks) minus time counted before, valid while running
+	u32		start;
+	// Time counted while stopped (1/32768 sec)
+	u32		elapsed;
+	// Counted time when function is called, reload period (0 = one-shot)
+	u32		due;
+	u32		period;
+	void	(*function)(void);
+	u8		running;
+};
+extern struct chrono sChrono[CHRONO_CHANNELS];
+
+
+// *************************************************************************************************
+// Prototypes section
+extern void chrono_start(u8 id, u32 ticks);
+extern void chrono_stop(u8 id, u32 ticks);
+extern void chrono_reset(u8 id);
+extern void chrono_rewind(u8 id, u32 ticks);
+extern u32 chrono_elapsed(u8 id);
+extern u32 chrono_elapsed_at(u8 id, u32 ticks);
+extern void chrono_set_function(u8 id, u32 due, u32 period, void (*fptr)(void));
+extern void chrono_expire(void);
+extern void chrono_program(void);
+extern void chrono_digits(u32 ticks, u8 * time);
+extern u16 chrono_digit_delay(u32 ticks, u8 rate, u8 down);
+extern void chrono_refresh(u16 (*delay)(void));
+extern void chrono_stop_refresh(void);
+
+
+// *************************************************************************************************
+// Extern section
+
+
+#endif /*CHRONO_H_*/
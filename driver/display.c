@@ -45,6 +45,7 @@
 
 // driver
 #include "display.h"
+#include "event.h"
 
 // logic
 #include "clock.h"
@@ -57,15 +58,38 @@
 // *************************************************************************************************
 // Prototypes section
 void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state);
+void write_lcd_shadow(u8 index, u8 bits, u8 bitmask, u8 state);
+void write_shadow(u8 index, u8 * shadow, u16 * dirty, u8 bits, u8 bitmask);
+void display_commit(void);
+#ifdef USE_LCD_DOUBLE_BUFFER
+void display_blink_tick(void);
+u8 is_display_blinking(void);
+#endif
 void clear_line(u8 line);
 void display_symbol(u8 symbol, u8 mode);
 void display_char(u8 segment, u8 chr, u8 mode);
 void display_chars(u8 segments, u8 * str, u8 mode);
+u8 lcd_glyph(const u8 * font, u8 chr);
+void display_defer_push(s_display_job * job);
+void display_defer_symbol(u8 symbol, u8 mode);
+void display_defer_chars(u8 segments, u8 * str, u8 mode);
+void display_defer_line(void (*fptr)(u8 line, u8 update), u8 line, u8 update);
+void display_deferred(void);
+u8 is_display_deferred(void);
+#ifdef DEBUG
+void display_benchmark(void);
+u16 display_bench_cycles(u16 stamp);
+#endif
 
 
 // *************************************************************************************************
 // Defines section
 
+#ifdef DEBUG
+// Calls per measurement and MCLK cycles per ACLK tick (FLL multiplier set in init_application)
+#define DISPLAY_BENCH_RUNS				(256u)
+#define DISPLAY_BENCH_MCLK_PER_ACLK		(367u)
+#endif
 
 
 // *************************************************************************************************
@@ -74,9 +98,38 @@ void display_chars(u8 segments, u8 * str, u8 mode);
 // Display flags
 volatile s_display_flags display;
 
+// RAM shadow of LCD and blinking memory - drawing goes here, display_commit() copies changed bytes
+struct lcd_shadow
+{
+	u8		mem[LCD_MEM_SIZE];
+	u8		blink[LCD_MEM_SIZE];
+	u16		dirty;					// Bit n = mem[n] differs from LCD memory
+	u16		dirty_blink;			// Bit n = blink[n] differs from LCD blinking memory
+#ifdef USE_LCD_DOUBLE_BUFFER
+	u8		blink_enabled;			// 1 = Software blinking enabled (start_blink)
+	volatile u8	blink_off;			// 1 = Blinking segments are currently dark (toggled in ISR)
+	u8		blink_drawn;			// Value of blink_off in last flipped frame
+#endif
+};
+struct lcd_shadow sLcd;
+
+// Deferred draw queue (written by ISRs and main with interrupts disabled, drawn by main)
+struct display_defer
+{
+	s_display_job	job[DISPLAY_DEFER_SIZE];
+	volatile u8		head;
+	volatile u8		tail;
+};
+struct display_defer sDisplayDefer;
+
 // Global return string for itoa function
 u8 itoa_str[8];
 
+#ifdef DEBUG
+// Cycle counts of display routines
+struct display_bench sDisplayBench;
+#endif
+
 
 // *************************************************************************************************
 // Extern section
@@ -94,6 +147,7 @@ void lcd_init(void)
 {
 	// Clear entire display memory
 	LCDBMEMCTL |= LCDCLRBM + LCDCLRM;
+	memset(&sLcd, 0, sizeof(sLcd));
 
 	// LCD_FREQ = ACLK/12/8 = 341.3Hz flickers in the sun
 	// LCD_FREQ = ACLK/10/8 = 409.6Hz still flickers in the sun when watch is moving (might be negligible)
@@ -102,8 +156,15 @@ void lcd_init(void)
 	// Frame frequency = 512Hz/2/4 = 64Hz, LCD mux 4, LCD on
 	LCDBCTL0 = (LCDDIV0 + LCDDIV1 + LCDDIV2) | (LCDPRE0 + LCDPRE1) | LCD4MUX | LCDON;
 
+#ifdef USE_LCD_DOUBLE_BUFFER
+	// No hardware blinking - blinking memory is the second frame buffer, LCD memory is shown first
+	LCDBBLKCTL = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKDIV1 | LCDBLKDIV2; 
+	LCDBMEMCTL &= ~LCDDISP;
+	sLcd.blink_enabled = 1;
+#else
 	// LCB_BLK_FREQ = ACLK/8/4096 = 1Hz
 	LCDBBLKCTL = LCDBLKPRE0 | LCDBLKPRE1 | LCDBLKDIV0 | LCDBLKDIV1 | LCDBLKDIV2 | LCDBLKMOD0; 
+#endif
 
 	// I/O to COM outputs
 	P5SEL |= (BIT5 | BIT6 | BIT7);
@@ -177,8 +238,31 @@ void clear_line(u8 line)
 
 
 // *************************************************************************************************
-// @fn          write_segment
-// @brief       Write to one or multiple LCD segments
+// @fn          write_shadow
+// @brief       Write segments to one shadow byte and mark it dirty if its content changed.
+// @param       index		Byte index in LCD memory
+//				shadow		Shadow memory (sLcd.mem or sLcd.blink)
+//				dirty		Dirty mask belonging to shadow memory
+//				bits		Segments to set (only those inside bitmask)
+//				bitmask		Segments to clear before setting bits
+// @return      none
+// *************************************************************************************************
+void write_shadow(u8 index, u8 * shadow, u16 * dirty, u8 bits, u8 bitmask)
+{
+	u8 value = (u8)((shadow[index] & ~bitmask) | (bits & bitmask));
+	
+	if (value != shadow[index])
+	{
+		shadow[index] = value;
+		*dirty |= (u16)1 << index;
+	}
+}
+
+
+// *************************************************************************************************
+// @fn          write_lcd_mem
+// @brief       Write to one or multiple LCD segments. Writes go to the RAM shadow only, 
+//				display_commit() transfers changed bytes to the LCD controller.
 // @param       lcdmem		Pointer to LCD byte memory
 //				bits		Segments to address
 //				bitmask		Bitmask for particular display item
@@ -187,49 +271,142 @@ void clear_line(u8 line)
 // *************************************************************************************************
 void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state)
 {
+	u8 index = LCD_MEM_INDEX(lcdmem);
+	
+	if (index < LCD_MEM_SIZE) write_lcd_shadow(index, bits, bitmask, state);
+}
+
+
+// *************************************************************************************************
+// @fn          write_lcd_shadow
+// @brief       Write to LCD segments of one shadow byte.
+// @param       index		LCD memory byte index (0 = LCD_MEM_1)
+//				bits		Segments to address
+//				bitmask		Bitmask for particular display item
+//				mode		On, off or blink segments
+// @return      none
+// *************************************************************************************************
+void write_lcd_shadow(u8 index, u8 bits, u8 bitmask, u8 state)
+{
+	// Common case: plain write of visible segments
 	if (state == SEG_ON)
 	{
-		// Clear segments before writing
-		*lcdmem = (u8)(*lcdmem & ~bitmask);
+		write_shadow(index, sLcd.mem, &sLcd.dirty, bits, bitmask);
+		return;
+	}
 	
+	if ((state == SEG_ON_BLINK_OFF) || (state == SEG_ON_BLINK_ON))
+	{
 		// Set visible segments
-		*lcdmem = (u8)(*lcdmem | bits);
+		write_shadow(index, sLcd.mem, &sLcd.dirty, bits, bitmask);
 	}
-	else if (state == SEG_OFF)
+	else if ((state == SEG_OFF) || (state == SEG_OFF_BLINK_OFF))
 	{
-		// Clear segments
-		*lcdmem = (u8)(*lcdmem & ~bitmask);
+		// Clear visible segments
+		write_shadow(index, sLcd.mem, &sLcd.dirty, 0, bitmask);
 	}
-	else if (state == SEG_ON_BLINK_ON)
+
+	if (state == SEG_ON_BLINK_ON)
 	{
-		// Clear visible / blink segments before writing
-		*lcdmem 		= (u8)(*lcdmem & ~bitmask);
-		*(lcdmem+0x20) 	= (u8)(*(lcdmem+0x20) & ~bitmask);
-	
-		// Set visible / blink segments
-		*lcdmem 		= (u8)(*lcdmem | bits);
-		*(lcdmem+0x20) 	= (u8)(*(lcdmem+0x20) | bits);
+		// Set blink segments
+		write_shadow(index, sLcd.blink, &sLcd.dirty_blink, bits, bitmask);
 	}
-	else if (state == SEG_ON_BLINK_OFF)
+	else if ((state == SEG_ON_BLINK_OFF) || (state == SEG_OFF_BLINK_OFF))
 	{
-		// Clear visible segments before writing
-		*lcdmem = (u8)(*lcdmem & ~bitmask);
-	
-		// Set visible segments
-		*lcdmem = (u8)(*lcdmem | bits);
-
 		// Clear blink segments
-		*(lcdmem+0x20) 	= (u8)(*(lcdmem+0x20) & ~bitmask);
+		write_shadow(index, sLcd.blink, &sLcd.dirty_blink, 0, bitmask);
 	}
-	else if (state == SEG_OFF_BLINK_OFF)
+}
+
+
+// *************************************************************************************************
+// @fn          display_commit
+// @brief       Copy changed shadow bytes to LCD and blinking memory. Called before LPM entry.
+//				An unchanged screen costs no LCD register access at all.
+//				With USE_LCD_DOUBLE_BUFFER, the whole frame is written to the hidden memory page 
+//				(LCD or blinking memory) and made visible at once by toggling LCDDISP.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void display_commit(void)
+{
+	u8 i;
+#ifdef USE_LCD_DOUBLE_BUFFER
+	u8 * back;
+	u8 frame;
+	u8 blink_off = sLcd.blink_off & sLcd.blink_enabled;
+	
+	// Nothing changed since last flip?
+	if (!sLcd.dirty && !sLcd.dirty_blink && (blink_off == sLcd.blink_drawn)) return;
+	
+	sLcd.dirty 		 = 0;
+	sLcd.dirty_blink = 0;
+	sLcd.blink_drawn = blink_off;
+	
+	// Render frame into hidden page - it still holds the frame before the visible one
+	if (LCDBMEMCTL & LCDDISP) 	back = LCD_MEM_1;
+	else						back = LCD_MEM_1 + LCD_BLINK_MEM_OFFSET;
+	
+	for (i=0; i<LCD_MEM_SIZE; i++)
 	{
-		// Clear segments
-		*lcdmem = (u8)(*lcdmem & ~bitmask);
+		frame = sLcd.mem[i];
+		if (blink_off) frame &= ~sLcd.blink[i];
+		if (back[i] != frame) back[i] = frame;
+	}
+	
+	// Show new frame
+	LCDBMEMCTL ^= LCDDISP;
+#else
+	u16 dirty 		= sLcd.dirty;
+	u16 dirty_blink = sLcd.dirty_blink;
+	
+	sLcd.dirty 		 = 0;
+	sLcd.dirty_blink = 0;
+	
+	for (i=0; dirty | dirty_blink; i++)
+	{
+		if (dirty & BIT0) 		*(LCD_MEM_1 + i) = sLcd.mem[i];
+		if (dirty_blink & BIT0)	*(LCD_MEM_1 + LCD_BLINK_MEM_OFFSET + i) = sLcd.blink[i];
+		dirty 		>>= 1;
+		dirty_blink >>= 1;
+	}
+#endif
+}
 
-		// Clear blink segments
-		*(lcdmem+0x20) 	= (u8)(*(lcdmem+0x20) & ~bitmask);
+
+#ifdef USE_LCD_DOUBLE_BUFFER
+// *************************************************************************************************
+// @fn          display_blink_tick
+// @brief       Toggle blinking segments. Called by 1Hz clock tick.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void display_blink_tick(void)
+{
+	sLcd.blink_off ^= 1;
+}
+
+
+// *************************************************************************************************
+// @fn          is_display_blinking
+// @brief       Check if software blinking needs the clock tick.
+// @param       none
+// @return      u8		1 = blinking enabled and some segments blink (or are still dark)
+// *************************************************************************************************
+u8 is_display_blinking(void)
+{
+	u8 i;
+	
+	if (sLcd.blink_off) return (1);
+	if (!sLcd.blink_enabled) return (0);
+	
+	for (i=0; i<LCD_MEM_SIZE; i++)
+	{
+		if (sLcd.blink[i]) return (1);
 	}
+	return (0);
 }
+#endif
 
 
 // *************************************************************************************************
@@ -245,7 +422,7 @@ void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state)
 u8 * itoa(u32 n, u8 digits, u8 blanks)
 {
 	u8 i;
-	u8 digits1 = digits;
+	u32 bcd;
 	
 	// Preset result string
 	memcpy(itoa_str, "0000000", 7);
@@ -253,31 +430,32 @@ u8 * itoa(u32 n, u8 digits, u8 blanks)
 	// Return empty string if number of digits is invalid (valid range for digits: 1-7)
 	if ((digits == 0) || (digits > 7)) return (itoa_str);
 	
-	// Numbers 0 .. 180 can be copied from itoa_conversion_table without conversion
-	if (n <= 180)
+	// Convert to packed BCD (double dabble): shift in n from MSB, doubling the BCD accumulator
+	// with DADD each step. Result is n modulo 10^8, no software division needed.
+	bcd = 0;
+	i = 32;
+	while ((i > 0) && !(n & 0x80000000)) 
 	{
-		if (digits >= 3)
-		{
-			memcpy(itoa_str+(digits-3), itoa_conversion_table[n], 3);
-		}
-		else // digits == 1 || 2  
-		{
-			memcpy(itoa_str, itoa_conversion_table[n]+(3-digits), digits);
-		}
+		n <<= 1;
+		i--;
 	}
-	else // For n > 180 need to calculate string content
+	for (; i > 0; i--)
 	{
-		// Calculate digits from least to most significant number
-		do 								
-		{     
-			itoa_str[digits-1] = n % 10 + '0';   	
-			n /= 10;
-		} while (--digits > 0);  		
+		bcd = __bcd_add_long(bcd, bcd);
+		if (n & 0x80000000) bcd = __bcd_add_long(bcd, 1);
+		n <<= 1;
+	}
+
+	// Unpack lowest digits from least to most significant nibble
+	for (i = digits; i > 0; i--)
+	{
+		itoa_str[i-1] = (bcd & 0x0F) + '0';
+		bcd >>= 4;
 	}
 
 	// Remove specified number of leading '0', always keep last one
 	i = 0;	
-	while ((itoa_str[i] == '0') && (i < digits1-1))	
+	while ((itoa_str[i] == '0') && (i < digits-1))	
 	{
 		if (blanks > 0)
 		{
@@ -292,6 +470,55 @@ u8 * itoa(u32 n, u8 digits, u8 blanks)
 } 
 
 
+#ifdef DEBUG
+// *************************************************************************************************
+// @fn          display_benchmark
+// @brief       Measure display routines with Timer0_A5 (ACLK). Every routine is called 
+//				DISPLAY_BENCH_RUNS times with IRQs off, so one ACLK tick resolves 1.4 MCLK cycles 
+//				per call. Loop overhead is included. Read sDisplayBench with the debugger.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void display_benchmark(void)
+{
+	istate_t int_state;
+	u16 i, stamp;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	stamp = TA0R;
+	for (i=0; i<DISPLAY_BENCH_RUNS; i++) itoa(42, 3, 0);
+	sDisplayBench.itoa_small = display_bench_cycles(stamp);
+	
+	stamp = TA0R;
+	for (i=0; i<DISPLAY_BENCH_RUNS; i++) itoa(1234567, 7, 0);
+	sDisplayBench.itoa_large = display_bench_cycles(stamp);
+	
+	// All segments of LINE2, including the single segment of LCD_SEG_L2_5
+	stamp = TA0R;
+	for (i=0; i<DISPLAY_BENCH_RUNS; i++) display_chars(LCD_SEG_L2_5_0, (u8 *)"188888", SEG_ON);
+	sDisplayBench.chars_l2 = display_bench_cycles(stamp);
+	
+	__set_interrupt_state(int_state);
+	
+	clear_line(LINE2);
+}
+
+
+// *************************************************************************************************
+// @fn          display_bench_cycles
+// @brief       Convert ACLK ticks since stamp into MCLK cycles per call.
+// @param       u16 stamp		TA0R at start of measurement
+// @return      u16				MCLK cycles per call
+// *************************************************************************************************
+u16 display_bench_cycles(u16 stamp)
+{
+	return (((u32)(u16)(TA0R - stamp) * DISPLAY_BENCH_MCLK_PER_ACLK) / DISPLAY_BENCH_RUNS);
+}
+#endif
+
+
 // *************************************************************************************************
 // @fn          display_value1
 // @brief       Generic decimal display routine. Used exclusively by set_value function.
@@ -388,27 +615,174 @@ void display_am_pm_symbol(u8 hour)
 // *************************************************************************************************
 void display_symbol(u8 symbol, u8 mode)
 {
-	u8 * lcdmem;
-	u8 bits;
-	u8 bitmask;
+	const s_lcd_segment * seg;
 	
 	if (symbol <= LCD_SEG_L2_DP) 
 	{
-		// Get LCD memory address for symbol from table
-		lcdmem 	= (u8 *)segments_lcdmem[symbol];
-	
-		// Get bits for symbol from table
-		bits 	= segments_bitmask[symbol];
-		
-		// Bitmask for symbols equals bits
-		bitmask = bits;
+		// Get LCD memory byte and bits for symbol from table - bitmask for symbols equals bits
+		seg = &lcd_segments[symbol];
 	
 		// Write LCD memory 	
-		write_lcd_mem(lcdmem, bits, bitmask, mode);
+		write_lcd_shadow(seg->mem, seg->mask, seg->mask, mode);
+	}
+}
+
+
+// *************************************************************************************************
+// @fn          display_defer_push
+// @brief       Queue a draw job for display_update(). If the queue is full, the whole display is 
+//				redrawn instead, which also covers the dropped job.
+// @param       s_display_job * job		Job to copy into queue
+// @return      none
+// *************************************************************************************************
+void display_defer_push(s_display_job * job)
+{
+	istate_t int_state;
+	u8 head;
+
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+
+	head = sDisplayDefer.head;
+	if (((head + 1) & DISPLAY_DEFER_MASK) != sDisplayDefer.tail)
+	{
+		sDisplayDefer.job[head] = *job;
+		sDisplayDefer.head = (head + 1) & DISPLAY_DEFER_MASK;
+	}
+	else
+	{
+		// Queue full - redraw everything instead (IRQs are off, so this push cannot interleave 
+		// with an ISR push)
+		event_push_level(EVENT_REDRAW);
+	}
+
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          display_defer_symbol
+// @brief       Switch symbol on or off on LCD when main loop updates the display.
+// @param       u8 symbol		A valid LCD symbol (index 0..42)
+//				u8 mode			SEG_ON, SEG_OFF, SEG_BLINK
+// @return      none
+// *************************************************************************************************
+void display_defer_symbol(u8 symbol, u8 mode)
+{
+	s_display_job job;
+	
+	job.job   = DISPLAY_DEFER_SYMBOL;
+	job.index = symbol;
+	job.mode  = mode;
+	display_defer_push(&job);
+}
+
+
+// *************************************************************************************************
+// @fn          display_defer_chars
+// @brief       Write to consecutive 7-segment characters when main loop updates the display.
+// @param       u8 segments		LCD segment array
+//				u8 * str		Pointer to a string - must stay valid until drawn
+//				u8 mode			SEG_ON, SEG_OFF, SEG_BLINK
+// @return      none
+// *************************************************************************************************
+void display_defer_chars(u8 segments, u8 * str, u8 mode)
+{
+	s_display_job job;
+	
+	job.job     = DISPLAY_DEFER_CHARS;
+	job.index   = segments;
+	job.mode    = mode;
+	job.ptr.str = str;
+	display_defer_push(&job);
+}
+
+
+// *************************************************************************************************
+// @fn          display_defer_line
+// @brief       Call a line display function when main loop updates the display.
+// @param       void (*fptr)(u8 line, u8 update)	Line display function
+//				u8 line								LINE1, LINE2
+//				u8 update							DISPLAY_LINE_UPDATE_FULL, DISPLAY_LINE_UPDATE_PARTIAL
+// @return      none
+// *************************************************************************************************
+void display_defer_line(void (*fptr)(u8 line, u8 update), u8 line, u8 update)
+{
+	s_display_job job;
+	
+	job.job      = DISPLAY_DEFER_LINE;
+	job.index    = line;
+	job.mode     = update;
+	job.ptr.fptr = fptr;
+	display_defer_push(&job);
+}
+
+
+// *************************************************************************************************
+// @fn          display_deferred
+// @brief       Draw all queued jobs. Called by display_update() in main context.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void display_deferred(void)
+{
+	s_display_job * ptr;
+	u8 tail = sDisplayDefer.tail;
+	
+	while (tail != sDisplayDefer.head)
+	{
+		ptr = &sDisplayDefer.job[tail];
+		
+		switch (ptr->job)
+		{
+			case DISPLAY_DEFER_SYMBOL:	display_symbol(ptr->index, ptr->mode);
+										break;
+			case DISPLAY_DEFER_CHARS:	display_chars(ptr->index, ptr->ptr.str, ptr->mode);
+										break;
+			// Redraw line only if it still shows the module that queued the job
+			case DISPLAY_DEFER_LINE:	if ((ptr->index == LINE1 && ptr->ptr.fptr == fptr_lcd_function_line1) ||
+										    (ptr->index == LINE2 && ptr->ptr.fptr == fptr_lcd_function_line2))
+										{
+											ptr->ptr.fptr(ptr->index, ptr->mode);
+										}
+										break;
+		}
+		
+		// Release job
+		tail = (tail + 1) & DISPLAY_DEFER_MASK;
+		sDisplayDefer.tail = tail;
 	}
 }
 
 
+// *************************************************************************************************
+// @fn          is_display_deferred
+// @brief       Check if draw jobs are queued.
+// @param       none
+// @return      u8		1 = draw jobs queued
+// *************************************************************************************************
+u8 is_display_deferred(void)
+{
+	return (sDisplayDefer.head != sDisplayDefer.tail);
+}
+
+
+// *************************************************************************************************
+// @fn          lcd_glyph
+// @brief       Get segment bits for a character.
+// @param       const u8 * font		lcd_font (LINE1) or lcd_font_l2 (LINE2)
+//				u8 chr				Character to display
+// @return      u8					Segment bits, unknown characters map to ' ' (blank)
+// *************************************************************************************************
+u8 lcd_glyph(const u8 * font, u8 chr)
+{
+	chr -= LCD_FONT_FIRST;
+	
+	if (chr <= (LCD_FONT_LAST - LCD_FONT_FIRST)) return (font[chr]);
+	return (0);
+}
+
+
 // *************************************************************************************************
 // @fn          display_char
 // @brief       Write to 7-segment characters.
@@ -419,53 +793,16 @@ void display_symbol(u8 symbol, u8 mode)
 // *************************************************************************************************
 void display_char(u8 segment, u8 chr, u8 mode)
 {
-	u8 * lcdmem;			// Pointer to LCD memory
-	u8 bitmask;			// Bitmask for character
-	u8 bits, bits1;		// Bits to write
+	const s_lcd_segment * seg;
 	
 	// Write to single 7-segment character
 	if ((segment >= LCD_SEG_L1_3) && (segment <= LCD_SEG_L2_DP))
 	{
-		// Get LCD memory address for segment from table
-		lcdmem = (u8 *)segments_lcdmem[segment];
-
-		// Get bitmask for character from table
-		bitmask = segments_bitmask[segment];
+		seg = &lcd_segments[segment];
 		
-		// Get bits from font set
-		if ((chr >= 0x30) && (chr <= 0x5A)) 
-		{
-			// Use font set
-			bits = lcd_font[chr-0x30];
-		}
-		else if (chr == 0x2D)
-		{
-			// '-' not in font set
-			bits = BIT1;
-		}
-		else
-		{
-			// Other characters map to ' ' (blank)
-			bits = 0;
-		}
-
-		// When addressing LINE2 7-segment characters need to swap high- and low-nibble,
-		// because LCD COM/SEG assignment is mirrored against LINE1
-		if (segment >= LCD_SEG_L2_5) 
-		{
-			bits1 = ((bits << 4) & 0xF0) | ((bits >> 4) & 0x0F);
-			bits = bits1;
-
-			// When addressing LCD_SEG_L2_5, need to convert ASCII '1' and 'L' to 1 bit,
-			// because LCD COM/SEG assignment is special for this incomplete character
-			if (segment == LCD_SEG_L2_5) 
-			{
-				if ((chr == '1') || (chr == 'L')) bits = BIT7;
-			}
-		}
-		
-		// Physically write to LCD memory		
-		write_lcd_mem(lcdmem, bits, bitmask, mode);
+		// LINE2 font is nibble-swapped and has the special '1' / 'L' of LCD_SEG_L2_5 built in
+		write_lcd_shadow(seg->mem, lcd_glyph((segment >= LCD_SEG_L2_5) ? lcd_font_l2 : lcd_font, chr), 
+						 seg->mask, mode);
 	}
 }	
 	
@@ -474,50 +811,48 @@ void display_char(u8 segment, u8 chr, u8 mode)
 // @fn          display_chars
 // @brief       Write to consecutive 7-segment characters.
 // @param       u8 segments	LCD segment array 
-//				u8 * str		Pointer to a string
+//				u8 * str		Pointer to a string (NULL = blanks)
 //				u8 mode		SEG_ON, SEG_OFF, SEG_BLINK
 // @return      none
 // *************************************************************************************************
 void display_chars(u8 segments, u8 * str, u8 mode)
 {
-	u8 i;
-	u8 length = 0;			// Write length
-	u8 char_start;			// Starting point for consecutive write
+	const s_lcd_segment * seg;
+	const u8 * font;
+	u8 start;
+	u8 length;
 	
-	//single charakter
+	// Get first character and length of write
 	if ((segments >= LCD_SEG_L1_3) && (segments <= LCD_SEG_L2_DP))
 	{
-		length=1;
-		char_start=segments;
+		// Single character
+		start  = segments;
+		length = 1;
+	}
+	else if ((segments >= LCD_SEG_L1_3_0) && (segments <= LCD_SEG_L1_3_2))
+	{
+		start  = lcd_arrays[segments - LCD_SEG_L1_ARRAYS].start;
+		length = lcd_arrays[segments - LCD_SEG_L1_ARRAYS].length;
+	}
+	else if ((segments >= LCD_SEG_L2_5_0) && (segments <= LCD_SEG_L2_4_3))
+	{
+		start  = lcd_arrays[segments - LCD_SEG_L2_ARRAYS].start;
+		length = lcd_arrays[segments - LCD_SEG_L2_ARRAYS].length;
 	}
-	//multiple charakters
-	switch (segments)
+	else
 	{
-		// LINE1
-		case LCD_SEG_L1_3_0:	length=4; char_start=LCD_SEG_L1_3; break;
-		case LCD_SEG_L1_2_0:	length=3; char_start=LCD_SEG_L1_2; break;
-		case LCD_SEG_L1_1_0: 	length=2; char_start=LCD_SEG_L1_1; break;
-		case LCD_SEG_L1_3_1: 	length=3; char_start=LCD_SEG_L1_3; break;
-		case LCD_SEG_L1_3_2: 	length=2; char_start=LCD_SEG_L1_3; break;
-
-		// LINE2
-		case LCD_SEG_L2_5_0:	length=6; char_start=LCD_SEG_L2_5; break;
-		case LCD_SEG_L2_4_0:	length=5; char_start=LCD_SEG_L2_4; break;
-		case LCD_SEG_L2_3_0:	length=4; char_start=LCD_SEG_L2_3; break;
-		case LCD_SEG_L2_2_0:	length=3; char_start=LCD_SEG_L2_2; break;
-		case LCD_SEG_L2_1_0: 	length=2; char_start=LCD_SEG_L2_1; break;
-		case LCD_SEG_L2_5_4:	length=2; char_start=LCD_SEG_L2_5; break;
-		case LCD_SEG_L2_5_2:	length=4; char_start=LCD_SEG_L2_5; break;
-		case LCD_SEG_L2_3_2:	length=2; char_start=LCD_SEG_L2_3; break;
-		case LCD_SEG_L2_4_2: 	length=3; char_start=LCD_SEG_L2_4; break;
-		case LCD_SEG_L2_4_3: 	length=2; char_start=LCD_SEG_L2_4; break;
+		return;
 	}
 	
+	// Characters of one array are on the same line
+	font = (start >= LCD_SEG_L2_5) ? lcd_font_l2 : lcd_font;
+	seg  = &lcd_segments[start];
+	
 	// Write to consecutive digits
-	for(i=0; i<length; i++)
+	while (length--)
 	{
-		// Use single character routine to write display memory
-		display_char(char_start+i, *(str+i), mode);
+		write_lcd_shadow(seg->mem, (str != NULL) ? lcd_glyph(font, *str++) : 0, seg->mask, mode);
+		seg++;
 	}
 }
 
@@ -552,7 +887,11 @@ u8 switch_seg(u8 line, u8 index1, u8 index2)
 // *************************************************************************************************
 void start_blink(void)
 {
+#ifdef USE_LCD_DOUBLE_BUFFER
+	sLcd.blink_enabled = 1;
+#else
 	LCDBBLKCTL |= LCDBLKMOD0;
+#endif
 }
 
 
@@ -564,7 +903,11 @@ void start_blink(void)
 // *************************************************************************************************
 void stop_blink(void)
 {
+#ifdef USE_LCD_DOUBLE_BUFFER
+	sLcd.blink_enabled = 0;
+#else
 	LCDBBLKCTL &= ~LCDBLKMOD0;
+#endif
 }
 
 
@@ -576,7 +919,17 @@ void stop_blink(void)
 // *************************************************************************************************
 void clear_blink_mem(void)
 {
+#ifdef USE_LCD_DOUBLE_BUFFER
+	// Blinking memory is a frame buffer - only forget which segments blink
+	memset(sLcd.blink, 0, sizeof(sLcd.blink));
+	sLcd.dirty_blink = 1;
+#else
 	LCDBMEMCTL |= LCDCLRBM;	
+	
+	// Blinking memory and its shadow are now in sync
+	memset(sLcd.blink, 0, sizeof(sLcd.blink));
+	sLcd.dirty_blink = 0;
+#endif
 }
 
 
@@ -601,12 +954,10 @@ void set_blink_rate(u8 bits)
 // *************************************************************************************************
 void display_all_off(void)
 {
-	u8 * lcdptr = (u8*)0x0A20;
 	u8 i;
 	
-	for (i=1; i<=12; i++) 
+	for (i=0; i<LCD_MEM_SIZE; i++) 
 	{
-		*lcdptr = 0x00; 
-		lcdptr++;
+		write_lcd_mem(LCD_MEM_1 + i, 0x00, 0xFF, SEG_OFF);
 	}
 }
@@ -65,9 +65,7 @@
 
 // Constants defined in library
 extern const u8 lcd_font[];
-extern const u8 * segments_lcdmem[];
-extern const u8 segments_bitmask[];
-extern const u8 itoa_conversion_table[][3];
+extern const u8 lcd_font_l2[];
 
 
 // *************************************************************************************************
@@ -88,9 +86,6 @@ typedef union
 
 	// Logic module data update flags
     u16 update_time      		: 1;    // 1 = Time was updated 
-#ifdef CONFIG_SIDEREAL
-	u16 update_sidereal_time	: 1;	// 1 = Sidereal Time was updated
-#endif
     u16 update_stopwatch     	: 1;    // 1 = Stopwatch was updated
     u16 update_temperature   	: 1;    // 1 = Temperature was updated
     u16 update_battery_voltage 	: 1;    // 1 = Battery voltage was updated
@@ -103,6 +98,48 @@ typedef union
 
 extern volatile s_display_flags display;
 
+// Display element: LCD memory byte (index from LCD_MEM_1) and bit mask
+typedef struct
+{
+	u8	mem;
+	u8	mask;
+} s_lcd_segment;
+
+extern const s_lcd_segment lcd_segments[];
+
+// 7-segment array: first character and number of characters
+typedef struct
+{
+	u8	start;
+	u8	length;
+} s_lcd_array;
+
+extern const s_lcd_array lcd_arrays[];
+
+// Deferred draw job
+typedef struct
+{
+	u8		job;					// DISPLAY_DEFER_xxx
+	u8		index;					// Symbol, segments or line
+	u8		mode;					// Segment mode or line update mode
+	union
+	{
+		u8 * str;					// DISPLAY_DEFER_CHARS: string, must stay valid until drawn
+		void (*fptr)(u8 line, u8 update);	// DISPLAY_DEFER_LINE: line display function
+	} ptr;
+} s_display_job;
+
+#ifdef DEBUG
+// Cost of number formatting and drawing in MCLK cycles per call, measured by display_benchmark()
+struct display_bench
+{
+	u16		itoa_small;				// itoa(42, 3, 0)
+	u16		itoa_large;				// itoa(1234567, 7, 0)
+	u16		chars_l2;				// display_chars(LCD_SEG_L2_5_0, "188888", SEG_ON)
+};
+extern struct display_bench sDisplayBench;
+#endif
+
 
 // *************************************************************************************************
 // Defines section
@@ -128,6 +165,15 @@ extern volatile s_display_flags display;
 #define SEG_ON_BLINK_OFF		(3u)
 #define SEG_OFF_BLINK_OFF		(4u)
 
+// Deferred draw jobs - queued in ISR context, drawn by display_update() before LPM entry
+#define DISPLAY_DEFER_SYMBOL	(0u)
+#define DISPLAY_DEFER_CHARS		(1u)
+#define DISPLAY_DEFER_LINE		(2u)
+
+// Deferred draw queue size - must be a power of 2
+#define DISPLAY_DEFER_SIZE		(8u)
+#define DISPLAY_DEFER_MASK		(DISPLAY_DEFER_SIZE - 1u)
+
 // 7-segment character bit assignments
 #define SEG_A                	(BIT4)
 #define SEG_B                	(BIT5)
@@ -205,6 +251,7 @@ extern volatile s_display_flags display;
 
 
 // Line1 7-segment arrays
+#define LCD_SEG_L1_ARRAYS			(LCD_SEG_L1_3_0)			// Offset of Line1 arrays in lcd_arrays[]
 #define LCD_SEG_L1_3_0				70
 #define LCD_SEG_L1_2_0				71
 #define LCD_SEG_L1_1_0				72
@@ -212,6 +259,7 @@ extern volatile s_display_flags display;
 #define LCD_SEG_L1_3_2				74
 
 // Line2 7-segment arrays
+#define LCD_SEG_L2_ARRAYS			(LCD_SEG_L2_5_0 - 5)		// Offset of Line2 arrays in lcd_arrays[]
 #define LCD_SEG_L2_5_0				90
 #define LCD_SEG_L2_4_0				91
 #define LCD_SEG_L2_3_0				92
@@ -238,6 +286,17 @@ extern volatile s_display_flags display;
 #define LCD_MEM_11         			((u8*)0x0A2A)
 #define LCD_MEM_12         			((u8*)0x0A2B)
 
+// LCD memory size in bytes and offset of blinking memory
+#define LCD_MEM_SIZE				(12u)
+#define LCD_BLINK_MEM_OFFSET		(0x20)
+
+// Byte index of LCD memory address
+#define LCD_MEM_INDEX(mem)			((u8)((mem) - LCD_MEM_1))
+
+// First and last ASCII character in lcd_font[] and lcd_font_l2[]
+#define LCD_FONT_FIRST				('-')
+#define LCD_FONT_LAST				('Z')
+
 
 // Memory assignment
 #define LCD_SEG_L1_0_MEM			(LCD_MEM_6)
@@ -332,8 +391,13 @@ extern volatile s_display_flags display;
 // *************************************************************************************************
 // API section
 
-// Physical LCD memory write
+// Shadow LCD memory write / commit of changed bytes to physical LCD memory
 extern void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state);
+extern void display_commit(void);
+#ifdef USE_LCD_DOUBLE_BUFFER
+extern void display_blink_tick(void);
+extern u8 is_display_blinking(void);
+#endif
 
 // Display init / clear
 extern void lcd_init(void);
@@ -352,6 +416,13 @@ extern void display_char(u8 segment, u8 chr, u8 mode);
 extern void display_chars(u8 segments, u8 * str, u8 mode);
 extern void display_symbol(u8 symbol, u8 mode);
 
+// Deferred draw functions - use these in ISR context
+extern void display_defer_symbol(u8 symbol, u8 mode);
+extern void display_defer_chars(u8 segments, u8 * str, u8 mode);
+extern void display_defer_line(void (*fptr)(u8 line, u8 update), u8 line, u8 update);
+extern void display_deferred(void);
+extern u8 is_display_deferred(void);
+
 // Time display function
 extern void DisplayTime(u8 updateMode);
 extern void display_am_pm_symbol(u8 timeAM);
@@ -363,6 +434,11 @@ extern void display_hours_12_or_24(u8 segments, u32 value, u8 digits, u8 blanks,
 // Integer to string conversion 
 extern u8 * itoa(u32 n, u8 digits, u8 blanks);
 
+#ifdef DEBUG
+// Cycle measurement of display routines
+extern void display_benchmark(void);
+#endif
+
 // Segment index helper function
 extern u8 switch_seg(u8 line, u8 index1, u8 index2);
 
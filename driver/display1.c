@@ -58,170 +58,150 @@
 // *************************************************************************************************
 // Global Variable section
 
-// Table with memory bit assignment for digits "0" to "9" and characters "A" to "Z"
+// Glyphs for ASCII '-' to 'Z' in LINE1 bit assignment. Second parameter is 1 for characters that 
+// LCD_SEG_L2_5 can show ('1' and 'L'), as this incomplete character has only one segment (BIT7).
 //   A
 // F   B
 //   G
 // E   C
 //   D
+#define LCD_GLYPHS(GLYPH) \
+	GLYPH(                              SEG_G, 0)	/* Displays "-" */ \
+	GLYPH(0                                  , 0)	/* Displays " " (.) */ \
+	GLYPH(0                                  , 0)	/* Displays " " (/) */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+SEG_D+SEG_E+SEG_F, 0)	/* Displays "0" */ \
+	GLYPH(      SEG_B+SEG_C                  , 1)	/* Displays "1" */ \
+	GLYPH(SEG_A+SEG_B+      SEG_D+SEG_E+      SEG_G, 0)	/* Displays "2" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+SEG_D+            SEG_G, 0)	/* Displays "3" */ \
+	GLYPH(      SEG_B+SEG_C+            SEG_F+SEG_G, 0)	/* Displays "4" */ \
+	GLYPH(SEG_A+      SEG_C+SEG_D+      SEG_F+SEG_G, 0)	/* Displays "5" */ \
+	GLYPH(SEG_A+      SEG_C+SEG_D+SEG_E+SEG_F+SEG_G, 0)	/* Displays "6" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C                        , 0)	/* Displays "7" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+SEG_D+SEG_E+SEG_F+SEG_G, 0)	/* Displays "8" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+SEG_D+      SEG_F+SEG_G, 0)	/* Displays "9" */ \
+	GLYPH(0                                        , 0)	/* Displays " " (:) */ \
+	GLYPH(0                                        , 0)	/* Displays " " (;) */ \
+	GLYPH(SEG_A+                        SEG_F+SEG_G, 0)	/* Displays "<" as high c */ \
+	GLYPH(                  SEG_D+            SEG_G, 0)	/* Displays "=" */ \
+	GLYPH(0                                        , 0)	/* Displays " " (>) */ \
+	GLYPH(SEG_A+SEG_B+            SEG_E+      SEG_G, 0)	/* Displays "?" */ \
+	GLYPH(0                                        , 0)	/* Displays " " (@) */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+      SEG_E+SEG_F+SEG_G, 0)	/* Displays "A" */ \
+	GLYPH(            SEG_C+SEG_D+SEG_E+SEG_F+SEG_G, 0)	/* Displays "b" */ \
+	GLYPH(                  SEG_D+SEG_E+      SEG_G, 0)	/* Displays "c" */ \
+	GLYPH(      SEG_B+SEG_C+SEG_D+SEG_E+      SEG_G, 0)	/* Displays "d" */ \
+	GLYPH(SEG_A+            SEG_D+SEG_E+SEG_F+SEG_G, 0)	/* Displays "E" */ \
+	GLYPH(SEG_A+                  SEG_E+SEG_F+SEG_G, 0)	/* Displays "f" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+SEG_D+      SEG_F+SEG_G, 0)	/* Displays "g" same as 9 */ \
+	GLYPH(            SEG_C+      SEG_E+SEG_F+SEG_G, 0)	/* Displays "h" */ \
+	GLYPH(                        SEG_E            , 0)	/* Displays "i" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+SEG_D                  , 0)	/* Displays "J" */ \
+	GLYPH(                  SEG_D+      SEG_F+SEG_G, 0)	/* Displays "k" */ \
+	GLYPH(                  SEG_D+SEG_E+SEG_F      , 1)	/* Displays "L" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+      SEG_E+SEG_F      , 0)	/* Displays "M" */ \
+	GLYPH(            SEG_C+      SEG_E+      SEG_G, 0)	/* Displays "n" */ \
+	GLYPH(            SEG_C+SEG_D+SEG_E+      SEG_G, 0)	/* Displays "o" */ \
+	GLYPH(SEG_A+SEG_B+            SEG_E+SEG_F+SEG_G, 0)	/* Displays "P" */ \
+	GLYPH(SEG_A+SEG_B+SEG_C+            SEG_F+SEG_G, 0)	/* Displays "q" */ \
+	GLYPH(                        SEG_E+      SEG_G, 0)	/* Displays "r" */ \
+	GLYPH(SEG_A+      SEG_C+SEG_D+      SEG_F+SEG_G, 0)	/* Displays "S" same as 5 */ \
+	GLYPH(                  SEG_D+SEG_E+SEG_F+SEG_G, 0)	/* Displays "t" */ \
+	GLYPH(            SEG_C+SEG_D+SEG_E            , 0)	/* Displays "u" */ \
+	GLYPH(            SEG_C+SEG_D+SEG_E            , 0)	/* Displays "v" same as u */ \
+	GLYPH(      SEG_B+SEG_C+SEG_D+SEG_E+SEG_F+SEG_G, 0)	/* Displays "W" */ \
+	GLYPH(      SEG_B+SEG_C+      SEG_E+SEG_F+SEG_G, 0)	/* Displays "X" as H */ \
+	GLYPH(      SEG_B+SEG_C+SEG_D+      SEG_F+SEG_G, 0)	/* Displays "Y" */ \
+	GLYPH(SEG_A+SEG_B+      SEG_D+SEG_E+      SEG_G, 0)	/* Displays "Z" same as 2 */
+
+// LINE1 glyph
+#define LCD_GLYPH_L1(bits, l2_5)	(bits),
+
+// LINE2 glyph - LCD COM/SEG assignment is mirrored against LINE1, so high- and low-nibble are swapped
+#define LCD_GLYPH_L2(bits, l2_5)	(u8)((((bits) << 4) & 0xF0) | (((bits) >> 4) & 0x0F) | ((l2_5) ? BIT7 : 0)),
+
+// Font tables for LINE1 and LINE2 7-segment characters, index is (ASCII - LCD_FONT_FIRST)
 const u8 lcd_font[] =
 {
-  SEG_A+SEG_B+SEG_C+SEG_D+SEG_E+SEG_F,           // Displays "0"
-        SEG_B+SEG_C,                             // Displays "1"
-  SEG_A+SEG_B+      SEG_D+SEG_E+      SEG_G,     // Displays "2"
-  SEG_A+SEG_B+SEG_C+SEG_D+            SEG_G,     // Displays "3"
-        SEG_B+SEG_C+            SEG_F+SEG_G,     // Displays "4"
-  SEG_A+      SEG_C+SEG_D+      SEG_F+SEG_G,     // Displays "5"
-  SEG_A+      SEG_C+SEG_D+SEG_E+SEG_F+SEG_G,     // Displays "6"
-  SEG_A+SEG_B+SEG_C,                             // Displays "7"
-  SEG_A+SEG_B+SEG_C+SEG_D+SEG_E+SEG_F+SEG_G,     // Displays "8"
-  SEG_A+SEG_B+SEG_C+SEG_D+      SEG_F+SEG_G,     // Displays "9"
-  0                                        ,     // Displays " " (:)
-  0                                        ,     // Displays " " (;)
-  SEG_A+                        SEG_F+SEG_G,     // Displays "<" as high c
-                    SEG_D+            SEG_G,     // Displays "="
-  0                                        ,     // Displays " " (>)
-  SEG_A+SEG_B+            SEG_E+      SEG_G,     // Displays "?"
-  0                                        ,     // Displays " " (@)
-  SEG_A+SEG_B+SEG_C+      SEG_E+SEG_F+SEG_G,     // Displays "A"
-              SEG_C+SEG_D+SEG_E+SEG_F+SEG_G,     // Displays "b"
-                    SEG_D+SEG_E+      SEG_G,     // Displays "c"
-        SEG_B+SEG_C+SEG_D+SEG_E+      SEG_G,     // Displays "d"
-  SEG_A+           +SEG_D+SEG_E+SEG_F+SEG_G,     // Displays "E"
-  SEG_A+                  SEG_E+SEG_F+SEG_G,     // Displays "f"
-  SEG_A+SEG_B+SEG_C+SEG_D+      SEG_F+SEG_G,     // Displays "g" same as 9
-              SEG_C+      SEG_E+SEG_F+SEG_G,     // Displays "h"
-                          SEG_E            ,     // Displays "i"
-  SEG_A+SEG_B+SEG_C+SEG_D                  ,     // Displays "J"
-  		     		SEG_D+      SEG_F+SEG_G,     // Displays "k"
-                    SEG_D+SEG_E+SEG_F      ,     // Displays "L"
-  SEG_A+SEG_B+SEG_C+      SEG_E+SEG_F      ,     // Displays "M"
-              SEG_C+      SEG_E+      SEG_G,     // Displays "n"
-              SEG_C+SEG_D+SEG_E+      SEG_G,     // Displays "o"
-  SEG_A+SEG_B+            SEG_E+SEG_F+SEG_G,     // Displays "P"
-  SEG_A+SEG_B+SEG_C+            SEG_F+SEG_G,     // Displays "q"
-                          SEG_E+      SEG_G,     // Displays "r"
-  SEG_A+      SEG_C+SEG_D+      SEG_F+SEG_G,     // Displays "S" same as 5
-                    SEG_D+SEG_E+SEG_F+SEG_G,     // Displays "t"
-              SEG_C+SEG_D+SEG_E            ,     // Displays "u"
-              SEG_C+SEG_D+SEG_E            ,     // Displays "v" same as u
-        SEG_B+SEG_C+SEG_D+SEG_E+SEG_F+SEG_G,     // Displays "W"
-        SEG_B+SEG_C+     +SEG_E+SEG_F+SEG_G,     // Displays "X" as H
-        SEG_B+SEG_C+SEG_D+      SEG_F+SEG_G,     // Displays "Y"
-  SEG_A+SEG_B+      SEG_D+SEG_E+      SEG_G,     // Displays "Z" same as 2
+	LCD_GLYPHS(LCD_GLYPH_L1)
 };
 
-
-// Table with memory address for each display element 
-const u8 * segments_lcdmem[] =
+const u8 lcd_font_l2[] =
 {
-	LCD_SYMB_AM_MEM,
-	LCD_SYMB_PM_MEM,
-	LCD_SYMB_ARROW_UP_MEM,
-	LCD_SYMB_ARROW_DOWN_MEM,
-	LCD_SYMB_PERCENT_MEM,
-	LCD_SYMB_TOTAL_MEM,
-	LCD_SYMB_AVERAGE_MEM,
-	LCD_SYMB_MAX_MEM,
-	LCD_SYMB_BATTERY_MEM,
-	LCD_UNIT_L1_FT_MEM,
-	LCD_UNIT_L1_K_MEM,
-	LCD_UNIT_L1_M_MEM,
-	LCD_UNIT_L1_I_MEM,
-	LCD_UNIT_L1_PER_S_MEM,
-	LCD_UNIT_L1_PER_H_MEM,
-	LCD_UNIT_L1_DEGREE_MEM,
-	LCD_UNIT_L2_KCAL_MEM,
-	LCD_UNIT_L2_KM_MEM,
-	LCD_UNIT_L2_MI_MEM,
-	LCD_ICON_HEART_MEM,
-	LCD_ICON_STOPWATCH_MEM,
-	LCD_ICON_RECORD_MEM,
-	LCD_ICON_ALARM_MEM,
-	LCD_ICON_BEEPER1_MEM,
-	LCD_ICON_BEEPER2_MEM,
-	LCD_ICON_BEEPER3_MEM,
-	LCD_SEG_L1_3_MEM,
-	LCD_SEG_L1_2_MEM,
-	LCD_SEG_L1_1_MEM,
-	LCD_SEG_L1_0_MEM,
-	LCD_SEG_L1_COL_MEM,
-	LCD_SEG_L1_DP1_MEM,
-	LCD_SEG_L1_DP0_MEM,
-	LCD_SEG_L2_5_MEM,
-	LCD_SEG_L2_4_MEM,
-	LCD_SEG_L2_3_MEM,
-	LCD_SEG_L2_2_MEM,
-	LCD_SEG_L2_1_MEM,
-	LCD_SEG_L2_0_MEM,
-	LCD_SEG_L2_COL1_MEM,
-	LCD_SEG_L2_COL0_MEM,
-	LCD_SEG_L2_DP_MEM,
+	LCD_GLYPHS(LCD_GLYPH_L2)
 };
 
 
-// Table with bit mask for each display element 
-const u8 segments_bitmask[] =
+// Memory byte and bit mask for each display element
+#define LCD_SEGMENT(item)		{ LCD_MEM_INDEX(item##_MEM), item##_MASK },
+
+const s_lcd_segment lcd_segments[] =
 {
-	LCD_SYMB_AM_MASK,
-	LCD_SYMB_PM_MASK,
-	LCD_SYMB_ARROW_UP_MASK,
-	LCD_SYMB_ARROW_DOWN_MASK,
-	LCD_SYMB_PERCENT_MASK,
-	LCD_SYMB_TOTAL_MASK,
-	LCD_SYMB_AVERAGE_MASK,
-	LCD_SYMB_MAX_MASK,
-	LCD_SYMB_BATTERY_MASK,
-	LCD_UNIT_L1_FT_MASK,
-	LCD_UNIT_L1_K_MASK,
-	LCD_UNIT_L1_M_MASK,
-	LCD_UNIT_L1_I_MASK,
-	LCD_UNIT_L1_PER_S_MASK,
-	LCD_UNIT_L1_PER_H_MASK,
-	LCD_UNIT_L1_DEGREE_MASK,
-	LCD_UNIT_L2_KCAL_MASK,
-	LCD_UNIT_L2_KM_MASK,
-	LCD_UNIT_L2_MI_MASK,
-	LCD_ICON_HEART_MASK,
-	LCD_ICON_STOPWATCH_MASK,
-	LCD_ICON_RECORD_MASK,
-	LCD_ICON_ALARM_MASK,
-	LCD_ICON_BEEPER1_MASK,
-	LCD_ICON_BEEPER2_MASK,
-	LCD_ICON_BEEPER3_MASK,
-	LCD_SEG_L1_3_MASK,
-	LCD_SEG_L1_2_MASK,
-	LCD_SEG_L1_1_MASK,
-	LCD_SEG_L1_0_MASK,
-	LCD_SEG_L1_COL_MASK,
-	LCD_SEG_L1_DP1_MASK,
-	LCD_SEG_L1_DP0_MASK,
-	LCD_SEG_L2_5_MASK,
-	LCD_SEG_L2_4_MASK,
-	LCD_SEG_L2_3_MASK,
-	LCD_SEG_L2_2_MASK,
-	LCD_SEG_L2_1_MASK,
-	LCD_SEG_L2_0_MASK,
-	LCD_SEG_L2_COL1_MASK,
-	LCD_SEG_L2_COL0_MASK,
-	LCD_SEG_L2_DP_MASK,
+	LCD_SEGMENT(LCD_SYMB_AM)
+	LCD_SEGMENT(LCD_SYMB_PM)
+	LCD_SEGMENT(LCD_SYMB_ARROW_UP)
+	LCD_SEGMENT(LCD_SYMB_ARROW_DOWN)
+	LCD_SEGMENT(LCD_SYMB_PERCENT)
+	LCD_SEGMENT(LCD_SYMB_TOTAL)
+	LCD_SEGMENT(LCD_SYMB_AVERAGE)
+	LCD_SEGMENT(LCD_SYMB_MAX)
+	LCD_SEGMENT(LCD_SYMB_BATTERY)
+	LCD_SEGMENT(LCD_UNIT_L1_FT)
+	LCD_SEGMENT(LCD_UNIT_L1_K)
+	LCD_SEGMENT(LCD_UNIT_L1_M)
+	LCD_SEGMENT(LCD_UNIT_L1_I)
+	LCD_SEGMENT(LCD_UNIT_L1_PER_S)
+	LCD_SEGMENT(LCD_UNIT_L1_PER_H)
+	LCD_SEGMENT(LCD_UNIT_L1_DEGREE)
+	LCD_SEGMENT(LCD_UNIT_L2_KCAL)
+	LCD_SEGMENT(LCD_UNIT_L2_KM)
+	LCD_SEGMENT(LCD_UNIT_L2_MI)
+	LCD_SEGMENT(LCD_ICON_HEART)
+	LCD_SEGMENT(LCD_ICON_STOPWATCH)
+	LCD_SEGMENT(LCD_ICON_RECORD)
+	LCD_SEGMENT(LCD_ICON_ALARM)
+	LCD_SEGMENT(LCD_ICON_BEEPER1)
+	LCD_SEGMENT(LCD_ICON_BEEPER2)
+	LCD_SEGMENT(LCD_ICON_BEEPER3)
+	LCD_SEGMENT(LCD_SEG_L1_3)
+	LCD_SEGMENT(LCD_SEG_L1_2)
+	LCD_SEGMENT(LCD_SEG_L1_1)
+	LCD_SEGMENT(LCD_SEG_L1_0)
+	LCD_SEGMENT(LCD_SEG_L1_COL)
+	LCD_SEGMENT(LCD_SEG_L1_DP1)
+	LCD_SEGMENT(LCD_SEG_L1_DP0)
+	LCD_SEGMENT(LCD_SEG_L2_5)
+	LCD_SEGMENT(LCD_SEG_L2_4)
+	LCD_SEGMENT(LCD_SEG_L2_3)
+	LCD_SEGMENT(LCD_SEG_L2_2)
+	LCD_SEGMENT(LCD_SEG_L2_1)
+	LCD_SEGMENT(LCD_SEG_L2_0)
+	LCD_SEGMENT(LCD_SEG_L2_COL1)
+	LCD_SEGMENT(LCD_SEG_L2_COL0)
+	LCD_SEGMENT(LCD_SEG_L2_DP)
 };
 
 
-// Quick integer to array conversion table for most common integer values
-const u8 itoa_conversion_table[][3] =
+// First character and length of each 7-segment array (LCD_SEG_L1_3_0 .. LCD_SEG_L2_4_3)
+const s_lcd_array lcd_arrays[] =
 {
-	"000", "001", "002", "003", "004", "005", "006", "007", "008", "009", "010", "011", "012", "013", "014", "015",
-	"016", "017", "018", "019", "020", "021", "022", "023", "024", "025", "026", "027", "028", "029", "030", "031",
-	"032", "033", "034", "035", "036", "037", "038", "039", "040", "041", "042", "043", "044", "045", "046", "047",
-	"048", "049", "050", "051", "052", "053", "054", "055", "056", "057", "058", "059", "060", "061", "062", "063",
-	"064", "065", "066", "067", "068", "069", "070", "071", "072", "073", "074", "075", "076", "077", "078", "079",
-	"080", "081", "082", "083", "084", "085", "086", "087", "088", "089", "090", "091", "092", "093", "094", "095",
-	"096", "097", "098", "099", "100", "101", "102", "103", "104", "105", "106", "107", "108", "109", "110", "111",
-	"112", "113", "114", "115", "116", "117", "118", "119", "120", "121", "122", "123", "124", "125", "126", "127",
-	"128", "129", "130", "131", "132", "133", "134", "135", "136", "137", "138", "139", "140", "141", "142", "143",
-	"144", "145", "146", "147", "148", "149", "150", "151", "152", "153", "154", "155", "156", "157", "158", "159",
-	"160", "161", "162", "163", "164", "165", "166", "167", "168", "169", "170", "171", "172", "173", "174", "175",
-	"176", "177", "178", "179", "180",
+	// LINE1
+	{ LCD_SEG_L1_3, 4 },		// LCD_SEG_L1_3_0
+	{ LCD_SEG_L1_2, 3 },		// LCD_SEG_L1_2_0
+	{ LCD_SEG_L1_1, 2 },		// LCD_SEG_L1_1_0
+	{ LCD_SEG_L1_3, 3 },		// LCD_SEG_L1_3_1
+	{ LCD_SEG_L1_3, 2 },		// LCD_SEG_L1_3_2
+
+	// LINE2
+	{ LCD_SEG_L2_5, 6 },		// LCD_SEG_L2_5_0
+	{ LCD_SEG_L2_4, 5 },		// LCD_SEG_L2_4_0
+	{ LCD_SEG_L2_3, 4 },		// LCD_SEG_L2_3_0
+	{ LCD_SEG_L2_2, 3 },		// LCD_SEG_L2_2_0
+	{ LCD_SEG_L2_1, 2 },		// LCD_SEG_L2_1_0
+	{ LCD_SEG_L2_5, 4 },		// LCD_SEG_L2_5_2
+	{ LCD_SEG_L2_3, 2 },		// LCD_SEG_L2_3_2
+	{ LCD_SEG_L2_5, 2 },		// LCD_SEG_L2_5_4
+	{ LCD_SEG_L2_4, 3 },		// LCD_SEG_L2_4_2
+	{ LCD_SEG_L2_4, 2 },		// LCD_SEG_L2_4_3
 };
 
+
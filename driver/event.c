@@ -0,0 +1,236 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Event ring between ISRs and main loop. ISRs queue typed events in the order they happen, 
+// main loop processes them in the same order. No event is merged with or cleared by another one.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "event.h"
+
+
+// *************************************************************************************************
+// Prototypes section
+void event_reset(void);
+u8 event_push(u8 type, u8 arg);
+u8 event_push_at(u8 type, u8 arg, u16 stamp);
+void event_push_level(u8 type);
+u8 event_pop(s_event * ev);
+void event_discard(u8 type);
+u8 is_event_pending(void);
+
+
+// *************************************************************************************************
+// Defines section
+
+
+// *************************************************************************************************
+// Global Variable section
+struct event sEvent;
+
+
+// *************************************************************************************************
+// Extern section
+
+
+// *************************************************************************************************
+// @fn          event_reset
+// @brief       Discard all queued events.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void event_reset(void)
+{
+	istate_t int_state;
+
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+
+	sEvent.head 	= 0;
+	sEvent.tail 	= 0;
+	sEvent.queued 	= 0;
+	sEvent.overflow = 0;
+#ifdef DEBUG
+	sEvent.latency_max = 0;
+#endif
+
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          event_push
+// @brief       Queue an event that happens now. Call only from ISR context.
+// @param       u8 type		EVENT_xxx
+//				u8 arg		Event argument
+// @return      u8			1 = event queued, 0 = ring full
+// *************************************************************************************************
+u8 event_push(u8 type, u8 arg)
+{
+	return (event_push_at(type, arg, TA0R));
+}
+
+
+// *************************************************************************************************
+// @fn          event_push_at
+// @brief       Queue an event. Call only from ISR context (ISRs do not nest, so together they are 
+//				the single producer). When the ring is full, the event is dropped and counted.
+// @param       u8 type		EVENT_xxx
+//				u8 arg		Event argument
+//				u16 stamp	TA0R at time of event
+// @return      u8			1 = event queued, 0 = ring full
+// *************************************************************************************************
+u8 event_push_at(u8 type, u8 arg, u16 stamp)
+{
+	u8 head = sEvent.head;
+	s_event * ev;
+
+	// Ring full?
+	if (((head + 1) & EVENT_RING_MASK) == sEvent.tail)
+	{
+		sEvent.overflow++;
+		return (0);
+	}
+
+	// Fill slot before publishing it by advancing head
+	ev = &sEvent.ring[head];
+	ev->type  = type;
+	ev->arg   = arg;
+	ev->stamp = stamp;
+	sEvent.head = (head + 1) & EVENT_RING_MASK;
+
+	return (1);
+}
+
+
+// *************************************************************************************************
+// @fn          event_push_level
+// @brief       Queue a level event (sensor DRDY, redraw request). A level event stays in the ring 
+//				only once - the consumer reads the latest sensor data or draws the latest values 
+//				anyway, so a DRDY storm cannot fill the ring and push out other events. Call only 
+//				from ISR context.
+// @param       u8 type		EVENT_xxx
+// @return      none
+// *************************************************************************************************
+void event_push_level(u8 type)
+{
+	u16 bit = BIT0 << type;
+
+	if (sEvent.queued & bit) return;
+
+	// Mark as queued only if it actually went into the ring
+	if (event_push(type, 0)) sEvent.queued |= bit;
+}
+
+
+// *************************************************************************************************
+// @fn          event_pop
+// @brief       Take oldest event from ring. Call only from main loop.
+// @param       s_event * ev		Copy of event
+// @return      u8					1 = event taken, 0 = ring empty
+// *************************************************************************************************
+u8 event_pop(s_event * ev)
+{
+	u8 tail = sEvent.tail;
+
+	if (tail == sEvent.head) return (0);
+
+	*ev = sEvent.ring[tail];
+
+	// Release slot to producer
+	sEvent.tail = (tail + 1) & EVENT_RING_MASK;
+
+	// Allow next DRDY of this type to be queued (single BIC instruction - atomic)
+	sEvent.queued &= ~(BIT0 << ev->type);
+
+#ifdef DEBUG
+	// Track worst case time an event waited for the main loop
+	if ((u16)(TA0R - ev->stamp) > sEvent.latency_max) sEvent.latency_max = TA0R - ev->stamp;
+#endif
+
+	return (1);
+}
+
+
+// *************************************************************************************************
+// @fn          event_discard
+// @brief       Drop all queued events of one type, keep the order of the others. Call only from 
+//				main loop.
+// @param       u8 type		EVENT_xxx
+// @return      none
+// *************************************************************************************************
+void event_discard(u8 type)
+{
+	istate_t int_state;
+	u8 from, to;
+
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+
+	// Move kept events towards head, then release the freed slots
+	from = sEvent.head;
+	to   = sEvent.head;
+	while (from != sEvent.tail)
+	{
+		from = (from - 1) & EVENT_RING_MASK;
+		if (sEvent.ring[from].type != type)
+		{
+			to = (to - 1) & EVENT_RING_MASK;
+			sEvent.ring[to] = sEvent.ring[from];
+		}
+	}
+	sEvent.tail = to;
+	sEvent.queued &= ~(BIT0 << type);
+
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          is_event_pending
+// @brief       Check if main loop has events to process.
+// @param       none
+// @return      u8		1 = ring not empty
+// *************************************************************************************************
+u8 is_event_pending(void)
+{
+	return (sEvent.head != sEvent.tail);
+}
@@ -0,0 +1,109 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+
+// *************************************************************************************************
+// Include section
+
+
+// *************************************************************************************************
+// Defines section
+
+// Event types
+#define EVENT_TEMPERATURE					(0u)		// Measure temperature, arg: FILTER_ON / FILTER_OFF
+#define EVENT_VOLTAGE						(1u)		// Measure battery voltage
+#define EVENT_ALTITUDE						(2u)		// Pressure sensor DRDY - read sensor
+#define EVENT_ACCELERATION					(3u)		// Acceleration sensor DRDY - read sensor
+#define EVENT_BUZZER						(4u)		// Output buzzer for alarm / chime
+#define EVENT_STRENGTH_BUZZER				(5u)		// Output buzzer from strength_data
+#define EVENT_ALARM							(6u)		// RTC_A alarm matched
+#define EVENT_BUTTON						(7u)		// Button gesture, arg: BUTTON_xxx
+#define EVENT_TIME							(8u)		// RTC time was read - redraw clock
+#define EVENT_DATE							(9u)		// RTC date changed - redraw date
+#define EVENT_STOPWATCH						(10u)		// Redraw visible stopwatch or eggtimer
+#define EVENT_REDRAW						(11u)		// Redraw all content
+#define EVENT_MESSAGE						(12u)		// Show / erase message, arg: MESSAGE_xxx
+#define EVENT_TYPES							(13u)
+
+// Ring size - must be a power of 2
+#define EVENT_RING_SIZE						(16u)
+#define EVENT_RING_MASK						(EVENT_RING_SIZE - 1u)
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Typed event, timestamped with TA0R when queued
+typedef struct
+{
+	u8		type;			// EVENT_xxx
+	u8		arg;			// Optional event argument
+	u16		stamp;			// TA0R at time of event
+} s_event;
+
+// Single producer (ISRs, which do not nest) / single consumer (main loop) ring
+struct event
+{
+	s_event			ring[EVENT_RING_SIZE];
+	volatile u8		head;			// Written only by producer
+	volatile u8		tail;			// Written only by consumer
+	volatile u16	queued;			// Level events (DRDY, redraw) currently in ring - bit per type
+	volatile u8		overflow;		// Number of events dropped because ring was full
+#ifdef DEBUG
+	u16				latency_max;	// Longest time an event waited in ring (ACLK ticks)
+#endif
+};
+extern struct event sEvent;
+
+
+// *************************************************************************************************
+// Prototypes section
+extern void event_reset(void);
+extern u8 event_push(u8 type, u8 arg);
+extern u8 event_push_at(u8 type, u8 arg, u16 stamp);
+extern void event_push_level(u8 type);
+extern u8 event_pop(s_event * ev);
+extern void event_discard(u8 type);
+extern u8 is_event_pending(void);
+
+
+// *************************************************************************************************
+// Extern section
+
+
+#endif /*EVENT_H_*/
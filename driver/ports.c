@@ -50,6 +50,7 @@
 #endif
 #include "vti_ps.h"
 #include "timer.h"
+#include "event.h"
 #include "display.h"
 
 // logic
@@ -59,6 +60,9 @@
 #include "simpliciti.h"
 #include "altitude.h"
 #include "stopwatch.h"
+#ifdef FEATURE_PROVIDE_ACCEL
+#include "acceleration.h"
+#endif
 
 
 // *************************************************************************************************
@@ -66,6 +70,17 @@
 void button_repeat_on(u16 msec);
 void button_repeat_off(void);
 void button_repeat_function(void);
+void button_debounce(void);
+#ifdef DEBUG
+void button_latency(u16 stamp);
+#endif
+void button_gesture_reset(void);
+void button_gesture_update(u16 stamp);
+u8 button_gesture_edge(u16 stamp);
+void button_gesture_event(u8 pin, u8 event, u16 stamp);
+u8 button_gesture_chord(u8 chord);
+void button_gesture_tick(void);
+void button_gesture_arm(void);
 
 
 // *************************************************************************************************
@@ -74,16 +89,26 @@ void button_repeat_function(void);
 // Macro for button IRQ 
 #define IRQ_TRIGGERED(flags, bit)		((flags & bit) == bit)
 
+// Buttons with press and release edge tracking - backlight pin is driven by the backlight itself
+#define GESTURE_BUTTONS					(BUTTON_STAR_PIN + BUTTON_NUM_PIN + BUTTON_UP_PIN + BUTTON_DOWN_PIN)
+
+// Chords: STAR+UP toggles key beep, NUM+DOWN locks / unlocks buttons
+#define GESTURE_CHORD_BEEP				(BUTTON_STAR_PIN + BUTTON_UP_PIN)
+#define GESTURE_CHORD_LOCK				(BUTTON_NUM_PIN + BUTTON_DOWN_PIN)
+
+// Gesture events - added to button in EVENT_BUTTON argument
+#define GESTURE_SHORT					(0u)
+#define GESTURE_LONG					(BUTTON_LONG)
+#define GESTURE_DOUBLE					(BUTTON_DOUBLE)
+
 
 // *************************************************************************************************
 // Global Variable section
-volatile s_button_flags button;
 volatile struct struct_button sButton;
 
 
 // *************************************************************************************************
 // Extern section
-extern void (*fptr_Timer0_A3_function)(void);
 
 
 // *************************************************************************************************
@@ -132,19 +157,16 @@ interrupt (PORT2_VECTOR) PORT2_ISR(void)
 __interrupt void PORT2_ISR(void)
 #endif
 {
-	u8 int_flag, int_enable;
-	u8 buzzer = 0;
+	u8 int_flag;
+	u16 stamp;
 	u8 simpliciti_button_event = 0;
 	static u8 simpliciti_button_repeat = 0;
 
-	// Clear button flags
-	button.all_flags = 0;
-
-	// Remember interrupt enable bits
-	int_enable = BUTTONS_IE;
+	// Timestamp edge
+	stamp = TA0R;
 
 	// Store valid button interrupt flag
-	int_flag = BUTTONS_IFG & int_enable;
+	int_flag = BUTTONS_IFG & BUTTONS_IE;
 
 	// ---------------------------------------------------
 	// While SimpliciTI stack is active, buttons behave differently:
@@ -152,6 +174,10 @@ __interrupt void PORT2_ISR(void)
 	//  - Exit SimpliciTI when button DOWN was pressed 
   	if (is_rf())
   	{
+  		// Only press edges are button events, stop tracking release edges
+  		int_flag &= ~(BUTTONS_IES & ALL_BUTTONS);
+  		button_gesture_reset();
+  		
   		// Erase previous button press after a number of resends (increase number if link quality is low)
   		// This will create a series of packets containing the same button press
   		// Necessary because we have no acknowledge
@@ -190,125 +216,140 @@ __interrupt void PORT2_ISR(void)
 		// Debounce buttons
 		if ((int_flag & ALL_BUTTONS) != 0)
 		{ 
-			// Disable PORT2 IRQ
-			__disable_interrupt();
-			BUTTONS_IE = 0x00; 
-			__enable_interrupt();
-	
-			// Debounce delay 1
-			Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_IN));
+			// First edge: remember time of edge and check buttons when debounce time is over
+			if (sButton.edges == 0)
+			{
+				sButton.edge_stamp = stamp;
+				sButton.bounces    = 0;
+				Timer0_A4_Start(TIMER0_A4_DEBOUNCE, CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_IN), 0, button_debounce);
+			}
+			sButton.edges |= int_flag & ALL_BUTTONS;
+			
+			// Disable button IRQs until debounce time is over - IRQ flags still record bouncing
+			BUTTONS_IE &= ~ALL_BUTTONS; 
 	
 			// Reset inactivity detection
-			sTime.last_activity = sTime.system_time;
+			sTime.last_activity = Timer0_Seconds();
 		}
+	}
+	
+	#ifdef FEATURE_PROVIDE_ACCEL
+	// ---------------------------------------------------
+	// Acceleration sensor IRQ
+	if (IRQ_TRIGGERED(int_flag, AS_INT_PIN))
+	{
+		// Get data from sensor while acceleration menu item is active
+		if (is_acceleration_measurement()) event_push_level(EVENT_ACCELERATION);
+  	}
+	#endif
+	
+  	// ---------------------------------------------------
+	// Pressure sensor IRQ
+	if (IRQ_TRIGGERED(int_flag, PS_INT_PIN)) 
+	{
+		// Get data from sensor
+		event_push_level(EVENT_ALTITUDE);
+  	}
+  	
+	// Reset serviced IRQ flags
+	BUTTONS_IFG &= ~int_flag; 	
 
-		// ---------------------------------------------------
-		// STAR button IRQ
-		if (IRQ_TRIGGERED(int_flag, BUTTON_STAR_PIN))
-		{
-			// Filter bouncing noise 
-			if (BUTTON_STAR_IS_PRESSED)
-			{
-				button.flag.star = 1;
-				
-				// Generate button click
-				buzzer = 1;
-			}
-		}
-		// ---------------------------------------------------
-		// NUM button IRQ
-		else if (IRQ_TRIGGERED(int_flag, BUTTON_NUM_PIN))
-		{
-			// Filter bouncing noise 
-			if (BUTTON_NUM_IS_PRESSED)
-			{
-				button.flag.num = 1;
+#ifdef DEBUG
+	// Track worst case IRQ latency caused by this ISR
+	button_latency(stamp);
+#endif
+
+	// Exit from LPM3/LPM4 on RETI
+	__bic_SR_register_on_exit(LPM4_bits); 
+}
+
+
+// *************************************************************************************************
+// @fn          button_debounce
+// @brief       Called by Timer0_A4 debounce timer when debounce time after a button edge is over.
+//				Waits for another debounce time while buttons still bounce, then classifies 
+//				the stable button levels and enables button IRQs again.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void button_debounce(void)
+{
+	u8 pressed, pin;
+	u8 buzzer = 0;
+#ifdef DEBUG
+	u16 stamp = TA0R;
+#endif
 	
-				// Generate button click
-				buzzer = 1;
-				
-				if( !sys.flag.lock_buttons)
-				{
-					#ifdef CONFIG_STOP_WATCH
-					// Faster reaction for stopwatch split button press
-					if (is_stopwatch_run())
-					{
-						split_stopwatch();
-						button.flag.num = 0;
-						
-					}
-					#endif
-				}
-			}
-		}
-		// ---------------------------------------------------
-		// UP button IRQ
-		else if (IRQ_TRIGGERED(int_flag, BUTTON_UP_PIN))
+	// Buttons still bounce: wait another debounce time
+	if ((BUTTONS_IFG & ALL_BUTTONS) && (sButton.bounces++ < BUTTONS_DEBOUNCE_RETRIES))
+	{
+		sButton.edges |= BUTTONS_IFG & ALL_BUTTONS;
+		BUTTONS_IFG &= ~ALL_BUTTONS;
+		Timer0_A4_Start(TIMER0_A4_DEBOUNCE, CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_IN), 0, button_debounce);
+		return;
+	}
+	
+	// Buttons have been released / pressed again while SimpliciTI was started
+	if (is_rf())
+	{
+		sButton.edges = 0;
+		BUTTONS_IFG &= ~ALL_BUTTONS;
+		BUTTONS_IE  |= ALL_BUTTONS;
+		return;
+	}
+	
+	// Classify press and release edges - short, long and double-click events are queued on release
+	pressed = button_gesture_edge(sButton.edge_stamp);
+	
+	// Generate button click
+	if (pressed) buzzer = 1;
+
+	// ---------------------------------------------------
+	// NUM / DOWN button press
+	if( !sys.flag.lock_buttons)
+	{
+		#ifdef CONFIG_STOP_WATCH
+		// Faster reaction for stopwatch split button press
+		if ((pressed & BUTTON_NUM_PIN) && is_stopwatch_run())
 		{
-			// Filter bouncing noise 
-			if (BUTTON_UP_IS_PRESSED)
-			{
-				button.flag.up = 1;
-		
-				// Generate button click
-				buzzer = 1;
-			}
+			split_stopwatch(Timer0_Ticks_At(sButton.edge_stamp));
+			sButton.reported |= BUTTON_NUM_PIN;
 		}
-		// ---------------------------------------------------
-		// DOWN button IRQ
-		else if (IRQ_TRIGGERED(int_flag, BUTTON_DOWN_PIN))
+		// Faster reaction for stopwatch stop button press
+		if ((pressed & BUTTON_DOWN_PIN) && is_stopwatch_run())
 		{
-			// Filter bouncing noise 
-			if (BUTTON_DOWN_IS_PRESSED)
-			{
-				button.flag.down = 1;
-	
-				// Generate button click
-				buzzer = 1;
-				
-				if( !sys.flag.lock_buttons)
-				{
-					#ifdef CONFIG_STOP_WATCH
-					// Faster reaction for stopwatch stop button press
-					if (is_stopwatch_run())
-					{
-						stop_stopwatch();
-						button.flag.down = 0;
-					}
-					// Faster reaction for stopwatch start button press
-					else if (is_stopwatch_stop())
-					{
-						start_stopwatch();
-						button.flag.down = 0;
-					}
-					#endif
-				}
-			}
+			stop_stopwatch(Timer0_Ticks_At(sButton.edge_stamp));
+			sButton.reported |= BUTTON_DOWN_PIN;
 		}
-		// ---------------------------------------------------
-		// B/L button IRQ
-		else if (IRQ_TRIGGERED(int_flag, BUTTON_BACKLIGHT_PIN))
+		// Faster reaction for stopwatch start button press
+		else if ((pressed & BUTTON_DOWN_PIN) && is_stopwatch_stop())
 		{
-			// Filter bouncing noise 
-			if (BUTTON_BACKLIGHT_IS_PRESSED)
-			{
-				sButton.backlight_status = 1;
-				sButton.backlight_timeout = 0;
-				P2OUT |= BUTTON_BACKLIGHT_PIN;
-				P2DIR |= BUTTON_BACKLIGHT_PIN;
-				button.flag.backlight = 1;
-			}
-		}	
+			start_stopwatch(Timer0_Ticks_At(sButton.edge_stamp));
+			sButton.reported |= BUTTON_DOWN_PIN;
+		}
+		#endif
 	}
 	
-	// Trying to lock/unlock buttons?
-	if ((button.flag.num && button.flag.down) || (button.flag.star && button.flag.up))
+	// ---------------------------------------------------
+	// B/L button IRQ
+	if (sButton.edges & BUTTON_BACKLIGHT_PIN)
 	{
-		// No buzzer output
-		buzzer = 0;
-		button.all_flags = 0;
-	}
-
+		// Filter bouncing noise 
+		if (BUTTON_BACKLIGHT_IS_PRESSED)
+		{
+			sButton.backlight_status = 1;
+			P2OUT |= BUTTON_BACKLIGHT_PIN;
+			P2DIR |= BUTTON_BACKLIGHT_PIN;
+			event_push_at(EVENT_BUTTON, BUTTON_BACKLIGHT, sButton.edge_stamp);
+			
+			// Generate button click
+			buzzer = 1;
+			
+			// Turn backlight off after timeout
+			Timer0_A0_Schedule(TICK_BACKLIGHT, BACKLIGHT_TIME_ON + 1);
+		}
+	}	
+	
 	// Generate button click when button was activated
 	if (buzzer)
 	{
@@ -317,7 +358,9 @@ __interrupt void PORT2_ISR(void)
 		if (sAlarm.state == ALARM_ON) 
 		{
 			stop_alarm();
-			button.all_flags = 0;
+			
+			// Do not report the buttons that stopped the alarm
+			sButton.reported |= sButton.pressed;
 		}
 		else 
 		#endif
@@ -325,53 +368,324 @@ __interrupt void PORT2_ISR(void)
 		{
 			start_buzzer(1, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(150));
 		}
+	}
+	
+	// Set mode binds no long press or double-click: report short presses on press, auto repeat 
+	// takes over while the button is held
+	if (sys.flag.up_down_repeat_enabled)
+	{
+		for (pin=BIT0; pin<=BIT4; pin<<=1)
+		{
+			if ((pressed & ~sButton.reported) & pin)
+			{
+				button_gesture_event(pin, GESTURE_SHORT, sButton.edge_stamp);
+				sButton.reported |= pin;
+			}
+		}
+	}
+	
+	// Reenable button IRQs
+	sButton.edges = 0;
+	BUTTONS_IFG &= ~ALL_BUTTONS; 	
+	BUTTONS_IE  |= ALL_BUTTONS; 	
+	
+	// Edge was missed while IRQ was disabled: trigger IRQ again to classify it
+	BUTTONS_IFG |= (BUTTONS_IN ^ sButton.pressed) & GESTURE_BUTTONS;
+	
+#ifdef DEBUG
+	// Track worst case IRQ latency caused by this function
+	button_latency(stamp);
+#endif
+}
+
+
+#ifdef DEBUG
+// *************************************************************************************************
+// @fn          button_latency
+// @brief       Track longest time spent in button IRQ code. No other IRQ can be serviced during
+//				this time, so it is the worst case IRQ latency caused by button handling.
+// @param       u16 stamp		TA0R value at start of IRQ code
+// @return      none
+// *************************************************************************************************
+void button_latency(u16 stamp)
+{
+	u16 ticks = TA0R - stamp;
+	
+	if (ticks > sButton.latency_max) sButton.latency_max = ticks;
+}
+#endif
+
+
+// *************************************************************************************************
+// @fn          button_gesture_reset
+// @brief       Forget all held buttons and wait for press edges again.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void button_gesture_reset(void)
+{
+	sButton.pressed  = 0;
+	sButton.reported = 0;
+	sButton.chord    = 0;
+	sButton.clicked  = 0;
+	sButton.doubled  = 0;
+	Timer0_A4_Stop(TIMER0_A4_GESTURE);
+	
+	// IRQ triggers on rising edge
+	BUTTONS_IES &= ~ALL_BUTTONS;   
+}
+
+
+// *************************************************************************************************
+// @fn          button_gesture_update
+// @brief       Add time since last edge or gesture timer to the time the held buttons are pressed.
+// @param       u16 stamp		Current TA0R value
+// @return      none
+// *************************************************************************************************
+void button_gesture_update(u16 stamp)
+{
+	u8 i, pin;
+	u16 delta;
+	
+	for (i=0, pin=BIT0; i<BUTTONS_COUNT; i++, pin<<=1)
+	{
+		if ((sButton.pressed & pin) == 0) continue;
 		
-		// Debounce delay 2
-		Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
+		delta = stamp - sButton.stamp[i];
+		sButton.stamp[i] = stamp;
+		
+		// Saturate at 2 sec - this is longer than any gesture time
+		if (sButton.held[i] > 0xFFFF - delta) 	sButton.held[i] = 0xFFFF;
+		else									sButton.held[i] += delta;
 	}
+}
+
+
+// *************************************************************************************************
+// @fn          button_gesture_edge
+// @brief       Compare debounced button levels with the held buttons and classify the edges.
+//				Press edges start time measurement, release edges set short, long or double-click 
+//				events. Buttons of a chord or an already reported long press set no release event.
+// @param       u16 stamp		TA0R value when edge was detected
+// @return      u8				Buttons pressed with this edge that are not part of a chord
+// *************************************************************************************************
+u8 button_gesture_edge(u16 stamp)
+{
+	u8 i, pin, level, changed;
+	u8 pressed = 0;
 	
-	#ifdef FEATURE_PROVIDE_ACCEL
-	// ---------------------------------------------------
-	// Acceleration sensor IRQ
-	if (IRQ_TRIGGERED(int_flag, AS_INT_PIN))
+	button_gesture_update(stamp);
+	
+	level   = BUTTONS_IN & GESTURE_BUTTONS;
+	changed = level ^ sButton.pressed;
+	
+	for (i=0, pin=BIT0; i<BUTTONS_COUNT; i++, pin<<=1)
 	{
-		// Get data from sensor
-		request.flag.acceleration_measurement = 1;
-  	}
-	#endif
+		if ((changed & pin) == 0) continue;
+		
+		if (level & pin)
+		{
+			// Press edge: second press within double-click time?
+			if ((sButton.clicked & pin) && ((u16)(stamp - sButton.stamp[i]) <= CONV_MS_TO_TICKS(BUTTONS_DOUBLE_TIME)))
+			{
+				sButton.doubled |= pin;
+			}
+			sButton.clicked &= ~pin;
+			sButton.stamp[i] = stamp;
+			sButton.held[i]  = 0;
+			pressed |= pin;
+		}
+		else
+		{
+			// Release edge
+			if (((sButton.reported | sButton.chord) & pin) == 0)
+			{
+				if (sButton.held[i] >= CONV_MS_TO_TICKS(BUTTONS_LONG_TIME))
+				{
+					// Released before gesture timer detected long press
+					button_gesture_event(pin, GESTURE_LONG, stamp);
+				}
+				else if (sButton.doubled & pin)
+				{
+					// Second click is reported as short press, too
+					button_gesture_event(pin, GESTURE_SHORT, stamp);
+					button_gesture_event(pin, GESTURE_DOUBLE, stamp);
+				}
+				else
+				{
+					button_gesture_event(pin, GESTURE_SHORT, stamp);
+					sButton.clicked |= pin;
+				}
+			}
+			
+			// Remember release time for double-click detection
+			sButton.stamp[i] = stamp;
+			sButton.reported &= ~pin;
+			sButton.chord    &= ~pin;
+			sButton.doubled  &= ~pin;
+		}
+	}
+	sButton.pressed = level;
 	
-  	// ---------------------------------------------------
-	// Pressure sensor IRQ
-	if (IRQ_TRIGGERED(int_flag, PS_INT_PIN)) 
+	// Both buttons of a chord are held
+	if ((level & GESTURE_CHORD_BEEP) == GESTURE_CHORD_BEEP) sButton.chord |= GESTURE_CHORD_BEEP;
+	if ((level & GESTURE_CHORD_LOCK) == GESTURE_CHORD_LOCK) sButton.chord |= GESTURE_CHORD_LOCK;
+	
+	// IRQ triggers on falling edge for held buttons and on rising edge for released buttons
+	BUTTONS_IES = (BUTTONS_IES & ~GESTURE_BUTTONS) | level;
+	
+	// Next long press, chord or double-click expiry
+	button_gesture_arm();
+	
+	return (pressed & ~sButton.chord);
+}
+
+
+// *************************************************************************************************
+// @fn          button_gesture_event
+// @brief       Queue button event. Every gesture is a separate event in the ring, so presses 
+//				that follow each other quickly are neither merged nor lost.
+// @param       u8 pin			Button pin
+//				u8 event		GESTURE_SHORT, GESTURE_LONG, GESTURE_DOUBLE
+//				u16 stamp		TA0R at edge or gesture timer that completed the gesture
+// @return      none
+// *************************************************************************************************
+void button_gesture_event(u8 pin, u8 event, u16 stamp)
+{
+	u8 button;
+	
+	switch (pin)
 	{
-		// Get data from sensor
-		request.flag.altitude_measurement = 1;
-  	}
-  	
-  	// ---------------------------------------------------
-  	// Safe long button event detection
-  	if(button.flag.star || button.flag.num || button.flag.up || button.flag.down || button.flag.backlight) 
+		case BUTTON_STAR_PIN:	button = BUTTON_STAR;	break;
+		case BUTTON_NUM_PIN:	button = BUTTON_NUM;	break;
+		case BUTTON_UP_PIN:		button = BUTTON_UP;		break;
+		case BUTTON_DOWN_PIN:	button = BUTTON_DOWN;	break;
+		default:				return;
+	}
+	
+	event_push_at(EVENT_BUTTON, button | event, stamp);
+}
+
+
+// *************************************************************************************************
+// @fn          button_gesture_chord
+// @brief       Check if both buttons of a chord are held long enough. A chord is reported once.
+// @param       u8 chord		GESTURE_CHORD_BEEP, GESTURE_CHORD_LOCK
+// @return      u8				1 = report chord now
+// *************************************************************************************************
+u8 button_gesture_chord(u8 chord)
+{
+	u8 i, pin;
+	
+	if ((sButton.chord & sButton.pressed & chord) != chord) return (0);
+	if (sButton.reported & chord) return (0);
+	
+	for (i=0, pin=BIT0; i<BUTTONS_COUNT; i++, pin<<=1)
 	{
-		// Additional debounce delay to enable safe high detection
-		Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_LEFT));
+		if ((chord & pin) && (sButton.held[i] < CONV_MS_TO_TICKS(BUTTONS_LONG_TIME))) return (0);
+	}
 	
-		// Check if this button event is short enough
-		if (BUTTON_STAR_IS_PRESSED) button.flag.star = 0;
-		if (BUTTON_NUM_IS_PRESSED) button.flag.num = 0;	
-		if (BUTTON_UP_IS_PRESSED) button.flag.up = 0;
-		if (BUTTON_DOWN_IS_PRESSED) button.flag.down = 0;	
-		if (BUTTON_BACKLIGHT_IS_PRESSED) button.flag.backlight = 0;
+	sButton.reported |= chord;
+	return (1);
+}
+
 
+// *************************************************************************************************
+// @fn          button_gesture_tick
+// @brief       Detect long presses and chords while buttons are held and let double-click 
+//				candidates expire. Called by Timer0_A4 when one of them is due.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void button_gesture_tick(void)
+{
+	u8 i, pin;
+	u16 stamp;
+	
+	stamp = TA0R;
+	button_gesture_update(stamp);
+	
+	// STAR+UP held: toggle no_beep buttons flag
+	if (button_gesture_chord(GESTURE_CHORD_BEEP))
+	{
+		sys.flag.no_beep = ~sys.flag.no_beep;
+
+		// Show "beep / nobeep" message synchronously with next second tick
+		if (sys.flag.no_beep)	event_push(EVENT_MESSAGE, MESSAGE_NO_BEEP_ON);
+		else					event_push(EVENT_MESSAGE, MESSAGE_NO_BEEP_OFF);
 	}
 	
-	// Reenable PORT2 IRQ
-	__disable_interrupt();
-	BUTTONS_IFG = 0x00; 	
-	BUTTONS_IE  = int_enable; 	
-	__enable_interrupt();
+	// NUM+DOWN held: toggle lock / unlock buttons flag
+	if (button_gesture_chord(GESTURE_CHORD_LOCK))
+	{
+		sys.flag.lock_buttons = ~sys.flag.lock_buttons;
 
-	// Exit from LPM3/LPM4 on RETI
-	__bic_SR_register_on_exit(LPM4_bits); 
+		// Show "buttons are locked/unlocked" message synchronously with next second tick
+		if (sys.flag.lock_buttons)	event_push(EVENT_MESSAGE, MESSAGE_LOCKED);
+		else						event_push(EVENT_MESSAGE, MESSAGE_UNLOCKED);
+	}
+	
+	for (i=0, pin=BIT0; i<BUTTONS_COUNT; i++, pin<<=1)
+	{
+		// Long button press while button is held
+		if ((sButton.pressed & pin) && (((sButton.reported | sButton.chord) & pin) == 0) &&
+		    (sButton.held[i] >= CONV_MS_TO_TICKS(BUTTONS_LONG_TIME)))
+		{
+			button_gesture_event(pin, GESTURE_LONG, stamp);
+			sButton.reported |= pin;
+		}
+		
+		// Second press did not follow within double-click time
+		if ((sButton.clicked & pin) && ((u16)(stamp - sButton.stamp[i]) > CONV_MS_TO_TICKS(BUTTONS_DOUBLE_TIME)))
+		{
+			sButton.clicked &= ~pin;
+		}
+	}
+	
+	button_gesture_arm();
+}
+
+
+// *************************************************************************************************
+// @fn          button_gesture_arm
+// @brief       Start one-shot Timer0_A4 for the nearest long press, chord or double-click expiry, 
+//				so button_gesture_tick() runs at the tick it becomes due. Stop it while no button 
+//				is held and no double-click is pending.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void button_gesture_arm(void)
+{
+	u8 i, pin;
+	u16 now, age, left, next = 0;
+	
+	now = TA0R;
+	
+	for (i=0, pin=BIT0; i<BUTTONS_COUNT; i++, pin<<=1)
+	{
+		age = now - sButton.stamp[i];
+		
+		if ((sButton.pressed & pin) && ((sButton.reported & pin) == 0) && (sButton.held[i] < CONV_MS_TO_TICKS(BUTTONS_LONG_TIME)))
+		{
+			// Button held: becomes long press or part of a held chord
+			left = CONV_MS_TO_TICKS(BUTTONS_LONG_TIME) - sButton.held[i];
+			left = (age >= left) ? 1 : left - age;
+		}
+		else if (sButton.clicked & pin)
+		{
+			// Button released: double-click candidate expires
+			left = (age > CONV_MS_TO_TICKS(BUTTONS_DOUBLE_TIME)) ? 1 : CONV_MS_TO_TICKS(BUTTONS_DOUBLE_TIME) - age + 1;
+		}
+		else
+		{
+			continue;
+		}
+		
+		if ((next == 0) || (left < next)) next = left;
+	}
+	
+	if (next != 0)	Timer0_A4_Start(TIMER0_A4_GESTURE, next, 0, button_gesture_tick);
+	else			Timer0_A4_Stop(TIMER0_A4_GESTURE);
 }
 
 
@@ -386,11 +700,8 @@ void button_repeat_on(u16 msec)
 	// Set button repeat flag
 	sys.flag.up_down_repeat_enabled = 1;
 	
-	// Set Timer0_A3 function pointer to button repeat function
-	fptr_Timer0_A3_function = button_repeat_function;
-	
-	// Timer0_A3 IRQ triggers every 200ms
-	Timer0_A3_Start(CONV_MS_TO_TICKS(msec));
+	// Call button repeat function every "msec" milliseconds
+	Timer0_A4_Start(TIMER0_A4_REPEAT, CONV_MS_TO_TICKS(msec), CONV_MS_TO_TICKS(msec), button_repeat_function);
 }
 
 
@@ -405,8 +716,8 @@ void button_repeat_off(void)
 	// Clear button repeat flag
 	sys.flag.up_down_repeat_enabled = 0;
 	
-	// Timer0_A3 IRQ repeats with 4Hz
-	Timer0_A3_Stop();
+	// Stop button repeat timer
+	Timer0_A4_Stop(TIMER0_A4_REPEAT);
 }
 
 
@@ -428,7 +739,7 @@ void button_repeat_function(void)
 		if (start_delay == 0)
 		{
 			// Generate a virtual button event
-			button.flag.up = 1;
+			event_push(EVENT_BUTTON, BUTTON_UP);
 			repeat = 1;
 		}
 		else
@@ -441,7 +752,7 @@ void button_repeat_function(void)
 		if (start_delay == 0)
 		{
 			// Generate a virtual button event
-			button.flag.down = 1;
+			event_push(EVENT_BUTTON, BUTTON_DOWN);
 			repeat = 1;
 		}
 		else
@@ -466,7 +777,7 @@ void button_repeat_function(void)
 		sButton.repeats++;
 
 		// Reset inactivity detection counter
-		sTime.last_activity = sTime.system_time;
+		sTime.last_activity = Timer0_Seconds();
 		
 		// Disable blinking
 		stop_blink();
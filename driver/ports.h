@@ -75,10 +75,16 @@
 // Button debounce time (msec)
 #define BUTTONS_DEBOUNCE_TIME_IN	(5u)
 #define BUTTONS_DEBOUNCE_TIME_OUT	(250u)
-#define BUTTONS_DEBOUNCE_TIME_LEFT	(50u)
 
-// Detect if STAR / NUM button is held low continuously  
-#define LEFT_BUTTON_LONG_TIME		(1u)
+// Extend debounce time up to this many times while buttons still bounce
+#define BUTTONS_DEBOUNCE_RETRIES	(10u)
+
+// Gesture timing (msec) - measured between PORT2 edge timestamps, must be below 2000 msec
+#define BUTTONS_LONG_TIME			(1000u)		// Button or chord held at least this long is a long press
+#define BUTTONS_DOUBLE_TIME			(400u)		// Max. gap between release and next press of a double-click
+
+// Index of button in gesture engine arrays = bit number of button pin
+#define BUTTONS_COUNT				(5u)
 
 // Backlight time  (sec)
 #define BACKLIGHT_TIME_ON		(3u)
@@ -87,37 +93,39 @@
 #define INACTIVITY_TIME			(30u)
 
 
-// Set of button flags
-typedef union
-{
-  struct
-  {
-  	// Manual button events
-    u16 star    	: 1;    // Short STAR button press
-    u16 num     	: 1;    // Short NUM button press
-    u16 up      	: 1;    // Short UP button press
-    u16 down      	: 1;    // Short DOWN button press
-    u16 backlight  	: 1;    // Short BACKLIGHT button press
-    u16 star_long   	: 1;    // Long STAR button press
-    u16 num_long   	: 1;    // Long NUM button press
-    u16 up_long   	: 1;    // Long UP button press
-    u16 down_long   	: 1;    // Long DOWN button press
-    u16 backlight_long   	: 1;    // Long BACKLIGHT button press
-  } flag;
-  u16 all_flags;            // Shortcut to all display flags (for reset)
-} s_button_flags;
-extern volatile s_button_flags button;
+// Button events - queued as EVENT_BUTTON with button and gesture as argument
+#define BUTTON_STAR					(0x01u)		// Short press
+#define BUTTON_NUM					(0x02u)
+#define BUTTON_UP					(0x03u)
+#define BUTTON_DOWN					(0x04u)
+#define BUTTON_BACKLIGHT			(0x05u)
+#define BUTTON_LONG					(0x10u)		// Added to button: long press
+#define BUTTON_DOUBLE				(0x20u)		// Added to button: double-click, follows its short press
 
 struct struct_button
 {
-	u8  star_timeout;		 
-	u8  num_timeout;
-	u8  up_timeout;		 
-	u8  down_timeout;
-	u8  bbacklight_timeout;		 		 
-	u8 backlight_timeout;
+	// Gesture engine state (button pin bit masks)
+	u8  pressed;			// Debounced button levels
+	u8  reported;			// Held buttons whose long press or chord was already reported
+	u8  chord;				// Held buttons that were part of a chord
+	u8  clicked;			// Buttons whose last release was a short press (double-click candidates)
+	u8  doubled;			// Held buttons that were pressed within double-click time
+	// Edge timestamps (TA0R) and time held (1/32768 sec, saturates at 2 sec)
+	u16 stamp[BUTTONS_COUNT];
+	u16 held[BUTTONS_COUNT];
+	// Asynchronous debounce: buttons with edges, TA0R at first edge, debounce time extensions
+	u8  edges;
+	u16 edge_stamp;
+	u8  bounces;
+#ifdef DEBUG
+	// Longest time spent in button IRQ code (1/32768 sec)
+	u16 latency_max;
+#endif
 	u8 backlight_status;
 	s16 repeats;			
+	// Button event taken from event ring by main loop, 0 = none. Cleared by the code that 
+	// handles it, no further events are taken until then.
+	u8 event;
 };
 extern volatile struct struct_button sButton;
 
@@ -127,6 +135,7 @@ extern void button_repeat_on(u16 msec);
 extern void button_repeat_off(void);
 extern void button_repeat_function(void);
 extern void init_buttons(void);
+extern void button_gesture_tick(void);
 
 
 #endif /*BUTTONS_H_*/
@@ -0,0 +1,271 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Warm reset recovery. A watchdog reset (PUC) leaves RAM and the RTC_A calendar running, a short
+// brown-out (BOR) at least leaves RAM. Instead of starting over at 04:30 the snapshot in no-init
+// RAM is restored, so the watch is back within milliseconds without a time sync.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include <string.h>
+
+// driver
+#include "retain.h"
+#include "rtc.h"
+#include "calendar.h"
+#include "timer.h"
+#ifdef CONFIG_STOP_WATCH
+#include "chrono.h"
+#endif
+
+// logic
+#include "clock.h"
+#include "date.h"
+#ifdef CONFIG_STOP_WATCH
+#include "stopwatch.h"
+#endif
+#ifdef FEATURE_ALTITUDE
+#include "altitude.h"
+#endif
+
+
+// *************************************************************************************************
+// Prototypes section
+void retain_check(void);
+void retain_restore(void);
+void retain_save(void);
+u16 retain_checksum(void);
+
+
+// *************************************************************************************************
+// Defines section
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Not cleared by startup code
+#ifdef __GNUC__
+struct retain sRetain __attribute__((section(".noinit")));
+#else
+__no_init struct retain sRetain;
+#endif
+
+u8 retain_reset;
+
+// Snapshots are taken only after startup has restored or dropped the previous one
+u8 retain_active;
+
+
+// *************************************************************************************************
+// Extern section
+
+
+// *************************************************************************************************
+// @fn          retain_checksum
+// @brief       Sum of all words of the snapshot except the checksum.
+// @param       none
+// @return      u16			Checksum
+// *************************************************************************************************
+u16 retain_checksum(void)
+{
+	u16 * word = (u16 *)&sRetain;
+	u16 sum = 0;
+	
+	while (word < &sRetain.checksum) sum += *word++;
+	
+	return (sum);
+}
+
+
+// *************************************************************************************************
+// @fn          retain_check
+// @brief       Classify reset by all pending SYSRSTIV sources and validate snapshot. Must be called 
+//				before rtc_init(), which stops RTC_A. After a PUC the current RTC_A time is taken 
+//				over, unless a BOR source is pending, too.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void retain_check(void)
+{
+	u16 reset;
+	u8 power_up = 0, bor = 0, puc = 0;
+	u32 now;
+	#ifdef CONFIG_STOP_WATCH
+	u32 elapsed, gap;
+	#endif
+	
+	// Each read returns and clears the highest priority pending source - collect all of them, a 
+	// flag left over from an earlier reset must not hide a later one. BOR sources rank above PUC 
+	// sources.
+	while ((reset = SYSRSTIV) != 0)
+	{
+		if (reset == SYSRSTIV_BOR)			power_up = 1;
+		else if (reset < SYSRSTIV_WDTTO)	bor = 1;
+		else								puc = 1;
+	}
+	
+	retain_reset = RETAIN_COLD;
+	if (power_up || (sRetain.magic != RETAIN_MAGIC) || (sRetain.checksum != retain_checksum())) return;
+	
+	retain_reset = RETAIN_WARM;
+	if (puc && !bor && !(RTCCTL01 & RTCHOLD))
+	{
+		// RTC_A counted through the reset - account for the time since the snapshot
+		rtc_read();
+		now = calendar_now();
+		if (now >= sRetain.seconds)
+		{
+			#ifdef CONFIG_STOP_WATCH
+			// Running stopwatch counted on through the reset - add gap without overflow of u32
+			if (sRetain.stopwatch_state & STOPWATCH_RUN)
+			{
+				elapsed = sRetain.stopwatch_elapsed % STOPWATCH_WRAP_TICKS;
+				gap = ((now - sRetain.seconds) % (STOPWATCH_WRAP_TICKS / 32768)) * 32768;
+				if (elapsed >= STOPWATCH_WRAP_TICKS - gap)	elapsed -= STOPWATCH_WRAP_TICKS - gap;
+				else										elapsed += gap;
+				sRetain.stopwatch_elapsed = elapsed;
+			}
+			#endif
+			
+			sRetain.system_time += now - sRetain.seconds;
+			sRetain.seconds = now;
+			retain_reset = RETAIN_RTC;
+		}
+	}
+}
+
+
+// *************************************************************************************************
+// @fn          retain_restore
+// @brief       Apply snapshot after module defaults have been set. 
+// @param       none
+// @return      none
+// *************************************************************************************************
+void retain_restore(void)
+{
+	struct calendar now;
+	
+	if (retain_reset != RETAIN_COLD)
+	{
+		#ifdef CONFIG_ALARM
+		// Alarm first - setting the clock arms the next alarm
+		memcpy(sAlarm.entry, sRetain.alarm_entry, sizeof(sAlarm.entry));
+		sAlarm.state  = (sRetain.alarm_state == ALARM_DISABLED) ? ALARM_DISABLED : ALARM_ENABLED;
+		sAlarm.hourly = sRetain.alarm_hourly;
+		sAlarm.index  = sRetain.alarm_index;
+		#endif
+		
+		calendar_split(sRetain.seconds, &now);
+		rtc_set_date(now.year, now.month, now.day);
+		rtc_set_time(now.hour, now.minute, now.second);
+		Timer0_Set_Seconds(sRetain.system_time);
+		
+		// Setting the clock drops the sync reference. It is still valid if RTC_A kept counting, 
+		// after a BOR the clock is behind by the time without power.
+		if (retain_reset == RETAIN_RTC)
+		{
+			sRtcDrift.sync_time = sRetain.sync_time;
+			sRtcDrift.synced	= sRetain.synced;
+		}
+		
+		#ifdef CONFIG_STOP_WATCH
+		// Stopwatch continues from the counted time, split view is not kept
+		if (sRetain.stopwatch_state != STOPWATCH_RESET)
+		{
+			sChrono[CHRONO_STOPWATCH].elapsed = sRetain.stopwatch_elapsed % STOPWATCH_WRAP_TICKS;
+			sStopwatch.state = STOPWATCH_STOP;
+			if (sRetain.stopwatch_state & STOPWATCH_RUN) start_stopwatch(Timer0_Ticks());
+		}
+		#endif
+		
+		#ifdef FEATURE_ALTITUDE
+		if (sRetain.pressure != 0) set_altitude_reference(sRetain.altitude, sRetain.pressure, sRetain.temperature);
+		#endif
+	}
+	
+	retain_active = 1;
+	retain_save();
+}
+
+
+// *************************************************************************************************
+// @fn          retain_save
+// @brief       Take snapshot. Called every minute by RTC_ISR and when retained state changes.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void retain_save(void)
+{
+	istate_t int_state;
+	
+	if (!retain_active) return;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	rtc_read();
+	sRetain.magic		= RETAIN_MAGIC;
+	sRetain.seconds		= calendar_now();
+	sRetain.system_time	= Timer0_Seconds();
+	sRetain.sync_time	= sRtcDrift.sync_time;
+	sRetain.synced		= sRtcDrift.synced;
+	
+	#ifdef CONFIG_STOP_WATCH
+	sRetain.stopwatch_elapsed = stopwatch_elapsed_at(Timer0_Ticks());
+	sRetain.stopwatch_state	  = sStopwatch.state;
+	#endif
+	
+	#ifdef CONFIG_ALARM
+	memcpy(sRetain.alarm_entry, sAlarm.entry, sizeof(sAlarm.entry));
+	sRetain.alarm_state	 = sAlarm.state;
+	sRetain.alarm_hourly = sAlarm.hourly;
+	sRetain.alarm_index	 = sAlarm.index;
+	#endif
+	
+	#ifdef FEATURE_ALTITUDE
+	sRetain.altitude	= sAlt.ref_altitude;
+	sRetain.pressure	= sAlt.ref_pressure;
+	sRetain.temperature	= sAlt.ref_temperature;
+	#endif
+	
+	sRetain.checksum = retain_checksum();
+	
+	__set_interrupt_state(int_state);
+}
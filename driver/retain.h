@@ -0,0 +1,117 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// State kept in no-init RAM over warm resets (watchdog, brown-out). A snapshot of wall clock time,
+// system time, stopwatch, alarms and altitude reference is taken every minute and on changes, and
+// is restored at startup instead of the defaults if its checksum is intact.
+// *************************************************************************************************
+
+#ifndef RETAIN_H_
+#define RETAIN_H_
+
+
+// *************************************************************************************************
+// Include section
+#ifdef CONFIG_ALARM
+#include "alarm.h"
+#endif
+
+
+// *************************************************************************************************
+// Defines section
+
+// Startup after ...
+#define RETAIN_COLD							(0u)		// power-up or lost RAM - use defaults
+#define RETAIN_WARM							(1u)		// BOR with intact RAM - time of last snapshot
+#define RETAIN_RTC							(2u)		// PUC - RTC_A kept counting
+
+// Identifies a snapshot written by this firmware layout
+#define RETAIN_MAGIC						(0x5AC3u ^ sizeof(struct retain))
+
+
+// *************************************************************************************************
+// Global Variable section
+struct retain
+{
+	u16		magic;
+	
+	// Wall clock time (seconds since calendar epoch) and system time at the same moment
+	u32		seconds;
+	u32		system_time;
+	
+	// Reference of crystal drift learning, see struct rtc_drift
+	u32		sync_time;
+	u8		synced;
+	
+#ifdef CONFIG_STOP_WATCH
+	// Counted time and state of stopwatch
+	u32		stopwatch_elapsed;
+	u8		stopwatch_state;
+#endif
+
+#ifdef CONFIG_ALARM
+	struct alarm_entry	alarm_entry[ALARM_ENTRIES];
+	u8		alarm_state;
+	u8		alarm_hourly;
+	u8		alarm_index;
+#endif
+
+#ifdef FEATURE_ALTITUDE
+	// Reference point of pressure table
+	s16		altitude;
+	u32		pressure;
+	u16		temperature;
+#endif
+	
+	// Sum of all words above
+	u16		checksum;
+};
+extern struct retain sRetain;
+
+// RETAIN_COLD, RETAIN_WARM, RETAIN_RTC
+extern u8 retain_reset;
+
+
+// *************************************************************************************************
+// Prototypes section
+extern void retain_check(void);
+extern void retain_restore(void);
+extern void retain_save(void);
+
+
+// *************************************************************************************************
+// Extern section
+
+
+#endif /*RETAIN_H_*/
@@ -0,0 +1,531 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// RTC_A calendar. Keeps wall clock time and date in hardware and wakes up the CPU only when the 
+// minute changes or the alarm time matches. sTime and sDate are views of the RTC registers.
+// The crystal error is learned from successive time syncs and corrected by RTC_A calibration,
+// together with the temperature dependency of the crystal.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "rtc.h"
+#include "timer.h"
+#include "calendar.h"
+#include "event.h"
+#include "retain.h"
+#include "display.h"
+#ifdef CONFIG_INFOMEM
+#include "infomem.h"
+#endif
+
+// logic
+#include "clock.h"
+#include "date.h"
+#ifdef CONFIG_ALARM
+#include "alarm.h"
+#endif
+
+
+// *************************************************************************************************
+// Prototypes section
+void rtc_init(void);
+u8 rtc_read(void);
+u32 rtc_seconds(u16 * fraction);
+void rtc_set_time(u8 hour, u8 minute, u8 second);
+void rtc_set_date(u16 year, u8 month, u8 day);
+void rtc_set_alarm(u8 day, u8 hour, u8 minute);
+void rtc_disable_alarm(void);
+void rtc_sync_time(u8 hour, u8 minute, u8 second);
+void rtc_set_drift(s16 ppm);
+s16 rtc_drift_learn(s16 ppm, s32 error, u32 interval);
+u8 rtc_cal_register(s16 ppm);
+void rtc_load_drift(void);
+void rtc_set_temperature(s16 degrees);
+void rtc_calibrate(void);
+
+
+// *************************************************************************************************
+// Defines section
+
+
+// *************************************************************************************************
+// Global Variable section
+struct rtc_drift sRtcDrift;
+
+
+// *************************************************************************************************
+// Extern section
+
+
+// *************************************************************************************************
+// @fn          rtc_init
+// @brief       Set RTC_A to calendar mode. Clock source is the 32kHz crystal (ACLK).
+//				RTC is kept on hold until time and date have been set.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_init(void)
+{
+	// Calendar mode, binary format, event when minute changes, enable minute and alarm IRQ
+	RTCCTL01 = RTCHOLD + RTCMODE + RTCTEV_0 + RTCTEVIE + RTCAIE;
+	
+	// No alarm until alarm time is set
+	rtc_disable_alarm();
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_read
+// @brief       Copy RTC registers to sTime and sDate. Sets sTime.drawFlag according to the values 
+//				that changed since the last read.
+// @param       none
+// @return      u8		1 = date changed since the last read
+// *************************************************************************************************
+u8 rtc_read(void)
+{
+	u8 second, minute, hour, day, month;
+	u16 year;
+	u8 changed;
+	
+	// Registers can change while they are read - repeat until seconds are unchanged
+	do
+	{
+		second 	= RTCSEC;
+		minute 	= RTCMIN;
+		hour 	= RTCHOUR;
+		day 	= RTCDAY;
+		month 	= RTCMON;
+		year 	= RTCYEAR;
+	}
+	while (second != RTCSEC);
+	
+	// Use sTime.drawFlag to minimize display updates
+	// sTime.drawFlag = 1: second
+	// sTime.drawFlag = 2: minute, second
+	// sTime.drawFlag = 3: hour, minute
+	// Flag is cleared by display_time(), so keep highest pending value
+	if (hour != sTime.hour)										sTime.drawFlag = 3;
+	else if ((minute != sTime.minute) && (sTime.drawFlag < 2))	sTime.drawFlag = 2;
+	else if (sTime.drawFlag == 0)								sTime.drawFlag = 1;
+	
+	sTime.hour   = hour;
+	sTime.minute = minute;
+	sTime.second = second;
+	
+	// Caller requests date update of display
+	changed = (day != sDate.day);
+	
+	sDate.day   = day;
+	sDate.month = month;
+	sDate.year  = year;
+	
+	return (changed);
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_seconds
+// @brief       Read RTC calendar and prescaler as one time stamp. In calendar mode the 15 lower
+//				bits of the prescaler count 1/32768 sec within the current second.
+// @param       u16 * fraction	1/32768 sec since start of second, 0 = not needed
+// @return      u32				Seconds since calendar epoch, time of day only if the date
+//								has not been set yet
+// *************************************************************************************************
+u32 rtc_seconds(u16 * fraction)
+{
+	u8 second, minute, hour, day, month;
+	u16 year, prescaler;
+	
+	// Registers can change while they are read - repeat until seconds are unchanged
+	do
+	{
+		second 	= RTCSEC;
+		minute 	= RTCMIN;
+		hour 	= RTCHOUR;
+		day 	= RTCDAY;
+		month 	= RTCMON;
+		year 	= RTCYEAR;
+	
+		// Prescaler is clocked by ACLK - repeat until read is stable
+		do prescaler = RTCPS; while (prescaler != RTCPS);
+	}
+	while (second != RTCSEC);
+	
+	if (fraction != 0) *fraction = prescaler & 0x7FFF;
+	
+	// Date registers are undefined after power-up
+	if ((year < CALENDAR_EPOCH_YEAR) || (year > CALENDAR_LAST_YEAR) || (month < 1) || (month > 12) || (day < 1))
+	{
+		return ((u32)(hour * 60u + minute) * 60u + second);
+	}
+	
+	return (calendar_seconds(year, month, day, hour, minute, second));
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_set_time
+// @brief       Set RTC time and update sTime.
+// @param       u8 hour			0 .. 23
+//				u8 minute		0 .. 59
+//				u8 second		0 .. 59
+// @return      none
+// *************************************************************************************************
+void rtc_set_time(u8 hour, u8 minute, u8 second)
+{
+	istate_t int_state;
+	u32 seconds;
+	
+	// System time must not jump when RTC is set - nobody may read it in between
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	seconds = Timer0_Seconds();
+	
+	// Stop RTC while time registers are written
+	RTCCTL01 |= RTCHOLD;
+	RTCHOUR = hour;
+	RTCMIN  = minute;
+	RTCSEC  = second;
+	RTCCTL01 &= ~RTCHOLD;
+	
+	Timer0_Set_Seconds(seconds);
+	__set_interrupt_state(int_state);
+		
+	rtc_read();
+	sTime.drawFlag = 3;
+	
+	// Time error since last sync is unknown now
+	sRtcDrift.synced = 0;
+	
+	#ifdef CONFIG_ALARM
+	// Next alarm is relative to current time
+	alarm_schedule();
+	#endif
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_set_date
+// @brief       Set RTC date and update sDate.
+// @param       u16 year		e.g. 2010
+//				u8 month		1 .. 12
+//				u8 day			1 .. 31
+// @return      none
+// *************************************************************************************************
+void rtc_set_date(u16 year, u8 month, u8 day)
+{
+	istate_t int_state;
+	u32 seconds;
+	
+	// System time must not jump when RTC is set - nobody may read it in between
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	seconds = Timer0_Seconds();
+	
+	// Stop RTC while date registers are written
+	RTCCTL01 |= RTCHOLD;
+	RTCYEAR = year;
+	RTCMON  = month;
+	RTCDAY  = day;
+	RTCCTL01 &= ~RTCHOLD;
+	
+	Timer0_Set_Seconds(seconds);
+	__set_interrupt_state(int_state);
+		
+	rtc_read();
+	display.flag.update_date = 1;
+	
+	#ifdef CONFIG_ALARM
+	alarm_schedule();
+	#endif
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_set_alarm
+// @brief       Set alarm date and time. RTC IRQ is asserted when day of month, hour and minute match.
+// @param       u8 day			1 .. 31
+//				u8 hour			0 .. 23
+//				u8 minute		0 .. 59
+// @return      none
+// *************************************************************************************************
+void rtc_set_alarm(u8 day, u8 hour, u8 minute)
+{
+	// Disable alarm while alarm registers are written
+	RTCCTL01 &= ~RTCAIE;
+	
+	RTCAMIN  = minute | RTCAE;
+	RTCAHOUR = hour | RTCAE;
+	RTCADOW  = 0;
+	RTCADAY  = day | RTCAE;
+	
+	// Reset IRQ flag and enable alarm
+	RTCCTL01 &= ~RTCAIFG;
+	RTCCTL01 |= RTCAIE;
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_disable_alarm
+// @brief       Disable alarm time match.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_disable_alarm(void)
+{
+	RTCAMIN  = 0;
+	RTCAHOUR = 0;
+	RTCADOW  = 0;
+	RTCADAY  = 0;
+	RTCCTL01 &= ~RTCAIFG;
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_sync_time
+// @brief       Set RTC time from a reference clock (sync with access point). The time error 
+//				accumulated since the previous sync is used to refine the crystal calibration.
+// @param       u8 hour			0 .. 23
+//				u8 minute		0 .. 59
+//				u8 second		0 .. 59
+// @return      none
+// *************************************************************************************************
+void rtc_sync_time(u8 hour, u8 minute, u8 second)
+{
+	u32 interval;
+	s32 error;
+	
+	rtc_read();
+	interval = Timer0_Seconds() - sRtcDrift.sync_time;
+	
+	if (sRtcDrift.synced && (interval >= RTC_DRIFT_MIN_INTERVAL))
+	{
+		// Time error of watch in seconds, wrapped to +/-12h (date is set separately)
+		error = ((s32)sTime.hour - hour) * 3600 + ((s32)sTime.minute - minute) * 60 + ((s32)sTime.second - second);
+		if (error >= 12l*3600l) error -= 24l*3600l;
+		if (error < -12l*3600l) error += 24l*3600l;
+		
+		if ((error <= RTC_DRIFT_MAX_ERROR) && (error >= -RTC_DRIFT_MAX_ERROR))
+		{
+			rtc_set_drift(rtc_drift_learn(sRtcDrift.ppm, error, interval));
+			
+			#ifdef CONFIG_INFOMEM
+			// Keep calibration over battery change
+			infomem_app_replace(RTC_DRIFT_INFOMEM_ID, (u16 *)&sRtcDrift.ppm, 1);
+			#endif
+		}
+	}
+	
+	rtc_set_time(hour, minute, second);
+	
+	// New reference for next sync
+	sRtcDrift.sync_time = Timer0_Seconds();
+	sRtcDrift.synced = 1;
+	
+	// Keep reference over warm reset
+	retain_save();
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_drift_learn
+// @brief       Refine crystal error with the time error seen at a sync. The remaining drift adds 
+//				to the current calibration, but only half way to damp the 1 sec resolution of 
+//				both clocks.
+// @param       s16 ppm			Current crystal error in ppm
+//				s32 error		Time error of watch in seconds (> 0: watch is ahead), 
+//								|error| <= RTC_DRIFT_MAX_ERROR
+//				u32 interval	Seconds since previous sync, >= RTC_DRIFT_MIN_INTERVAL
+// @return      s16				New crystal error in ppm, not limited
+// *************************************************************************************************
+s16 rtc_drift_learn(s16 ppm, s32 error, u32 interval)
+{
+	return (ppm + (s16)((error * 1000000l) / (s32)interval) / 2);
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_set_drift
+// @brief       Correct crystal error by RTC_A calibration. RTC_A spreads the correction by 
+//				adding or removing single ticks over each minute.
+// @param       s16 ppm			Crystal error in ppm (> 0: crystal runs fast)
+// @return      none
+// *************************************************************************************************
+void rtc_set_drift(s16 ppm)
+{
+	if (ppm > RTC_DRIFT_PPM_MAX) ppm = RTC_DRIFT_PPM_MAX;
+	if (ppm < RTC_DRIFT_PPM_MIN) ppm = RTC_DRIFT_PPM_MIN;
+	sRtcDrift.ppm = ppm;
+	
+	rtc_calibrate();
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_set_temperature
+// @brief       Compensate temperature dependency of the crystal. Frequency of a tuning fork 
+//				crystal drops with the square of the distance to its turnover temperature.
+// @param       s16 degrees		Temperature in 0.1 degC steps
+// @return      none
+// *************************************************************************************************
+void rtc_set_temperature(s16 degrees)
+{
+	s32 delta = (s32)degrees - RTC_TEMP_TURNOVER;
+	
+	// Coefficient is in 0.001 ppm/K^2, temperature in 0.1 K
+	sRtcDrift.temp_ppm = (s16)(-(RTC_TEMP_COEFF * delta * delta) / 100000l);
+	
+	rtc_calibrate();
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_calibrate
+// @brief       Load RTC_A calibration with learned and temperature dependent crystal error.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_calibrate(void)
+{
+	RTCCTL2 = rtc_cal_register(sRtcDrift.ppm + sRtcDrift.temp_ppm);
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_cal_register
+// @brief       RTC_A calibration for a crystal error, rounded to the nearest calibration step.
+// @param       s16 ppm			Crystal error in ppm (> 0: crystal runs fast)
+// @return      u8				RTCCTL2 value
+// *************************************************************************************************
+u8 rtc_cal_register(s16 ppm)
+{
+	if (ppm > RTC_DRIFT_PPM_MAX) ppm = RTC_DRIFT_PPM_MAX;
+	if (ppm < RTC_DRIFT_PPM_MIN) ppm = RTC_DRIFT_PPM_MIN;
+	
+	// Fast crystal: slow down in steps of 2 ppm, slow crystal: speed up in steps of 4 ppm
+	if (ppm >= 0)	return ((ppm + 1) / 2);
+	else			return (RTCCALS + (2 - ppm) / 4);
+}
+
+
+// *************************************************************************************************
+// @fn          rtc_load_drift
+// @brief       Restore crystal calibration from information memory.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_load_drift(void)
+{
+	s16 ppm = 0;
+	
+	#ifdef CONFIG_INFOMEM
+	if (infomem_app_amount(RTC_DRIFT_INFOMEM_ID) >= 1)
+	{
+		infomem_app_read(RTC_DRIFT_INFOMEM_ID, (u16 *)&ppm, 1, 0);
+	}
+	#endif
+	
+	rtc_set_drift(ppm);
+	sRtcDrift.synced = 0;
+}
+
+
+// *************************************************************************************************
+// @fn          RTC_ISR
+// @brief       IRQ handler for RTC_A. 
+//				Minute changed: refresh sTime / sDate and service modules that require 1/min processing
+//				Alarm: hour and minute match alarm time
+// @param       none
+// @return      none
+// *************************************************************************************************
+//pfs 
+#ifdef __GNUC__
+#include <signal.h>
+interrupt (RTC_VECTOR) RTC_ISR(void)
+#else
+#pragma vector = RTC_VECTOR
+__interrupt void RTC_ISR(void)
+#endif
+{
+	switch (RTCIV)
+	{
+		// Minute changed
+		case RTC_IV_MINUTE:	
+					// Request clock and date update of display
+					if (rtc_read()) event_push_level(EVENT_DATE);
+					event_push_level(EVENT_TIME);
+	
+					// Deadlines more than a minute ahead are left to this IRQ
+					Timer0_A0_Program();
+	
+					// Keep time for warm reset
+					retain_save();
+					
+					#ifdef CONFIG_BATTERY
+					// Measure battery voltage to keep track of remaining battery life
+					event_push(EVENT_VOLTAGE, 0);
+					#endif
+					
+					// Sample temperature for crystal compensation. One conversion takes less
+					// than 1ms, so the average current is far below that of the clock itself.
+					if ((sTime.minute % RTC_TEMP_INTERVAL) == 0) event_push(EVENT_TEMPERATURE, FILTER_OFF);
+					
+					#ifdef CONFIG_ALARM
+					// If the chime is enabled, we beep here
+					if ((sTime.minute == 0) && (sAlarm.hourly == ALARM_ENABLED)) 
+					{
+						event_push(EVENT_BUZZER, 0);
+					}
+					#endif
+					break;
+					
+		// Alarm time matched
+		case RTC_IV_ALARM:
+					#ifdef CONFIG_ALARM
+					// Ring and arm next alarm outside ISR
+					event_push(EVENT_ALARM, 0);
+					#endif
+					break;
+	}
+	
+	// Exit from LPM3 on RETI
+	_BIC_SR_IRQ(LPM3_bits);               
+}
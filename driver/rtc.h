@@ -0,0 +1,103 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+
+#ifndef RTC_H_
+#define RTC_H_
+
+
+// *************************************************************************************************
+// Include section
+
+
+// *************************************************************************************************
+// Prototypes section
+extern void rtc_init(void);
+extern u8 rtc_read(void);
+extern u32 rtc_seconds(u16 * fraction);
+extern void rtc_set_time(u8 hour, u8 minute, u8 second);
+extern void rtc_set_date(u16 year, u8 month, u8 day);
+extern void rtc_set_alarm(u8 day, u8 hour, u8 minute);
+extern void rtc_disable_alarm(void);
+extern void rtc_sync_time(u8 hour, u8 minute, u8 second);
+extern void rtc_set_drift(s16 ppm);
+extern s16 rtc_drift_learn(s16 ppm, s32 error, u32 interval);
+extern u8 rtc_cal_register(s16 ppm);
+extern void rtc_load_drift(void);
+extern void rtc_set_temperature(s16 degrees);
+
+
+// *************************************************************************************************
+// Defines section
+
+// RTCIV values
+#define RTC_IV_MINUTE						(0x04)		// RTCTEVIFG - minute changed
+#define RTC_IV_ALARM						(0x06)		// RTCAIFG - alarm time matched
+
+// Crystal drift calibration
+#define RTC_DRIFT_MIN_INTERVAL				(6ul*3600ul)	// Minimum seconds between syncs to learn drift
+#define RTC_DRIFT_MAX_ERROR					(300)		// Larger time errors are time changes, not drift
+#define RTC_DRIFT_PPM_MAX					(126)		// Fast crystal: 63 RTCCAL steps of -2 ppm
+#define RTC_DRIFT_PPM_MIN					(-252)		// Slow crystal: 63 RTCCAL steps of +4 ppm
+#define RTC_DRIFT_INFOMEM_ID				(0x11)
+
+// Temperature compensation of 32kHz tuning fork crystal: 
+// ppm = -RTC_TEMP_COEFF/1000 * (T - RTC_TEMP_TURNOVER)^2
+#define RTC_TEMP_COEFF						(34l)		// 0.034 ppm/K^2
+#define RTC_TEMP_TURNOVER					(250)		// 25.0 degC in 0.1 degC steps
+#define RTC_TEMP_INTERVAL					(10u)		// Background temperature sample every 10 minutes
+
+
+// *************************************************************************************************
+// Global Variable section
+struct rtc_drift
+{
+	// Learned crystal error in ppm (> 0: crystal runs fast)
+	s16		ppm;
+	
+	// Crystal error caused by temperature in ppm
+	s16		temp_ppm;
+	
+	// System time of last time sync, valid if synced is set
+	u32		sync_time;
+	u8		synced;
+};
+extern struct rtc_drift sRtcDrift;
+
+
+// *************************************************************************************************
+// Extern section
+
+
+#endif /*RTC_H_*/
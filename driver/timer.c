@@ -44,6 +44,7 @@
 
 // driver
 #include "timer.h"
+#include "event.h"
 #include "ports.h"
 #include "buzzer.h"
 #include "vti_ps.h"
@@ -51,6 +52,7 @@
 #include "vti_as.h"
 #endif
 #include "display.h"
+#include "chrono.h"
 
 // logic
 #include "clock.h"
@@ -59,6 +61,7 @@
 #include "alarm.h"
 #include "altitude.h"
 #include "display.h"
+#include "rtc.h"
 #include "rfsimpliciti.h"
 #include "simpliciti.h"
 #ifdef FEATURE_PROVIDE_ACCEL
@@ -76,24 +79,36 @@
 #include "eggtimer.h"
 #endif
 
-#ifdef CONFIG_SIDEREAL
-#include "sidereal.h"
-#endif
-
 #ifdef CONFIG_STRENGTH
 #include "strength.h"
 #endif
 
+#include "menu.h"
+
 // *************************************************************************************************
 // Prototypes section
 void Timer0_Init(void);
 void Timer0_Stop(void);
 void Timer0_A1_Start(u16 ticks);
 void Timer0_A1_Stop(void);
-void Timer0_A3_Start(u16 ticks);
-void Timer0_A3_Stop(void);
 void Timer0_A4_Delay(u16 ticks);
-void (*fptr_Timer0_A3_function)(void);
+u8 Timer0_A4_Wait(u16 ticks, u8 (*ready)(void));
+void Timer0_A4_Delay_Over(void);
+void Timer0_A4_Start(u8 timer, u16 ticks, u16 period, void (*fptr)(void));
+void Timer0_A4_Stop(u8 timer);
+u8 Timer0_A4_Is_Active(u8 timer);
+void Timer0_A4_Program(void);
+void Timer0_A0_Schedule(u8 slot, u32 seconds);
+void Timer0_A0_Cancel(u8 slot);
+u8 Timer0_A0_Is_Scheduled(u8 slot);
+void Timer0_A0_Keep(u8 slot, u32 seconds);
+void Timer0_A0_Refresh(void);
+void Timer0_A0_Program(void);
+void Timer0_Now(struct timestamp * ts);
+u32 Timer0_Seconds(void);
+void Timer0_Set_Seconds(u32 seconds);
+u32 Timer0_Ticks(void);
+u32 Timer0_Ticks_At(u16 stamp);
 #ifdef CONFIG_USE_GPS
 void (*fptr_Timer0_A1_function)(void);
 #endif
@@ -114,20 +129,18 @@ extern void to_lpm(void);
 
 // *************************************************************************************************
 // @fn          Timer0_Init
-// @brief       Set Timer0 to a period of 1 or 2 sec. IRQ TACCR0 is asserted when timer overflows.
+// @brief       Start Timer0 in continuous mode. TACCR0 IRQ is only enabled while a deadline slot
+//				is armed, the clock itself is kept by RTC_A.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void Timer0_Init(void)
 {
-	// Set interrupt frequency to 1Hz
-	TA0CCR0   = 32768 - 1;                
-
-	// Enable timer interrupt    
-	TA0CCTL0 |= CCIE;                     
+	// No deadline armed yet
+	TA0CCTL0 &= ~CCIE;
 
 	// Clear and start timer now   
-	// Continuous mode: Count to 0xFFFF and restart from 0 again - 1sec timing will be generated by ISR
+	// Continuous mode: Count to 0xFFFF and restart from 0 again - CCRx are loaded relative to TA0R
 	TA0CTL   |= TASSEL0 + MC1 + TACLR;                       
 }
 
@@ -198,43 +211,106 @@ void Timer0_A1_Stop(void)
 
 
 // *************************************************************************************************
-// @fn          Timer0_A3_Start
-// @brief       Trigger IRQ every "ticks" microseconds
-// @param       ticks (1 tick = 1/32768 sec)
+// @fn          Timer0_A4_Start
+// @brief       Arm a software timer. All timers share CCR4, which is always loaded with the 
+//				nearest pending expiry. The callback is called from IRQ context and may rearm 
+//				or stop any timer. Can be used inside other ISRs.
+// @param       u8 timer		TIMER0_A4_DELAY .. TIMER0_A4_GESTURE
+//				u16 ticks		Delay to first expiry (1 tick = 1/32768 sec)
+//				u16 period		Delay between following expiries, 0 = one-shot timer
+//				fptr			Function called on expiry
 // @return      none
 // *************************************************************************************************
-void Timer0_A3_Start(u16 ticks)
+void Timer0_A4_Start(u8 timer, u16 ticks, u16 period, void (*fptr)(void))
 {
-	u16 value;
+	istate_t int_state;
 	
-	// Store timer ticks in global variable
-	sTimer.timer0_A3_ticks = ticks;
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
 	
-	// Delay based on current counter value
-	value = TA0R + ticks;
+	sTimer.timer0_A4_start[timer]    = TA0R;
+	sTimer.timer0_A4_ticks[timer]    = ticks;
+	sTimer.timer0_A4_period[timer]   = period;
+	sTimer.timer0_A4_function[timer] = fptr;
+	sTimer.timer0_A4_active |= BIT0 << timer;
+	Timer0_A4_Program();
 	
-	// Update CCR
-	TA0CCR3 = value;   
+	__set_interrupt_state(int_state);
+}
 
-	// Reset IRQ flag    
-	TA0CCTL3 &= ~CCIFG; 
-	          
-	// Enable timer interrupt    
-	TA0CCTL3 |= CCIE; 
+
+// *************************************************************************************************
+// @fn          Timer0_A4_Stop
+// @brief       Disarm a software timer. Its callback is not called anymore.
+// @param       u8 timer		TIMER0_A4_DELAY .. TIMER0_A4_GESTURE
+// @return      none
+// *************************************************************************************************
+void Timer0_A4_Stop(u8 timer)
+{
+	istate_t int_state;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	sTimer.timer0_A4_active &= ~(BIT0 << timer);
+	Timer0_A4_Program();
+	
+	__set_interrupt_state(int_state);
 }
 
 
+// *************************************************************************************************
+// @fn          Timer0_A4_Is_Active
+// @brief       Check if a software timer is armed.
+// @param       u8 timer		TIMER0_A4_DELAY .. TIMER0_A4_GESTURE
+// @return      u8				1 = timer will expire, 0 = timer is stopped
+// *************************************************************************************************
+u8 Timer0_A4_Is_Active(u8 timer)
+{
+	return ((sTimer.timer0_A4_active & (BIT0 << timer)) != 0);
+}
+
 
 // *************************************************************************************************
-// @fn          Timer0_A3_Stop
-// @brief       Stop Timer0_A3.
+// @fn          Timer0_A4_Program
+// @brief       Load CCR4 with the nearest expiry of all active software timers. 
+//				Must be called with interrupts disabled.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void Timer0_A3_Stop(void)
+void Timer0_A4_Program(void)
 {
-	// Clear timer interrupt    
-	TA0CCTL3 &= ~CCIE; 
+	u8 i;
+	u16 now, elapsed, remain;
+	u16 next = 0xFFFF;
+	
+	// Disable timer interrupt    
+	TA0CCTL4 &= ~CCIE; 	
+	
+	if (sTimer.timer0_A4_active == 0) return;
+	
+	now = TA0R;
+	for (i=0; i<TIMER0_A4_CHANNELS; i++)
+	{
+		if ((sTimer.timer0_A4_active & (BIT0 << i)) == 0) continue;
+		
+		elapsed = now - sTimer.timer0_A4_start[i];
+		if (elapsed >= sTimer.timer0_A4_ticks[i])	remain = 0;
+		else										remain = sTimer.timer0_A4_ticks[i] - elapsed;
+		if (remain < next) next = remain;
+	}
+	
+	// Update CCR
+	TA0CCR4 = now + next;   
+
+	// Reset IRQ flag    
+	TA0CCTL4 &= ~CCIFG; 
+	
+	// Expiry already passed while CCR was loaded - request IRQ now
+	if ((u16)(TA0R - now) >= next) TA0CCTL4 |= CCIFG;
+	          
+	// Enable timer interrupt    
+	TA0CCTL4 |= CCIE; 
 }
 
 
@@ -246,59 +322,385 @@ void Timer0_A3_Stop(void)
 // *************************************************************************************************
 void Timer0_A4_Delay(u16 ticks)
 {
-	u16 value;
+	Timer0_A4_Wait(ticks, 0);
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_A4_Wait
+// @brief       Wait in LPM3 until a condition is met or a timeout is over. The condition is 
+//				checked after every wake-up, so the event it waits for must exit LPM3 by an IRQ.
+// @param       u16 ticks				Timeout (1 tick = 1/32768 sec)
+//				u8 (*ready)(void)		Condition, 0 = wait for timeout only
+// @return      u8						1 = condition met, 0 = timeout
+// *************************************************************************************************
+u8 Timer0_A4_Wait(u16 ticks, u8 (*ready)(void))
+{
+	u8 met = 0;
 	
 	// Exit immediately if Timer0 not running - otherwise we'll get stuck here
-	if ((TA0CTL & (BIT4 | BIT5)) == 0) return;    
-
-	// Disable timer interrupt    
-	TA0CCTL4 &= ~CCIE; 	
+	if ((TA0CTL & (BIT4 | BIT5)) == 0) return ((ready != 0) && ready());    
 
 	// Clear delay_over flag
 	sys.flag.delay_over = 0;
 	
 	// Add delay to current timer value
-	value = TA0R + ticks;
-	
-	// Update CCR
-	TA0CCR4 = value;   
-
-	// Reset IRQ flag    
-	TA0CCTL4 &= ~CCIFG; 
-	          
-	// Enable timer interrupt    
-	TA0CCTL4 |= CCIE; 
+	Timer0_A4_Start(TIMER0_A4_DELAY, ticks, 0, Timer0_A4_Delay_Over);
 	
 	// Wait for timer IRQ
 	while (1)
 	{
-		// Delay in LPM
+		// Check condition with IRQs off, so an IRQ in between cannot be missed before LPM entry
+		__disable_interrupt();
+		if ((ready != 0) && ready()) 
+		{
+			met = 1;
+			break;
+		}
+		
+		// Check stop condition
+		if (sys.flag.delay_over) break;
+		
+		// Delay in LPM, enables IRQs
 		to_lpm();
 
 #ifdef USE_WATCHDOG		
 		// Service watchdog
-		WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
+		WDTCTL = WDTPW + WDTIS__8192K + WDTSSEL__ACLK + WDTCNTCL;
 #endif
 #ifdef CONFIG_STOP_WATCH
 		// Redraw stopwatch display
 		if (is_stopwatch_run()) display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_PARTIAL);
 #endif
+	}
+	__enable_interrupt();
+	
+	// Timeout not needed any more
+	Timer0_A4_Stop(TIMER0_A4_DELAY);
+	
+	return (met);
+}
 
-		// Check stop condition
-		if (sys.flag.delay_over) break;
+
+// *************************************************************************************************
+// @fn          Timer0_A4_Delay_Over
+// @brief       Expiry of Timer0_A4_Delay. Wakes up main loop.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void Timer0_A4_Delay_Over(void)
+{
+	// Set delay over flag
+	sys.flag.delay_over = 1;
+}
+
+
+
+// *************************************************************************************************
+// @fn          Timer0_A0_Schedule
+// @brief       Arm a deadline slot of TIMER0_A0_ISR. Slots are kept in a queue sorted by due
+//				second, so the ISR only needs to check the head of the queue.
+// @param       u8 slot			TICK_DISPLAY .. TICK_CHRONO
+//				u32 seconds		Delay in seconds from current system time (>= 1)
+// @return      none
+// *************************************************************************************************
+void Timer0_A0_Schedule(u8 slot, u32 seconds)
+{
+	istate_t int_state;
+	u32 due;
+	u8 i;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	// Remove slot from queue if it is already armed
+	Timer0_A0_Cancel(slot);
+	
+	due = Timer0_Seconds() + seconds;
+	sTimer.tick_due[slot] = due;
+	
+	// Insert slot behind all slots that are due earlier or at the same second
+	i = sTimer.tick_queued;
+	while ((i > 0) && ((s32)(sTimer.tick_due[sTimer.tick_queue[i-1]] - due) > 0))
+	{
+		sTimer.tick_queue[i] = sTimer.tick_queue[i-1];
+		i--;
 	}
+	sTimer.tick_queue[i] = slot;
+	sTimer.tick_queued++;
+	sTimer.tick_armed |= TICK_BIT(slot);
+	
+	// New head of queue: CCR0 must match earlier
+	if (i == 0) Timer0_A0_Program();
+	
+	__set_interrupt_state(int_state);
 }
 
 
+// *************************************************************************************************
+// @fn          Timer0_A0_Cancel
+// @brief       Remove a deadline slot from the queue of TIMER0_A0_ISR.
+// @param       u8 slot			TICK_DISPLAY .. TICK_CHRONO
+// @return      none
+// *************************************************************************************************
+void Timer0_A0_Cancel(u8 slot)
+{
+	istate_t int_state;
+	u8 i, j, head;
+	
+	if ((sTimer.tick_armed & TICK_BIT(slot)) == 0) return;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	head = (sTimer.tick_queue[0] == slot);
+	
+	// Close gap in queue
+	for (i=0, j=0; i<sTimer.tick_queued; i++)
+	{
+		if (sTimer.tick_queue[i] != slot) sTimer.tick_queue[j++] = sTimer.tick_queue[i];
+	}
+	sTimer.tick_queued = j;
+	sTimer.tick_armed &= ~TICK_BIT(slot);
+	
+	// Head of queue removed: next deadline is later, or CCR0 is not needed anymore
+	if (head) Timer0_A0_Program();
+	
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_A0_Is_Scheduled
+// @brief       Check if a deadline slot is armed.
+// @param       u8 slot			TICK_DISPLAY .. TICK_CHRONO
+// @return      u8				1 = slot is armed
+// *************************************************************************************************
+u8 Timer0_A0_Is_Scheduled(u8 slot)
+{
+	return ((sTimer.tick_armed & TICK_BIT(slot)) != 0);
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_A0_Keep
+// @brief       Arm a deadline slot unless it is already armed.
+// @param       u8 slot			TICK_DISPLAY .. TICK_CHRONO
+//				u32 seconds		Delay in seconds from current system time (>= 1)
+// @return      none
+// *************************************************************************************************
+void Timer0_A0_Keep(u8 slot, u32 seconds)
+{
+	if (!Timer0_A0_Is_Scheduled(slot)) Timer0_A0_Schedule(slot, seconds);
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_A0_Program
+// @brief       Load CCR0 for the deadline at the head of the queue. CCR0 matches shortly after the
+//				RTC second changed. Deadlines beyond the next minute change are left to RTC_ISR,
+//				which calls this function every minute, so CCR0 only runs when a deadline is near.
+//				Must be called with interrupts disabled.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void Timer0_A0_Program(void)
+{
+	u32 rtc, left;
+	u16 fraction, value;
+	s32 seconds;
+	
+	// Disable timer interrupt
+	TA0CCTL0 &= ~CCIE;
+	
+	if (sTimer.tick_queued == 0) return;
+	
+	rtc   = rtc_seconds(&fraction);
+	value = TA0R;
+	
+	// Seconds from start of current second to due second
+	seconds = (s32)(sTimer.tick_due[sTimer.tick_queue[0]] - (rtc - sTimer.rtc_offset));
+	if (seconds <= 0)
+	{
+		left = 0;
+	}
+	else
+	{
+		// Minute IRQ of RTC comes first - program CCR0 then
+		if (seconds > (s32)(60 - rtc % 60)) return;
+	
+		left = ((u32)seconds << 15) - fraction + TIMER0_A0_LATE;
+		if (left > TIMER0_A0_STEP_MAX) left = TIMER0_A0_STEP_MAX;
+	}
+	
+	// Update CCR
+	TA0CCR0 = value + (u16)left;
+	
+	// Reset IRQ flag
+	TA0CCTL0 &= ~CCIFG;
+	
+	// Deadline already passed while CCR was loaded - request IRQ now
+	if ((u16)(TA0R - value) >= (u16)left) TA0CCTL0 |= CCIFG;
+	
+	// Enable timer interrupt
+	TA0CCTL0 |= CCIE;
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_Now
+// @brief       Monotonic time stamp with 1/32768 sec resolution, read from the RTC_A calendar and
+//				prescaler. System time keeps running at the same pace when the RTC is set.
+// @param       struct timestamp * ts		Seconds and 1/32768 fraction
+// @return      none
+// *************************************************************************************************
+void Timer0_Now(struct timestamp * ts)
+{
+	ts->seconds = rtc_seconds(&ts->fraction) - sTimer.rtc_offset;
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_Seconds
+// @brief       System time: seconds since power-up, monotonic.
+// @param       none
+// @return      u32				System time in seconds
+// *************************************************************************************************
+u32 Timer0_Seconds(void)
+{
+	return (rtc_seconds(0) - sTimer.rtc_offset);
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_Set_Seconds
+// @brief       Set system time. Called after the RTC was set, so system time does not jump with
+//				the wall clock time.
+// @param       u32 seconds		System time in seconds
+// @return      none
+// *************************************************************************************************
+void Timer0_Set_Seconds(u32 seconds)
+{
+	istate_t int_state;
+	
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	sTimer.rtc_offset = rtc_seconds(0) - seconds;
+	
+	// Position in minute may have changed
+	Timer0_A0_Program();
+	
+	__set_interrupt_state(int_state);
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_Ticks
+// @brief       Monotonic time stamp in 1/32768 sec. Wraps after 36 hours, so only differences 
+//				of time stamps (unsigned subtraction) are meaningful.
+// @param       none
+// @return      u32				Time stamp in 1/32768 sec
+// *************************************************************************************************
+u32 Timer0_Ticks(void)
+{
+	struct timestamp ts;
+	
+	Timer0_Now(&ts);
+	
+	return ((ts.seconds << 15) + ts.fraction);
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_Ticks_At
+// @brief       Convert a TA0R value captured less than 2 seconds ago (e.g. button edge) to a 
+//				monotonic time stamp. Accurate to 1 tick.
+// @param       u16 stamp		TA0R at event
+// @return      u32				Time stamp of event in 1/32768 sec
+// *************************************************************************************************
+u32 Timer0_Ticks_At(u16 stamp)
+{
+	u32 now = Timer0_Ticks();
+	
+	// Subtract age of captured value
+	return (now - (u16)(TA0R - stamp));
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_A0_Refresh
+// @brief       Arm the deadline slots of all modules that are currently active. Called by the
+//				idle loop before going to LPM3, so only active modules cause clock tick wakeups.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void Timer0_A0_Refresh(void)
+{
+#ifdef FEATURE_CHRONO
+	u8 refresh;
+#endif
+
+	// Views that show seconds or live data are refreshed every second
+	if (menu_needs_second_tick()) Timer0_A0_Keep(TICK_DISPLAY, 1);
+	//pfs
+#ifndef ELIMINATE_BLUEROBIN
+	// If BlueRobin transmitter is connected, get data from API every second
+	if (is_bluerobin()) Timer0_A0_Keep(TICK_DISPLAY, 1);
+#endif
+
+	#ifdef CONFIG_ALARM
+	if (sAlarm.state == ALARM_ON) Timer0_A0_Keep(TICK_ALARM, 1);
+	#endif
+
+	if (is_temp_measurement()) Timer0_A0_Keep(TICK_TEMPERATURE, 1);
+
+#ifdef CONFIG_ALTITUDE
+	if (is_altitude_measurement()) Timer0_A0_Keep(TICK_ALTITUDE, 1);
+#endif
+
+#ifdef FEATURE_PROVIDE_ACCEL
+	if (is_acceleration_measurement()) Timer0_A0_Keep(TICK_ACCEL, 1);
+#endif
+
+	#ifdef CONFIG_BATTERY
+	if (sys.flag.low_battery) Timer0_A0_Keep(TICK_LOBATT, BATTERY_LOW_MESSAGE_CYCLE + 1);
+	#endif
+
+	// Messages are shown and erased synchronously with next clock tick
+	if (message.flag.prepare || message.flag.erase) Timer0_A0_Keep(TICK_MESSAGE, 1);
+
+	if (sys.flag.idle_timeout_enabled) Timer0_A0_Keep(TICK_IDLE, INACTIVITY_TIME + 1);
+
+#ifdef FEATURE_CHRONO
+	// Running stopwatch or eggtimer is redrawn only while it is visible
+	refresh = 0;
+	#ifdef CONFIG_STOP_WATCH
+	refresh |= stopwatch_keep_refresh();
+	#endif
+	#ifdef CONFIG_EGGTIMER
+	refresh |= eggtimer_keep_refresh();
+	#endif
+	if (!refresh) chrono_stop_refresh();
+#endif
+
+#ifdef USE_LCD_DOUBLE_BUFFER
+	// Blinking segments are toggled by software while blinking is enabled
+	if (is_display_blinking()) Timer0_A0_Keep(TICK_BLINK, 1);
+#endif
+}
+
 
 // *************************************************************************************************
 // @fn          TIMER0_A0_ISR
 // @brief       IRQ handler for TIMER0_A0 IRQ
-//				Timer0_A0	1/1sec clock tick 			(serviced by function TIMER0_A0_ISR)
+//				Timer0_A0	Deadline driven clock tick		(serviced by function TIMER0_A0_ISR)
 //				Timer0_A1	 							(serviced by function TIMER0_A1_5_ISR)
-//				Timer0_A2	1/100 sec Stopwatch			(serviced by function TIMER0_A1_5_ISR)
-//				Timer0_A3	Configurable periodic IRQ	(serviced by function TIMER0_A1_5_ISR)
-//				Timer0_A4	One-time delay				(serviced by function TIMER0_A1_5_ISR)
+//				Timer0_A2	Timer engine expiry			(serviced by function TIMER0_A1_5_ISR)
+//				Timer0_A3	unused
+//				Timer0_A4	Software timers				(serviced by function TIMER0_A1_5_ISR)
+//				CCR0 matches when the deadline at the head of the queue is due and is off while
+//				no deadline is armed. LPM3 is only left when a deadline slot is due.
 // @param       none
 // @return      none
 // *************************************************************************************************
@@ -311,24 +713,15 @@ interrupt (TIMER0_A0_VECTOR) TIMER0_A0_ISR(void)
 __interrupt void TIMER0_A0_ISR(void)
 #endif
 {
-	static u8 button_lock_counter = 0;
-	static u8 button_beep_counter = 0;
+	u32 seconds;
+	u16 due = 0;
+	u8 slot, i, n;
 	
 	// Disable IE 
 	TA0CCTL0 &= ~CCIE;
 	// Reset IRQ flag  
 	TA0CCTL0 &= ~CCIFG;  
-	// Add 1 sec to TACCR0 register (IRQ will be asserted at 0x7FFF and 0xFFFF = 1 sec intervals)
-	TA0CCR0 += 32768;
-	// Enable IE 
-	TA0CCTL0 |= CCIE;
-	
-	// Add 1 second to global time
-	clock_tick();
-	
-	// Set clock update flag
-	display.flag.update_time = 1;
-	
+		
 	// While SimpliciTI stack operates or BlueRobin searches, freeze system state
 	//pfs
 	#ifdef ELIMINATE_BLUEROBIN
@@ -337,6 +730,14 @@ __interrupt void TIMER0_A0_ISR(void)
 	if (is_rf() || is_bluerobin_searching()) 
 	#endif
 	{
+		// Radio loops rely on a 1/s tick
+		TA0CCR0 += 32768;
+		TA0CCTL0 |= CCIE;
+		
+		// Get time from RTC and set clock update flag - radio loops poll and clear only this flag
+		rtc_read();
+		display.flag.update_time = 1;
+		
 		// SimpliciTI automatic timeout
 		if (sRFsmpl.timeout == 0) 
 		{
@@ -353,37 +754,45 @@ __interrupt void TIMER0_A0_ISR(void)
 	}
 	
 	// -------------------------------------------------------------------
-	// Service modules that require 1/min processing
-	if (sTime.drawFlag >= 2) 
+	// Collect all deadline slots that are due
+	seconds = Timer0_Seconds();
+	n = 0;
+	while ((n < sTimer.tick_queued) && ((s32)(sTimer.tick_due[sTimer.tick_queue[n]] - seconds) <= 0))
 	{
-		#ifdef CONFIG_BATTERY
-		// Measure battery voltage to keep track of remaining battery life
-		request.flag.voltage_measurement = 1;
-		#endif
-		
-		#ifdef CONFIG_ALARM
-		// If the chime is enabled, we beep here
-		if (sTime.minute == 0) {
-			if (sAlarm.hourly == ALARM_ENABLED) {
-				request.flag.buzzer = 1;
-			}
-		}
-		// Check if alarm needs to be turned on
-		check_alarm();
-		#endif
+		slot = sTimer.tick_queue[n++];
+		sTimer.tick_armed &= ~TICK_BIT(slot);
+		due |= TICK_BIT(slot);
 	}
-
+	
+	// Remove them from queue
+	for (i=n; i<sTimer.tick_queued; i++) sTimer.tick_queue[i-n] = sTimer.tick_queue[i];
+	sTimer.tick_queued -= n;
+	
 	// -------------------------------------------------------------------
 	// Service active modules that require 1/s processing
+	// Slots are re-armed by Timer0_A0_Refresh() as long as the module stays active
+	
+	if (due & TICK_BIT(TICK_DISPLAY))
+	{
+		// Get time from RTC and request clock and date update of display
+		if (rtc_read()) event_push_level(EVENT_DATE);
+		event_push_level(EVENT_TIME);
+		
+		//pfs
+#ifndef ELIMINATE_BLUEROBIN
+		// If BlueRobin transmitter is connected, get data from API
+		if (is_bluerobin()) get_bluerobin_data();
+#endif
+	}
 	
 	#ifdef CONFIG_ALARM  // N8VI NOTE eventually, eggtimer should use this code too
 	// Generate alarm signal
-	if (sAlarm.state == ALARM_ON) 
+	if ((due & TICK_BIT(TICK_ALARM)) && (sAlarm.state == ALARM_ON)) 
 	{
 		// Decrement alarm duration counter
 		if (sAlarm.duration-- > 0)
 		{
-			request.flag.buzzer = 1;
+			event_push(EVENT_BUZZER, 0);
 		}
 		else
 		{
@@ -393,20 +802,12 @@ __interrupt void TIMER0_A0_ISR(void)
 	}
 	#endif
 
-#ifdef CONFIG_STRENGTH
-        // One more second gone by.
-        if(is_strength())
-	{
-		strength_tick();
-	}            
-#endif
-
 	// Do a temperature measurement each second while menu item is active
-	if (is_temp_measurement()) request.flag.temperature_measurement = 1;
+	if ((due & TICK_BIT(TICK_TEMPERATURE)) && is_temp_measurement()) event_push(EVENT_TEMPERATURE, FILTER_ON);
 	
 	// Do a pressure measurement each second while menu item is active
 #ifdef CONFIG_ALTITUDE
-	if (is_altitude_measurement()) 
+	if ((due & TICK_BIT(TICK_ALTITUDE)) && is_altitude_measurement()) 
 	{
 		// Countdown altitude measurement timeout while menu item is active
 		sAlt.timeout--;
@@ -416,20 +817,20 @@ __interrupt void TIMER0_A0_ISR(void)
 		{
 			stop_altitude_measurement();
 			// Show ---- m/ft
-			display_chars(LCD_SEG_L1_3_0, (u8*)"----", SEG_ON);
+			display_defer_chars(LCD_SEG_L1_3_0, (u8*)"----", SEG_ON);
 			// Clear up/down arrow
-			display_symbol(LCD_SYMB_ARROW_UP, SEG_OFF);
-			display_symbol(LCD_SYMB_ARROW_DOWN, SEG_OFF);
+			display_defer_symbol(LCD_SYMB_ARROW_UP, SEG_OFF);
+			display_defer_symbol(LCD_SYMB_ARROW_DOWN, SEG_OFF);
 		}
 		
 		// In case we missed the IRQ due to debouncing, get data now
-		if ((PS_INT_IN & PS_INT_PIN) == PS_INT_PIN) request.flag.altitude_measurement = 1;
+		if ((PS_INT_IN & PS_INT_PIN) == PS_INT_PIN) event_push_level(EVENT_ALTITUDE);
 	}	
 #endif
 
 #ifdef FEATURE_PROVIDE_ACCEL
 	// Count down timeout
-	if (is_acceleration_measurement()) 
+	if ((due & TICK_BIT(TICK_ACCEL)) && is_acceleration_measurement()) 
 	{
 		// Countdown acceleration measurement timeout 
 		sAccel.timeout--;
@@ -438,203 +839,70 @@ __interrupt void TIMER0_A0_ISR(void)
 		if (sAccel.timeout == 0) as_stop();	
 		
 		// If DRDY is (still) high, request data again
-		if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN) request.flag.acceleration_measurement = 1; 
+		if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN) event_push_level(EVENT_ACCELERATION);
 	}	
 #endif
-
-	//pfs
-#ifndef ELIMINATE_BLUEROBIN
-	// If BlueRobin transmitter is connected, get data from API
-	if (is_bluerobin()) get_bluerobin_data();
-#endif
 	
 	#ifdef CONFIG_BATTERY
-	// If battery is low, decrement display counter
-	if (sys.flag.low_battery)
-	{
-		if (sBatt.lobatt_display-- == 0) 
-		{
-			message.flag.prepare = 1;
-			message.flag.type_lobatt = 1;
-			sBatt.lobatt_display = BATTERY_LOW_MESSAGE_CYCLE;
-		}
-	}
+	// If battery is low, show "lobatt" message every BATTERY_LOW_MESSAGE_CYCLE seconds
+	if ((due & TICK_BIT(TICK_LOBATT)) && sys.flag.low_battery) event_push(EVENT_MESSAGE, MESSAGE_LOBATT);
 	#endif
 	
-	// If a message has to be displayed, set display flag
-	if (message.all_flags)
-	{
-		if (message.flag.prepare)
-		{
-			message.flag.prepare = 0;
-			message.flag.show    = 1;
-		}
-		else if (message.flag.erase) // message cycle is over, so erase it
-		{
-			message.flag.erase       = 0;
-			message.flag.block_line1 = 0;
-			message.flag.block_line2 = 0;
-			display.flag.full_update = 1;
-		}	
-	}
+	// Show prepared message or erase shown message in main loop
+	if (due & TICK_BIT(TICK_MESSAGE)) event_push(EVENT_MESSAGE, MESSAGE_TICK);
 	
 	// -------------------------------------------------------------------
 	// Check idle timeout, set timeout flag
-	if (sys.flag.idle_timeout_enabled)
-	{
-		if (sTime.system_time - sTime.last_activity > INACTIVITY_TIME) sys.flag.idle_timeout = 1; //setFlag(sysFlag_g, SYS_TIMEOUT_IDLE);
-	}
-	
-	// -------------------------------------------------------------------
-	// Turn the Backlight off after timeout
-	if (sButton.backlight_status == 1)
+	if ((due & TICK_BIT(TICK_IDLE)) && sys.flag.idle_timeout_enabled)
 	{
-		if (sButton.backlight_timeout > BACKLIGHT_TIME_ON)
+		if (seconds - sTime.last_activity > INACTIVITY_TIME)  
 		{
-			//turn off Backlight
-			P2OUT &= ~BUTTON_BACKLIGHT_PIN;
-			P2DIR &= ~BUTTON_BACKLIGHT_PIN;
-			sButton.backlight_timeout = 0;
-			sButton.backlight_status = 0;
+			sys.flag.idle_timeout = 1; //setFlag(sysFlag_g, SYS_TIMEOUT_IDLE);
 		}
 		else
 		{
-			sButton.backlight_timeout++;
+			// User was active in the meantime, check again when the new timeout has elapsed
+			Timer0_A0_Schedule(TICK_IDLE, sTime.last_activity + INACTIVITY_TIME + 1 - seconds);
 		}
 	}
+	
 	// -------------------------------------------------------------------
-	// Detect continuous button high states
-
-	if (BUTTON_STAR_IS_PRESSED && BUTTON_UP_IS_PRESSED)
-	{
-		if (button_beep_counter++ > LEFT_BUTTON_LONG_TIME)
-		{
-			// Toggle no_beep buttons flag
-			sys.flag.no_beep = ~sys.flag.no_beep;
-	
-			// Show "beep / nobeep" message synchronously with next second tick
-			message.flag.prepare = 1;
-			if (sys.flag.no_beep)	message.flag.type_no_beep_on   = 1;
-			else					message.flag.type_no_beep_off  = 1;
-			
-			// Reset button beep counter
-			button_beep_counter = 0;
-		}
-	} else if (BUTTON_NUM_IS_PRESSED && BUTTON_DOWN_IS_PRESSED) // Trying to lock/unlock buttons?
+	// Turn the Backlight off after timeout
+	if ((due & TICK_BIT(TICK_BACKLIGHT)) && (sButton.backlight_status == 1))
 	{
-		if (button_lock_counter++ > LEFT_BUTTON_LONG_TIME)
-		{
-			// Toggle lock / unlock buttons flag
-			sys.flag.lock_buttons = ~sys.flag.lock_buttons;
-	
-			// Show "buttons are locked/unlocked" message synchronously with next second tick
-			message.flag.prepare = 1;
-			if (sys.flag.lock_buttons)	message.flag.type_locked   = 1;
-			else						message.flag.type_unlocked = 1;
-			
-			// Reset button lock counter
-			button_lock_counter = 0;
-		}
+		//turn off Backlight
+		P2OUT &= ~BUTTON_BACKLIGHT_PIN;
+		P2DIR &= ~BUTTON_BACKLIGHT_PIN;
+		sButton.backlight_status = 0;
 	}
-	else // Trying to create a long button press?
-	{
-		// Reset button lock counter
-		button_lock_counter = 0;
-		
-		if (BUTTON_STAR_IS_PRESSED) 	
-		{
-			sButton.star_timeout++;
-			
-			// Check if button was held low for some seconds
-			if (sButton.star_timeout > LEFT_BUTTON_LONG_TIME) 
-			{
-				button.flag.star_long = 1;
-				sButton.star_timeout = 0;
-			}
-		}
-		else
-		{
-			sButton.star_timeout = 0;
-		}
 	
-		if (BUTTON_NUM_IS_PRESSED) 	
-		{
-			sButton.num_timeout++;
-		
-			// Check if button was held low for some seconds
-			if (sButton.num_timeout > LEFT_BUTTON_LONG_TIME) 
-			{
-				button.flag.num_long = 1;
-				sButton.num_timeout = 0;
-			}
-		}
-		else
-		{
-			sButton.num_timeout = 0;
-		}
-
-		if (BUTTON_UP_IS_PRESSED) 	
-		{
-			sButton.up_timeout++;
-		
-			// Check if button was held low for some seconds
-			if (sButton.up_timeout > LEFT_BUTTON_LONG_TIME) 
-			{
-				button.flag.up_long = 1;
-				sButton.up_timeout = 0;
-			}
-		}
-		else
-		{
-			sButton.up_timeout = 0;
-		}
-
-		if (BUTTON_DOWN_IS_PRESSED) 	
-		{
-			sButton.down_timeout++;
-		
-			// Check if button was held low for some seconds
-			if (sButton.down_timeout > LEFT_BUTTON_LONG_TIME) 
-			{
-				button.flag.down_long = 1;
-				sButton.down_timeout = 0;
-			}
-		}
-		else
-		{
-			sButton.down_timeout = 0;
-		}
-
-		if (BUTTON_BACKLIGHT_IS_PRESSED) 	
-		{
-			sButton.bbacklight_timeout++;
-		
-			// Check if button was held low for some seconds
-			if (sButton.bbacklight_timeout > LEFT_BUTTON_LONG_TIME) 
-			{
-				button.flag.backlight_long = 1;
-				sButton.bbacklight_timeout = 0;
-			}
-		}
-		else
-		{
-			sButton.bbacklight_timeout = 0;
-		}
-	}
+#ifdef USE_LCD_DOUBLE_BUFFER
+	// Toggle blinking segments - next display_commit() flips in the new frame
+	if (due & TICK_BIT(TICK_BLINK)) display_blink_tick();
+#endif
 	
-	// Exit from LPM3 on RETI
-	_BIC_SR_IRQ(LPM3_bits);               
+#ifdef FEATURE_CHRONO
+	// Timer engine expiry is within reach of TA0CCR2 now
+	if (due & TICK_BIT(TICK_CHRONO)) chrono_program();
+#endif
+	
+	// -------------------------------------------------------------------
+	// Program CCR0 for the nearest deadline, or leave it off
+	Timer0_A0_Program();
+		
+	// Exit from LPM3 on RETI only if some module has work to do
+	if (due & ~TICK_BIT(TICK_CHRONO)) _BIC_SR_IRQ(LPM3_bits);               
 }
 
 
 // *************************************************************************************************
 // @fn          Timer0_A1_5_ISR
 // @brief       IRQ handler for timer IRQ.
-//				Timer0_A0	1/1sec clock tick (serviced by function TIMER0_A0_ISR)
+//				Timer0_A0	Deadline driven clock tick (serviced by function TIMER0_A0_ISR)
 //				Timer0_A1	BlueRobin timer / doorlock
-//				Timer0_A2	1/100 sec Stopwatch
-//				Timer0_A3	Configurable periodic IRQ (used by button_repeat and buzzer)
-//				Timer0_A4	One-time delay
+//				Timer0_A2	Timer engine expiry (stopwatch, eggtimer, strength timer)
+//				Timer0_A3	unused
+//				Timer0_A4	Software timers (delay, button debounce and repeat, buzzer, sensors)
 // @param       none
 // @return      none
 // *************************************************************************************************
@@ -648,6 +916,7 @@ __interrupt void TIMER0_A1_5_ISR(void)
 #endif
 {
 	u16 value;
+	u8 i;
 		
 	switch (TA0IV)
 	{
@@ -658,33 +927,6 @@ __interrupt void TIMER0_A1_5_ISR(void)
 					BRRX_TimerTask_v();
 					break;
 	#endif
-	#ifdef CONFIG_SIDEREAL
-		// Timer0_A1	Used for sidereal time until CCR0 becomes free
-		case 0x02:  // Timer0_A1 handler
-				// Disable IE 
-				TA0CCTL1 &= ~CCIE;
-				// Reset IRQ flag  
-				TA0CCTL1 &= ~CCIFG;  
-				//for sidereal time we need 32768/1.00273790935=32678.529149 clock cycles for one second
-				//32678.5 clock cycles gives a deviation of ~0.9e-7~0.1s/day which is likely less than the ozillator deviation
-				if(sSidereal_time.second & 1)
-				{
-					TA0CCR1+=32678;
-				}
-				else
-				{
-					TA0CCR1+=32679;
-				}
-				// Enable IE 
-				TA0CCTL1 |= CCIE;
-				
-				// Add 1 second to global time
-				sidereal_clock_tick();
-				
-				// Set clock update flag
-				display.flag.update_sidereal_time = 1;
-				break;
-	#endif
 	#ifdef CONFIG_USE_GPS
 		case 0x02: // Disable IE
 							TA0CCTL1 &= ~CCIE;
@@ -700,52 +942,44 @@ __interrupt void TIMER0_A1_5_ISR(void)
 							fptr_Timer0_A1_function();
 							break;
 	#endif
-		// Timer0_A2	1/1 or 1/100 sec Stopwatch				
-		case 0x04:	// Timer0_A2 handler
-					// Disable IE 
+		// Timer0_A2	Expiry of stopwatch, eggtimer and strength timer
+		case 0x04:	// Disable IE 
 					TA0CCTL2 &= ~CCIE;
 					// Reset IRQ flag  
 					TA0CCTL2 &= ~CCIFG;  
-					// Load CCR register with next capture point
-#ifdef CONFIG_STOP_WATCH
-					update_stopwatch_timer();
-#endif
-#ifdef CONFIG_EGGTIMER
-					update_eggtimer_timer();
-#endif
-					// Enable timer interrupt    
-					TA0CCTL2 |= CCIE; 	
-					// Increase stopwatch counter
-#ifdef CONFIG_STOP_WATCH
-					stopwatch_tick();
-#endif
-#ifdef CONFIG_EGGTIMER
-					eggtimer_tick();
+#ifdef FEATURE_CHRONO
+					// Call expiry functions and load CCR register with next expiry
+					chrono_expire();
 #endif
 					break;
 					
-		// Timer0_A3	Configurable periodic IRQ (used by button_repeat and buzzer)			
-		case 0x06:	// Disable IE 
-					TA0CCTL3 &= ~CCIE;
-					// Reset IRQ flag  
-					TA0CCTL3 &= ~CCIFG;  
-					// Store new value in CCR
-					value = TA0R + sTimer.timer0_A3_ticks; //timer0_A3_ticks_g;
-					// Load CCR register with next capture point
-					TA0CCR3 = value;   
-					// Enable timer interrupt    
-					TA0CCTL3 |= CCIE; 	
-					// Call function handler
-					fptr_Timer0_A3_function();
-					break;
-		
-		// Timer0_A4	One-time delay			
+		// Timer0_A4	Software timers			
 		case 0x08:	// Disable IE 
 					TA0CCTL4 &= ~CCIE;
 					// Reset IRQ flag  
 					TA0CCTL4 &= ~CCIFG;  
-					// Set delay over flag
-					sys.flag.delay_over = 1;
+					// Expire timers
+					value = TA0R;
+					for (i=0; i<TIMER0_A4_CHANNELS; i++)
+					{
+						if ((sTimer.timer0_A4_active & (BIT0 << i)) == 0) continue;
+						if ((u16)(value - sTimer.timer0_A4_start[i]) < sTimer.timer0_A4_ticks[i]) continue;
+						
+						if (sTimer.timer0_A4_period[i] != 0)
+						{
+							// Periodic timer: count next period from this expiry to avoid drift
+							sTimer.timer0_A4_start[i] += sTimer.timer0_A4_ticks[i];
+							sTimer.timer0_A4_ticks[i]  = sTimer.timer0_A4_period[i];
+						}
+						else
+						{
+							sTimer.timer0_A4_active &= ~(BIT0 << i);
+						}
+						// Call function handler
+						sTimer.timer0_A4_function[i]();
+					}
+					// Load CCR register with next expiry
+					Timer0_A4_Program();
 					break;
 	}
 	
@@ -47,10 +47,22 @@ extern void Timer0_Start(void);
 extern void Timer0_Stop(void);
 extern void Timer0_A1_Start(u16 ticks);
 extern void Timer0_A1_Stop(void);
-extern void Timer0_A3_Start(u16 ticks);
-extern void Timer0_A3_Stop(void);
 extern void Timer0_A4_Delay(u16 ticks);
-extern void (*fptr_Timer0_A3_function)(void);
+extern u8 Timer0_A4_Wait(u16 ticks, u8 (*ready)(void));
+extern void Timer0_A4_Start(u8 timer, u16 ticks, u16 period, void (*fptr)(void));
+extern void Timer0_A4_Stop(u8 timer);
+extern u8 Timer0_A4_Is_Active(u8 timer);
+extern void Timer0_A0_Schedule(u8 slot, u32 seconds);
+extern void Timer0_A0_Cancel(u8 slot);
+extern u8 Timer0_A0_Is_Scheduled(u8 slot);
+extern void Timer0_A0_Refresh(void);
+extern void Timer0_A0_Program(void);
+struct timestamp;
+extern void Timer0_Now(struct timestamp * ts);
+extern u32 Timer0_Seconds(void);
+extern void Timer0_Set_Seconds(u32 seconds);
+extern u32 Timer0_Ticks(void);
+extern u32 Timer0_Ticks_At(u16 stamp);
 #ifdef CONFIG_USE_GPS
 extern void (*fptr_Timer0_A1_function)(void);
 #endif
@@ -58,15 +70,75 @@ extern void (*fptr_Timer0_A1_function)(void);
 
 // *************************************************************************************************
 // Defines section
+
+// Deadline slots serviced by TIMER0_A0_ISR - one per module that needs 1/s processing
+// 1/min processing is done by RTC_ISR. CCR0 is off while no slot is armed.
+#define TICK_DISPLAY			(0u)	// 1/s refresh of views that show seconds or live data
+#define TICK_ALARM				(1u)	// Alarm buzzer
+#define TICK_TEMPERATURE		(2u)	// Temperature measurement while menu item is visible
+#define TICK_ALTITUDE			(3u)	// Altitude measurement timeout
+#define TICK_ACCEL				(4u)	// Acceleration measurement timeout
+#define TICK_LOBATT				(5u)	// "lobatt" message cycle
+#define TICK_MESSAGE			(6u)	// Show / erase message synchronously with clock tick
+#define TICK_IDLE				(7u)	// Inactivity timeout of set_value()
+#define TICK_BACKLIGHT			(8u)	// Backlight off
+#define TICK_BLINK				(9u)	// Software blinking of double buffered LCD
+#define TICK_CHRONO				(10u)	// Timer engine expiry too far away for TA0CCR2
+#define TICK_SLOTS				(11u)
+
+// Bit of a deadline slot in the mask of due slots
+#define TICK_BIT(slot)			(1u << (slot))
+
+// CCR0 matches this many ticks after the RTC second changed, so the RTC shows the due second
+#define TIMER0_A0_LATE			(2u)
+
+// Longest step of CCR0 - deadlines further away are reached in several steps
+#define TIMER0_A0_STEP_MAX		(0xFFFFu)
+
+// Software timers sharing CCR4 - one per module that needs sub-second timing
+#define TIMER0_A4_DELAY			(0u)	// Timer0_A4_Delay(), Timer0_A4_Wait() - blocking wait of main loop
+#define TIMER0_A4_DEBOUNCE		(1u)	// Button debounce
+#define TIMER0_A4_REPEAT		(2u)	// Button auto repeat
+#define TIMER0_A4_BUZZER		(3u)	// Buzzer on/off duty cycle
+#define TIMER0_A4_SENSOR		(4u)	// Acceleration sensor power-up sequence and read-out timeout
+#define TIMER0_A4_SEQUENCE		(5u)	// Doorlock knock feedback
+#define TIMER0_A4_CHRONO		(6u)	// Display refresh of visible running stopwatch or eggtimer
+#define TIMER0_A4_GESTURE		(7u)	// Long press, chord or double-click expiry of held / released buttons
+#define TIMER0_A4_CHANNELS		(8u)
+
 struct timer
 {
 	// Timer0_A1 periodic delay
 	u16		timer0_A1_ticks;
-		// Timer0_A3 periodic delay
-	u16		timer0_A3_ticks;
+	// Timer0_A4 software timers: start time, delay, reload period (0 = one-shot), callback 
+	// and active timers (bit mask)
+	u16		timer0_A4_start[TIMER0_A4_CHANNELS];
+	u16		timer0_A4_ticks[TIMER0_A4_CHANNELS];
+	u16		timer0_A4_period[TIMER0_A4_CHANNELS];
+	void	(*timer0_A4_function[TIMER0_A4_CHANNELS])(void);
+	u8		timer0_A4_active;
+
+	// Timer0_A0 deadline queue: due second per slot and slots sorted by due second
+	u32		tick_due[TICK_SLOTS];
+	u8		tick_queue[TICK_SLOTS];
+	u8		tick_queued;
+	u16		tick_armed;
+	// RTC seconds since calendar epoch minus system time, keeps system time monotonic when 
+	// the RTC is set
+	u32		rtc_offset;
 };
 extern struct timer sTimer;
 
+// Monotonic time stamp: system time in seconds (Timer0_Seconds) and 1/32768 sec since
+struct timestamp
+{
+	u32		seconds;
+	u16		fraction;
+};
+
+// Time stamp ticks per second (Timer0_Ticks)
+#define TIMESTAMP_TICKS			(32768ul)
+
 // Trigger reset when all buttons are pressed
 #define BUTTON_RESET_SEC		(3u)
 
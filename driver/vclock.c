@@ -0,0 +1,162 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Virtual clocks derived from the 1/s system time tick. Clocks with a different rate (e.g. 
+// sidereal time) or offset (e.g. other time zones) are computed from the base tick with a 
+// rational DDA accumulator when they are displayed, instead of counting their own timer IRQs.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+#ifdef FEATURE_VCLOCK
+
+// driver
+#include "vclock.h"
+#include "timer.h"
+
+// logic
+#include "clock.h"
+
+
+// *************************************************************************************************
+// Prototypes section
+void vclock_init(struct vclock * clk, u16 num, u16 den);
+void vclock_set(struct vclock * clk, u32 seconds);
+u8 vclock_update(struct vclock * clk);
+void vclock_split(struct vclock * clk);
+
+
+// *************************************************************************************************
+// Defines section
+
+
+// *************************************************************************************************
+// Global Variable section
+
+
+// *************************************************************************************************
+// Extern section
+
+
+// *************************************************************************************************
+// @fn          vclock_init
+// @brief       Set rate of a virtual clock and reset it to 00:00:00.
+// @param       struct vclock * clk		Virtual clock
+//				u16 num					Clock advances num/den seconds per base second
+//				u16 den
+// @return      none
+// *************************************************************************************************
+void vclock_init(struct vclock * clk, u16 num, u16 den)
+{
+	clk->num = num;
+	clk->den = den;
+	vclock_set(clk, 0);
+}
+
+
+// *************************************************************************************************
+// @fn          vclock_set
+// @brief       Set time of day of a virtual clock at current base time.
+// @param       struct vclock * clk		Virtual clock
+//				u32 seconds				Time of day in seconds
+// @return      none
+// *************************************************************************************************
+void vclock_set(struct vclock * clk, u32 seconds)
+{
+	clk->base 	 = Timer0_Seconds();
+	clk->seconds = seconds % VCLOCK_DAY;
+	clk->acc 	 = 0;
+	vclock_split(clk);
+}
+
+
+// *************************************************************************************************
+// @fn          vclock_update
+// @brief       Advance a virtual clock to current base time.
+// @param       struct vclock * clk		Virtual clock
+// @return      u8						Highest changed field like sTime.drawFlag:
+//										0 = none, 1 = second, 2 = minute, 3 = hour
+// *************************************************************************************************
+u8 vclock_update(struct vclock * clk)
+{
+	u32 elapsed, step, ticks;
+	u8 hour   = clk->hour;
+	u8 minute = clk->minute;
+	u8 second = clk->second;
+	
+	elapsed = Timer0_Seconds() - clk->base;
+	clk->base += elapsed;
+	
+	while (elapsed > 0)
+	{
+		step = (elapsed > VCLOCK_STEP_MAX) ? VCLOCK_STEP_MAX : elapsed;
+		elapsed -= step;
+		
+		// Clock advances num/den seconds per base second, remainder is carried in acc
+		ticks = step * clk->num + clk->acc;
+		clk->seconds = (clk->seconds + (ticks / clk->den) % VCLOCK_DAY) % VCLOCK_DAY;
+		clk->acc 	 = ticks % clk->den;
+	}
+	
+	vclock_split(clk);
+	
+	if (clk->hour != hour)		return (3);
+	if (clk->minute != minute)	return (2);
+	if (clk->second != second)	return (1);
+	return (0);
+}
+
+
+// *************************************************************************************************
+// @fn          vclock_split
+// @brief       Split time of day of a virtual clock into hour, minute and second.
+// @param       struct vclock * clk		Virtual clock
+// @return      none
+// *************************************************************************************************
+void vclock_split(struct vclock * clk)
+{
+	u16 rest;
+	
+	clk->hour 	= clk->seconds / 3600;
+	rest 		= clk->seconds % 3600;
+	clk->minute = rest / 60;
+	clk->second = rest % 60;
+}
+
+#endif // FEATURE_VCLOCK
@@ -0,0 +1,88 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Virtual clocks derived from the 1/s system time tick. Each clock runs at a rational rate 
+// num/den of the base tick and is only advanced when it is read, so derived clocks need no 
+// timer IRQ of their own.
+// *************************************************************************************************
+
+#ifndef VCLOCK_H_
+#define VCLOCK_H_
+
+
+// *************************************************************************************************
+// Include section
+
+
+// *************************************************************************************************
+// Defines section
+
+// Seconds of a day of a virtual clock
+#define VCLOCK_DAY							(86400ul)
+
+// Largest base interval converted at once: VCLOCK_STEP_MAX * num + acc must fit into u32
+#define VCLOCK_STEP_MAX						(65536ul)
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Virtual clock: time of day advances num/den seconds per second of system time
+struct vclock
+{
+	u32		base;			// System time (Timer0_Seconds) at last update
+	u32		seconds;		// Time of day in seconds (0 .. VCLOCK_DAY-1)
+	u16		acc;			// Fraction of a second carried to next update (0 .. den-1)
+	u16		num;			// Rate of clock relative to base tick = num/den
+	u16		den;
+	
+	// Time of day split into hour, minute and second by last update
+	u8		hour;
+	u8		minute;
+	u8		second;
+};
+
+
+// *************************************************************************************************
+// Prototypes section
+extern void vclock_init(struct vclock * clk, u16 num, u16 den);
+extern void vclock_set(struct vclock * clk, u32 seconds);
+extern u8 vclock_update(struct vclock * clk);
+
+
+// *************************************************************************************************
+// Extern section
+
+
+#endif /*VCLOCK_H_*/
@@ -68,12 +68,15 @@ void as_disconnect(void)
 // *************************************************************************************************
 // Prototypes section
 void as_start(void);
+void as_start_configure(void);
+void as_start_output(void);
 void as_stop(void);
 u8 as_read_register(u8 bAddress);
 u8 as_write_register(u8 bAddress, u8 bData);
 u8 as_get_x(void);
 u8 as_get_y(void);
 u8 as_get_z(void);
+void as_burst_timeout(void);
 
 // *************************************************************************************************
 // Defines section
@@ -94,6 +97,29 @@ u8 as_get_z(void);
 // Valid sample rates for 8g range are: 40, 100, 400
 #define AS_SAMPLE_RATE       (400u)
 
+// Sensor configuration (CTRL register) for measurement range and sample rate
+#if (AS_RANGE == 2)
+  #if (AS_SAMPLE_RATE == 100)
+    #define AS_CTRL          (0x80 | 0x02)
+  #elif (AS_SAMPLE_RATE == 400)
+    #define AS_CTRL          (0x80 | 0x04)
+  #else
+    #error "Sample rate not supported"
+  #endif
+#elif (AS_RANGE == 8)
+  #if (AS_SAMPLE_RATE == 40)
+    #define AS_CTRL          (0x00 | 0x06)
+  #elif (AS_SAMPLE_RATE == 100)
+    #define AS_CTRL          (0x00 | 0x02)
+  #elif (AS_SAMPLE_RATE == 400)
+    #define AS_CTRL          (0x00 | 0x04)
+  #else
+    #error "Sample rate not supported"
+  #endif
+#else
+  #error "Measurement range not supported"    
+#endif  
+
 
 // *************************************************************************************************
 // Global Variable section
@@ -101,6 +127,10 @@ u8 as_get_z(void);
 // Global flag for proper acceleration sensor operation
 u8 as_ok;
 
+// Interrupt driven X/Y/Z read-out: destination buffer and number of SPI bytes exchanged so far
+static u8 * as_burst_data;
+static volatile u8 as_burst_count;
+
 
 // *************************************************************************************************
 // Extern section
@@ -143,15 +173,13 @@ void as_init(void)
 
 // *************************************************************************************************
 // @fn          as_start
-// @brief       Power-up and initialize acceleration sensor
+// @brief       Power-up acceleration sensor. Configuration continues from Timer0_A4 IRQ, 
+//				so the caller does not wait for the sensor power-up delays.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void as_start(void)
 {
-	volatile u16 Counter_u16;
-	u8 bConfig;//, bStatus;
-	
 	// Initialize SPI interface to acceleration sensor
 	AS_SPI_CTL0 |= UCSYNC | UCMST | UCMSB // SPI master, 8 data bits,  MSB first,
 	               | UCCKPH;              //  clock idle low, data output on falling edge
@@ -174,47 +202,42 @@ void as_start(void)
 #endif
 
 	// Delay of >5ms required between switching on power and configuring sensor
-	Timer0_A4_Delay(CONV_MS_TO_TICKS(10));
-	
+	Timer0_A4_Start(TIMER0_A4_SENSOR, CONV_MS_TO_TICKS(10), 0, as_start_configure);
+}
+
+
+// *************************************************************************************************
+// @fn          as_start_configure
+// @brief       Called by Timer0_A4 when sensor power is stable. Reset sensor.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void as_start_configure(void)
+{
 	// Initialize interrupt pin for data read out from acceleration sensor
 	AS_INT_IFG &= ~AS_INT_PIN;            // Reset flag
 	AS_INT_IE  |=  AS_INT_PIN;            // Enable interrupt
 	
-	// Configure sensor and start to sample data
-#if (AS_RANGE == 2)
-  bConfig = 0x80;
-  #if (AS_SAMPLE_RATE == 100)
-    bConfig |= 0x02;
-  #elif (AS_SAMPLE_RATE == 400)
-    bConfig |= 0x04;
-  #else
-    #error "Sample rate not supported"
-  #endif
-#elif (AS_RANGE == 8)
-  bConfig = 0x00;
-  #if (AS_SAMPLE_RATE == 40)
-    bConfig |= 0x06;
-  #elif (AS_SAMPLE_RATE == 100)
-    bConfig |= 0x02;
-  #elif (AS_SAMPLE_RATE == 400)
-    bConfig |= 0x04;
-  #else
-    #error "Sample rate not supported"
-  #endif
-#else
-  #error "Measurement range not supported"    
-#endif  
-
 	// Reset sensor
 	as_write_register(0x04, 0x02);   
 	as_write_register(0x04, 0x0A);   
 	as_write_register(0x04, 0x04);   
 	
 	// Wait 5 ms before starting sensor output
-	Timer0_A4_Delay(CONV_MS_TO_TICKS(5));
-	
-	// Set 2g measurement range, start to output data with 100Hz rate
-	as_write_register(0x02, bConfig);   
+	Timer0_A4_Start(TIMER0_A4_SENSOR, CONV_MS_TO_TICKS(5), 0, as_start_output);
+}
+
+
+// *************************************************************************************************
+// @fn          as_start_output
+// @brief       Called by Timer0_A4 after sensor reset. Start sensor output.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void as_start_output(void)
+{
+	// Set measurement range, start to output data with sample rate
+	as_write_register(0x02, AS_CTRL);   
 }
 
 
@@ -227,6 +250,9 @@ void as_start(void)
 // *************************************************************************************************
 void as_stop(void)
 {
+	// Cancel pending power-up sequence
+	Timer0_A4_Stop(TIMER0_A4_SENSOR);
+	
 	// Disable interrupt 
 	AS_INT_IE  &=  ~AS_INT_PIN;            	// Disable interrupt
 
@@ -354,21 +380,95 @@ u8 as_write_register(u8 bAddress, u8 bData)
 
 // *************************************************************************************************
 // @fn          as_get_data
-// @brief       Service routine to read acceleration values.
-// @param       none
+// @brief       Service routine to read acceleration values. The sensor does not auto-increment
+//				register addresses, so X/Y/Z are still three CSN frames of address + data byte.
+//				The USCI RX IRQ shifts the frames while the CPU waits in LPM0 (SMCLK keeps
+//				clocking the SPI). A stalled transfer is ended by AS_BURST_TIMEOUT and clears
+//				as_ok like a timeout of the polled register access.
+// @param       u8 * data		Buffer for X/Y/Z acceleration data
 // @return      none
 // *************************************************************************************************
 void as_get_data(u8 * data)
 {
+	istate_t int_state;
+
 	// Exit if sensor is not powered up
 	if ((AS_PWR_OUT & AS_PWR_PIN) != AS_PWR_PIN) return;
-  
-  	// Store X/Y/Z acceleration data in buffer
-	*(data+0) = as_read_register(0x06);
-	*(data+1) = as_read_register(0x07);
-	*(data+2) = as_read_register(0x08);
+
+	// Exit function if an error was detected previously
+	if (!as_ok) return;
+
+	// SPI hardware must be running, otherwise no RX IRQ will ever end the transfer
+	if (AS_SPI_CTL1 & UCSWRST)
+	{
+		as_ok = 0;
+		return;
+	}
+	
+	// Sensor does not output data before power-up sequence is complete
+	if (Timer0_A4_Is_Active(TIMER0_A4_SENSOR)) return;
+
+	int_state = __get_interrupt_state();
+
+	// Cannot sleep with IRQs disabled - read registers one by one
+	if ((int_state & GIE) == 0)
+	{
+		*(data+0) = as_read_register(AS_DATA_REGISTER+0);
+		*(data+1) = as_read_register(AS_DATA_REGISTER+1);
+		*(data+2) = as_read_register(AS_DATA_REGISTER+2);
+		return;
+	}
+
+	as_burst_data  = data;
+	as_burst_count = 0;
+	
+	// Wake up and give up if the sensor does not answer
+	Timer0_A4_Start(TIMER0_A4_SENSOR, AS_BURST_TIMEOUT, 0, as_burst_timeout);
+
+	AS_SPI_REN &= ~AS_SDI_PIN;          // Pulldown on SDI pin not required
+	AS_CSN_OUT &= ~AS_CSN_PIN;          // Select acceleration sensor
+
+	AS_IRQ_REG &= ~AS_RX_IFG;           // Discard stale RX data
+	AS_IE_REG  |=  AS_RX_IE;            // RX IRQ continues the transfer
+	AS_TX_BUFFER = AS_DATA_REGISTER << 2; // Write first address to TX buffer
+
+	// Store X/Y/Z acceleration data in buffer
+	while (1)
+	{
+		// Check with IRQs off, so the last RX IRQ cannot be missed before LPM entry
+		__disable_interrupt();
+		if (as_burst_count >= AS_DATA_BYTES*2) break;
+		
+		// Transfer stopped by timeout
+		if (!as_ok) break;
+
+		// Wait in LPM0, enables IRQs
+		_BIS_SR(LPM0_bits + GIE);
+		__no_operation();
+	}
+	__set_interrupt_state(int_state);
+	
+	Timer0_A4_Stop(TIMER0_A4_SENSOR);
+
+	AS_SPI_REN |=  AS_SDI_PIN;          // Pulldown on SDI pin required again
+}
+
+
+// *************************************************************************************************
+// @fn          as_burst_timeout
+// @brief       Called by Timer0_A4 when as_get_data() did not complete in time. Stop transfer 
+//				and disable sensor access. Timer0_A4 IRQ wakes up as_get_data().
+// @param       none
+// @return      none
+// *************************************************************************************************
+void as_burst_timeout(void)
+{
+	AS_IE_REG  &= ~AS_RX_IE;            // No more RX IRQs
+	AS_CSN_OUT |=  AS_CSN_PIN;          // Deselect acceleration sensor
+	as_ok = 0;
 }
 
+
 u8 as_get_x(void)
 {
 	if ((AS_PWR_OUT & AS_PWR_PIN) != AS_PWR_PIN) return 0;
@@ -387,5 +487,46 @@ u8 as_get_z(void)
 	return as_read_register(0x08);
 }
 
+// *************************************************************************************************
+// @fn          USCI_A0_ISR
+// @brief       Acceleration sensor SPI RX IRQ. Every odd byte is the echo of a register address
+//				and clocks in the data byte, every even byte is data and closes the CSN frame.
+// @param       none
+// @return      none
+// *************************************************************************************************
+#ifdef __GNUC__
+#include <signal.h>
+interrupt (USCI_A0_VECTOR) USCI_A0_ISR(void)
+#else
+#pragma vector=USCI_A0_VECTOR
+__interrupt void USCI_A0_ISR(void)
+#endif
+{
+	u8 rx = AS_RX_BUFFER;               // Read RX buffer, clears interrupt flag
+	u8 count = ++as_burst_count;
+
+	if (count & 1)
+	{
+		AS_TX_BUFFER = 0;               // Write dummy data to TX buffer
+		return;
+	}
+
+	AS_CSN_OUT |=  AS_CSN_PIN;          // Deselect acceleration sensor
+	*(as_burst_data + count/2 - 1) = rx;
+
+	if (count < AS_DATA_BYTES*2)
+	{
+		__delay_cycles(AS_CSN_GAP_CYCLES); // Keep CSN high between frames
+		AS_CSN_OUT &= ~AS_CSN_PIN;      // Select acceleration sensor for next register
+		AS_TX_BUFFER = (AS_DATA_REGISTER + count/2) << 2;
+		return;
+	}
+
+	// Transfer done, leave polled register access to the other functions
+	AS_IE_REG &= ~AS_RX_IE;
+	_BIC_SR_IRQ(LPM0_bits);
+}
+
+
 
 #endif
@@ -84,6 +84,8 @@ extern u8 as_get_z(void);
 #define AS_TX_IFG            (UCTXIFG)
 #define AS_RX_IFG            (UCRXIFG)
 #define AS_IRQ_REG           (UCA0IFG) 
+#define AS_IE_REG            (UCA0IE)
+#define AS_RX_IE             (UCRXIE)
 #define AS_SPI_CTL0          (UCA0CTL0)
 #define AS_SPI_CTL1          (UCA0CTL1) 
 #define AS_SPI_BR0           (UCA0BR0)
@@ -106,6 +108,17 @@ extern u8 as_get_z(void);
 // SPI timeout to detect sensor failure
 #define SPI_TIMEOUT				(1000u)
 
+// X/Y/Z data registers read by as_get_data(), one address + one data byte per register
+#define AS_DATA_REGISTER		(0x06u)
+#define AS_DATA_BYTES			(3u)
+
+// Longest time for as_get_data(), the 3 frames take about 0.1 ms at 400kHz SPI
+#define AS_BURST_TIMEOUT		(CONV_MS_TO_TICKS(2))
+
+// CSN high time between frames of as_get_data(), about as long as between two as_read_register()
+// calls. Must be at least 8 cycles.
+#define AS_CSN_GAP_CYCLES		(24u)
+
 
 // *************************************************************************************************
 // Global Variable section
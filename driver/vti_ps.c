@@ -53,7 +53,15 @@
 // *************************************************************************************************
 // Prototypes section
 u16 ps_read_register(u8 address, u8 mode);
+u8 ps_read_bytes(u8 address, u8 * data, u8 count);
+u32 ps_carry_lsb(u32 raw, u16 lsb);
 u8 ps_write_register(u8 address, u8 data);
+void ps_set_callback(void (*fptr)(u32 pa, u16 temperature));
+void ps_acquire(void);
+void ps_acquire_step(void);
+u8 is_ps_busy(void);
+u8 is_ps_ready(void);
+u8 ps_wait_ready(void);
 u8 ps_twi_read(u8 ack);
 void twi_delay(void);
 
@@ -81,6 +89,13 @@ static s16 hLast; // Last altitude estimate in normalized units b/H0/2^15
 // Global flag for proper pressure sensor operation
 u8 ps_ok;
 
+// Raw pressure (19 bit) of last sample and samples left until DATARD8 is read again
+static u32 ps_raw;
+static u8 ps_msb_age;
+
+// Non-blocking sample acquisition
+struct ps sPs;
+
 
 // *************************************************************************************************
 // Extern section
@@ -95,7 +110,7 @@ u8 ps_ok;
 // *************************************************************************************************
 void ps_init(void)
 {
-	volatile u8 success, status, eeprom, timeout;
+	volatile u8 status, eeprom;
 	
 	PS_INT_DIR &= ~PS_INT_PIN;            	// DRDY is input
 	PS_INT_IES &= ~PS_INT_PIN;				// Interrupt on DRDY rising edge
@@ -109,7 +124,7 @@ void ps_init(void)
 	Timer0_A4_Delay(CONV_MS_TO_TICKS(100));
 
 	// Reset pressure sensor -> powerdown sensor
-	success = ps_write_register(0x06, 0x01);   
+	ps_write_register(0x06, 0x01);   
 
 	// 100msec delay 
 	Timer0_A4_Delay(CONV_MS_TO_TICKS(100));
@@ -134,6 +149,9 @@ void ps_init(void)
 // *************************************************************************************************
 void ps_start(void)
 {
+	// First sample needs all pressure bits
+	ps_msb_age = 0;
+	
 	// Start sampling data in ultra low power mode 
 	ps_write_register(0x03, 0x0B);  
 }
@@ -148,11 +166,108 @@ void ps_start(void)
 // *************************************************************************************************
 void ps_stop(void)
 {
+	// Drop sample in progress
+	sPs.phase = PS_PHASE_IDLE;
+	
 	// Put sensor to standby
 	ps_write_register(0x03, 0x00);   
 }
 
 
+// *************************************************************************************************
+// @fn          ps_set_callback
+// @brief       Set consumer of samples read by ps_acquire.
+// @param       void (*fptr)(u32 pa, u16 temperature)		Called with pressure (Pa) and 
+//																temperature (10*K)
+// @return      none
+// *************************************************************************************************
+void ps_set_callback(void (*fptr)(u32 pa, u16 temperature))
+{
+	sPs.callback = fptr;
+}
+
+
+// *************************************************************************************************
+// @fn          ps_acquire
+// @brief       Start reading a sample after DRDY. The bus transfers are done one per main loop 
+//				pass by ps_acquire_step, so display and radio work runs in between.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void ps_acquire(void)
+{
+	// Sensor not ready or sample already in progress
+	if (((PS_INT_IN & PS_INT_PIN) == 0) || (sPs.phase != PS_PHASE_IDLE)) return;
+	
+	sPs.phase = PS_PHASE_TEMPERATURE;
+}
+
+
+// *************************************************************************************************
+// @fn          ps_acquire_step
+// @brief       Do next bus transfer of sample in progress. Temperature and pressure are read back 
+//				to back, the completed sample is passed to the callback.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void ps_acquire_step(void)
+{
+	u32 pa;
+	
+	switch (sPs.phase)
+	{
+		case PS_PHASE_TEMPERATURE:	
+					sPs.temperature = ps_get_temp();
+					sPs.phase = PS_PHASE_PRESSURE;
+					break;
+					
+		case PS_PHASE_PRESSURE:	
+					// Reading DATARD16 releases DRDY
+					pa = ps_get_pa();
+					sPs.phase = PS_PHASE_IDLE;
+					if (sPs.callback != 0) sPs.callback(pa, sPs.temperature);
+					break;
+	}
+}
+
+
+// *************************************************************************************************
+// @fn          is_ps_busy
+// @brief       Check for sample in progress.
+// @param       none
+// @return      u8		1=Bus transfers pending, 0=Idle
+// *************************************************************************************************
+u8 is_ps_busy(void)
+{
+	return (sPs.phase != PS_PHASE_IDLE);
+}
+
+
+// *************************************************************************************************
+// @fn          is_ps_ready
+// @brief       Check DRDY of pressure sensor.
+// @param       none
+// @return      u8		1=Conversion result available
+// *************************************************************************************************
+u8 is_ps_ready(void)
+{
+	return ((PS_INT_IN & PS_INT_PIN) != 0);
+}
+
+
+// *************************************************************************************************
+// @fn          ps_wait_ready
+// @brief       Wait in LPM3 for the first conversion after ps_start. DRDY IRQ must be enabled to 
+//				wake up the CPU.
+// @param       none
+// @return      u8		1=Conversion result available, 0=Sensor did not respond within PS_READY_TIMEOUT
+// *************************************************************************************************
+u8 ps_wait_ready(void)
+{
+	return (Timer0_A4_Wait(PS_READY_TIMEOUT, is_ps_ready));
+}
+
+
 
 // *************************************************************************************************
 // @fn          ps_twi_sda
@@ -322,13 +437,18 @@ u8 ps_write_register(u8 address, u8 data)
 
   ps_twi_sda(PS_TWI_SEND_START);			// Generate start condition
   
-  ps_twi_write((0x11<<1) | PS_TWI_WRITE); 	// Send 7bit device address 0x11 + write bit '0'
+  ps_twi_write((PS_TWI_ADDRESS<<1) | PS_TWI_WRITE); // Send 7bit device address 0x11 + write bit '0'
   success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
-  if (!success) return (0);
-  
-  ps_twi_write(address);					// Send 8bit register address
-  success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
-  if (!success) return (0);
+  if (success)
+  {
+    ps_twi_write(address);					// Send 8bit register address
+    success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
+  }
+  if (!success) 
+  {
+    ps_twi_sda(PS_TWI_SEND_STOP);			// Release bus
+    return (0);
+  }
 	
   ps_twi_write(data);						// Send 8bit data to register
   success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
@@ -342,71 +462,125 @@ u8 ps_write_register(u8 address, u8 data)
 
 
 // *************************************************************************************************
-// @fn          ps_read_register
-// @brief       Read a byte from the pressure sensor
+// @fn          ps_read_bytes
+// @brief       Read bytes from the pressure sensor in a single transaction. Device and register 
+//				address are sent once for all bytes. The bus is released also when the device 
+//				does not acknowledge.
 // @param       u8 address		Register address
-//				u8	mode		PS_TWI_8BIT_ACCESS, PS_TWI_16BIT_ACCESS
-// @return      u16			Register content
+//				u8 * data		Buffer for count bytes, MSB first
+//				u8 count		Number of bytes to read
+// @return      u8				1=Success, 0=No ACK from device
 // *************************************************************************************************
-u16 ps_read_register(u8 address, u8 mode)
+u8 ps_read_bytes(u8 address, u8 * data, u8 count)
 {
   u8 success;
-  u16 data = 0;
 
   ps_twi_sda(PS_TWI_SEND_START);			// Generate start condition
 
-  ps_twi_write((0x11<<1) | PS_TWI_WRITE); 	// Send 7bit device address 0x11 + write bit '0'
+  ps_twi_write((PS_TWI_ADDRESS<<1) | PS_TWI_WRITE); // Send 7bit device address 0x11 + write bit '0'
   success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
-  if (!success) return (0);
+  if (success)
+  {
+    ps_twi_write(address);					// Send 8bit register address
+    success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
+  }
+  if (success)
+  {
+    ps_twi_sda(PS_TWI_SEND_RESTART);		// Generate restart condition
+    ps_twi_write((PS_TWI_ADDRESS<<1) | PS_TWI_READ); // Send 7bit device address 0x11 + read bit '1'
+    success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
+  }
+  if (success)
+  {
+    // ACK all bytes but the last one
+    while (count-- > 0) *data++ = ps_twi_read(count != 0);
+  }
   
-  ps_twi_write(address);					// Send 8bit register address
-  success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
-  if (!success) return (0);
+  ps_twi_sda(PS_TWI_SEND_STOP);				// Generate stop condition
 
-  ps_twi_sda(PS_TWI_SEND_RESTART);			// Generate restart condition
+  return (success);
+}
+
+
+// *************************************************************************************************
+// @fn          ps_read_register
+// @brief       Read a byte from the pressure sensor
+// @param       u8 address		Register address
+//				u8	mode		PS_TWI_8BIT_ACCESS, PS_TWI_16BIT_ACCESS
+// @return      u16			Register content, 0 if device did not acknowledge
+// *************************************************************************************************
+u16 ps_read_register(u8 address, u8 mode)
+{
+  u8 data[2] = { 0, 0 };
 
-  ps_twi_write((0x11<<1) | PS_TWI_READ); 	// Send 7bit device address 0x11 + read bit '1'
-  success = ps_twi_sda(PS_TWI_CHECK_ACK);	// Check ACK from device
-  if (!success) return (0);
-	
   if (mode == PS_TWI_16BIT_ACCESS)
   {
-	  data =  ps_twi_read(1) << 8;			// Read MSB 8bit data from register
-	  data |= ps_twi_read(0);				// Read LSB 8bit data from register
+	  ps_read_bytes(address, data, 2);
+	  return (((u16)data[0] << 8) | data[1]);
   }
-  else
-  {
-	  data = ps_twi_read(0);				// Read 8bit data from register
-  }  
   
-  ps_twi_sda(PS_TWI_SEND_STOP);				// Generate stop condition
-
-  return (data);
+  ps_read_bytes(address, data, 1);
+  return (data[0]);
 }
 
 
 
+// *************************************************************************************************
+// @fn          ps_carry_lsb
+// @brief       Combine new DATARD16 bits with the 3 MSB of the last sample. A wrap of DATARD16 is
+//				carried into the MSB, see PS_MSB_REFRESH.
+// @param       u32 raw		Raw pressure (19 bit) of last sample
+//				u16 lsb		DATARD16 of new sample
+// @return      u32			Raw pressure (19 bit) of new sample
+// *************************************************************************************************
+u32 ps_carry_lsb(u32 raw, u16 lsb)
+{
+	return (raw + (s16)(lsb - (u16)raw));
+}
+
+
 // *************************************************************************************************
 // @fn          ps_get_pa
 // @brief       Read out pressure. Format is Pa. Range is 30000 .. 120000 Pa.
+//				Usually a single DATARD16 transfer, see PS_MSB_REFRESH. The last sample is 
+//				returned again when the device does not acknowledge.
 // @param       none
 // @return      u32		15-bit pressure sensor value (Pa)
 // *************************************************************************************************
 u32 ps_get_pa(void)
 {
-	volatile u32 data = 0;
+	u8 data[2] = { 0, 0 };
+	u8 success, msb;
+	u16 lsb;
 	
-	// Get 3 MSB from DATARD8 register
-	data = ps_read_register(0x7F, PS_TWI_8BIT_ACCESS);
-	data = ((data & 0x07) << 8) << 8;
-
-	// Get 16 LSB from DATARD16 register
-	data |= ps_read_register(0x80, PS_TWI_16BIT_ACCESS);
+	if (ps_msb_age == 0)
+	{
+		// Get 3 MSB from DATARD8 register - must be read before DATARD16
+		success = ps_read_bytes(0x7F, data, 1);
+		msb = data[0] & 0x07;
+		
+		// Get 16 LSB from DATARD16 register
+		success &= ps_read_bytes(0x80, data, 2);
+		lsb = ((u16)data[0] << 8) | data[1];
+		
+		if (success) ps_raw = ((u32)msb << 16) | lsb;
+		ps_msb_age = PS_MSB_REFRESH;
+	}
+	else
+	{
+		// Get 16 LSB from DATARD16 register and carry overflows into the 3 MSB of last sample
+		success = ps_read_bytes(0x80, data, 2);
+		lsb = ((u16)data[0] << 8) | data[1];
+		
+		if (success) ps_raw = ps_carry_lsb(ps_raw, lsb);
+	}
 	
-	// Convert decimal value to Pa
-	data = (data >> 2);
+	// Read all bits again after a failed transfer
+	if (success) ps_msb_age--;
+	else		 ps_msb_age = 0;
 	
-	return (data);
+	// Convert decimal value to Pa
+	return (ps_raw >> 2);
 }
 
 
@@ -47,6 +47,12 @@ extern void ps_start(void);
 extern void ps_stop(void);
 extern u32 ps_get_pa(void);
 extern u16 ps_get_temp(void);
+extern void ps_set_callback(void (*fptr)(u32 pa, u16 temperature));
+extern void ps_acquire(void);
+extern void ps_acquire_step(void);
+extern u8 is_ps_busy(void);
+extern u8 is_ps_ready(void);
+extern u8 ps_wait_ready(void);
 
 extern void init_pressure_table(void);
 extern void update_pressure_table(s16 href, u32 p_meas, u16 t_meas);
@@ -78,6 +84,8 @@ extern s16 conv_pa_to_altitude(u32 p_meas, u16 t_meas);
 #define PS_INT_PIN           (BIT6)
 
 // TWI defines
+// SCL and SDA are on PJ (JTAG pins), which cannot be routed to USCI_B0, so the bus is bit-banged
+#define PS_TWI_ADDRESS		(0x11u)
 #define PS_TWI_WRITE		(0u)
 #define PS_TWI_READ			(1u)
 
@@ -89,6 +97,14 @@ extern s16 conv_pa_to_altitude(u32 p_meas, u16 t_meas);
 #define PS_TWI_8BIT_ACCESS	(0u)
 #define PS_TWI_16BIT_ACCESS	(1u)
 
+// Longest wait for first conversion after ps_start. Ultra low power mode converts about once a second.
+#define PS_READY_TIMEOUT	(CONV_MS_TO_TICKS(1500u))
+
+// DATARD8 holds pressure bits 16..18, which change only every 16384 Pa. It is read every 16th sample,
+// in between a wrap of DATARD16 is carried over from the last sample. This is exact as long as 
+// pressure changes by less than 8192 Pa between two samples.
+#define PS_MSB_REFRESH		(16u)
+
 #define PS_TWI_SCL_HI		{ PS_TWI_OUT |=  PS_SCL_PIN; }
 #define PS_TWI_SCL_LO		{ PS_TWI_OUT &= ~PS_SCL_PIN; }
 #define PS_TWI_SDA_HI		{ PS_TWI_OUT |=  PS_SDA_PIN; }
@@ -100,6 +116,24 @@ extern s16 conv_pa_to_altitude(u32 p_meas, u16 t_meas);
 // *************************************************************************************************
 // Global Variable section
 
+// Acquisition phases - one bus transfer each
+#define PS_PHASE_IDLE		(0u)
+#define PS_PHASE_TEMPERATURE (1u)		// Read TEMPOUT
+#define PS_PHASE_PRESSURE	(2u)		// Read DATARD16 (and DATARD8), completes sample
+
+struct ps
+{
+	// PS_PHASE_xxx
+	u8		phase;
+	
+	// Temperature of sample in progress (10*K)
+	u16		temperature;
+	
+	// Consumer of completed samples
+	void	(*callback)(u32 pa, u16 temperature);
+};
+extern struct ps sPs;
+
 
 // *************************************************************************************************
 // Extern section
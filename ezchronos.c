@@ -51,6 +51,9 @@
 #include "buzzer.h"
 #include "ports.h"
 #include "timer.h"
+#include "rtc.h"
+#include "event.h"
+#include "retain.h"
 #include "pmm.h"
 #include "rf1a.h"
 
@@ -101,6 +104,7 @@ void init_application(void);
 void init_global_variables(void);
 void wakeup_event(void);
 void process_requests(void);
+void message_request(u8 request);
 void display_update(void);
 void idle_loop(void);
 void configure_ports(void);
@@ -122,9 +126,6 @@ void menu_skip_next(line_t line);
 // Variable holding system internal flags
 volatile s_system_flags sys;
 
-// Variable holding flags set by logic modules 
-volatile s_request_flags request;
-
 // Variable holding message flags
 volatile s_message_flags message;
 
@@ -160,6 +161,11 @@ int main(void)
 
 	// Assign initial value to global variables
 	init_global_variables();
+	
+#ifdef DEBUG
+	// Measure display routines while nothing else is running
+	display_benchmark();
+#endif
 
 #ifdef CONFIG_TEST
 	// Branch to welcome screen
@@ -171,17 +177,20 @@ int main(void)
 	// Main control loop: wait in low power mode until some event needs to be processed
 	while(1)
 	{
-		// When idle go to LPM3
-    	idle_loop();
+		// When idle go to LPM3 - stay awake while a sensor sample is read
+    	if (!is_ps_busy()) idle_loop();
 
-    	// Process wake-up events
-    	if (button.all_flags || sys.all_flags) wakeup_event();
-    	
-    	// Process actions requested by logic modules
-    	if (request.all_flags) process_requests();
+    	// Process actions requested by ISRs and logic modules
+    	if (is_event_pending()) process_requests();
     	
+    	// Process wake-up events
+    	if (sButton.event || sys.all_flags) wakeup_event();
+    	    	
     	// Before going to LPM3, update display
-    	if (display.all_flags) display_update();	
+    	if (display.all_flags || is_display_deferred()) display_update();	
+    	
+    	// One bus transfer of pending sensor sample per pass
+    	if (is_ps_busy()) ps_acquire_step();
  	}	
 }
 
@@ -199,9 +208,9 @@ void init_application(void)
 	// ---------------------------------------------------------------------
 	// Enable watchdog
 	
-	// Watchdog triggers after 16 seconds when not cleared
+	// Watchdog triggers after 256 seconds when not cleared - the clock wakes up only once a minute
 #ifdef USE_WATCHDOG		
-	WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK;
+	WDTCTL = WDTPW + WDTIS__8192K + WDTSSEL__ACLK;
 #else
 	WDTCTL = WDTPW + WDTHOLD;
 #endif
@@ -300,6 +309,14 @@ void init_application(void)
 	// Init buttons
 	init_buttons();
 
+	// ---------------------------------------------------------------------
+	// Check for warm reset while RTC_A may still be counting
+	retain_check();
+
+	// ---------------------------------------------------------------------
+	// Configure RTC_A calendar - time and date are set by init_global_variables()
+	rtc_init();
+
 	// ---------------------------------------------------------------------
 	// Configure Timer0 for use by the clock and delay functions
 	Timer0_Init();
@@ -332,11 +349,11 @@ void init_global_variables(void)
 	fptr_lcd_function_line2 = ptrMenu_L2->display_function;
 
 	// Init system flags
-	button.all_flags 	= 0;
+	sButton.event 		= 0;
 	sys.all_flags 		= 0;
-	request.all_flags 	= 0;
 	display.all_flags 	= 0;
 	message.all_flags	= 0;
+	event_reset();
 	
 	// Force full display update when starting up
 	display.flag.full_update = 1;
@@ -361,6 +378,9 @@ void init_global_variables(void)
 	}
 	#endif
 	
+	// Restore crystal calibration learned from previous time syncs
+	rtc_load_drift();
+	
 	// Set system time to default value
 	reset_clock();
 	
@@ -420,12 +440,18 @@ void init_global_variables(void)
 	
 	// Reset temperature measurement 
 	reset_temp_measurement();
+	
+	// Compensate crystal for current temperature
+	rtc_set_temperature(sTemp.degrees);
 
 	#ifdef CONFIG_BATTERY
 	// Reset battery measurement
 	reset_batt_measurement();
 	battery_measurement();
 	#endif
+	
+	// Continue with time, stopwatch, alarms and altitude reference from before a warm reset
+	retain_restore();
 }
 
 
@@ -441,7 +467,7 @@ void wakeup_event(void)
 	sys.flag.idle_timeout_enabled = 1;
 
 	// If buttons are locked, only display "buttons are locked" message
-	if (button.all_flags && sys.flag.lock_buttons)
+	if (sButton.event && sys.flag.lock_buttons)
 	{
 		// Show "buttons are locked" message synchronously with next second tick
 		if (!((BUTTON_NUM_IS_PRESSED && BUTTON_DOWN_IS_PRESSED) || BUTTON_BACKLIGHT_IS_PRESSED))
@@ -451,13 +477,13 @@ void wakeup_event(void)
 		}
 		
 		// Clear buttons
-		button.all_flags = 0;	
+		sButton.event = 0;	
 	}
 	// Process long button press event (while button is held)
-	else if (button.flag.star_long)
+	else if (sButton.event == (BUTTON_STAR | BUTTON_LONG))
 	{
 		// Clear button event
-		button.flag.star_long = 0;
+		sButton.event = 0;
 
 		// Call sub menu function
 		ptrMenu_L1->mx_function(LINE1);
@@ -465,10 +491,10 @@ void wakeup_event(void)
 		// Set display update flag
 		display.flag.full_update = 1;
 	}
-	else if (button.flag.up_long)
+	else if (sButton.event == (BUTTON_UP | BUTTON_LONG))
 	{
 		// Clear button event
-		button.flag.up_long = 0;
+		sButton.event = 0;
 
 		// Call sub menu function
 		ptrMenu_L1->ax_function(LINE1);
@@ -476,10 +502,10 @@ void wakeup_event(void)
 		// Set display update flag
 		display.flag.full_update = 1;
 	}
-	else if (button.flag.num_long)
+	else if (sButton.event == (BUTTON_NUM | BUTTON_LONG))
 	{
 		// Clear button event
-		button.flag.num_long = 0;
+		sButton.event = 0;
 		
 		// Call sub menu function
 		ptrMenu_L2->mx_function(LINE2);
@@ -487,10 +513,10 @@ void wakeup_event(void)
 		// Set display update flag
 		display.flag.full_update = 1;	
 	}
-	else if (button.flag.down_long)
+	else if (sButton.event == (BUTTON_DOWN | BUTTON_LONG))
 	{
 		// Clear button event
-		button.flag.down_long = 0;
+		sButton.event = 0;
 		
 		// Call sub menu function
 		ptrMenu_L2->ax_function(LINE2);
@@ -499,11 +525,11 @@ void wakeup_event(void)
 		display.flag.full_update = 1;	
 	}
 	// Process single button press event (after button was released)
-	else if (button.all_flags)
+	else if (sButton.event)
 	{
 		// M1 button event ---------------------------------------------------------------------
 		// (Short) Advance to next menu item
-		if(button.flag.star) 
+		if(sButton.event == BUTTON_STAR)  
 		{
 			//skip to next menu item
 			ptrMenu_L1->nx_function(LINE1);
@@ -511,12 +537,12 @@ void wakeup_event(void)
 			// Set Line1 display update flag
 			display.flag.line1_full_update = 1;
 
-			// Clear button flag
-			button.flag.star = 0;
+			// Clear button event
+			sButton.event = 0;
 		}
 		// NUM button event ---------------------------------------------------------------------
 		// (Short) Advance to next menu item
-		else if(button.flag.num) 
+		else if(sButton.event == BUTTON_NUM)  
 		{
 			//skip to next menu item
 			ptrMenu_L2->nx_function(LINE2);
@@ -524,12 +550,12 @@ void wakeup_event(void)
 			// Set Line2 display update flag
 			display.flag.line2_full_update = 1;
 
-			// Clear button flag
-			button.flag.num = 0;
+			// Clear button event
+			sButton.event = 0;
 		}	
 		// UP button event ---------------------------------------------------------------------
 		// Activate user function for Line1 menu item
-		else if(button.flag.up) 	
+		else if(sButton.event == BUTTON_UP) 	 	
 		{
 			// Call direct function
 			ptrMenu_L1->sx_function(LINE1);
@@ -537,12 +563,12 @@ void wakeup_event(void)
 			// Set Line1 display update flag
 			display.flag.line1_full_update = 1;
 	
-			// Clear button flag	
-			button.flag.up = 0;
+			// Clear button event	
+			sButton.event = 0;
 		}			
 		// DOWN button event ---------------------------------------------------------------------
 		// Activate user function for Line2 menu item
-		else if(button.flag.down) 	
+		else if(sButton.event == BUTTON_DOWN) 	 	
 		{
 			// Call direct function
 			ptrMenu_L2->sx_function(LINE2);
@@ -550,9 +576,12 @@ void wakeup_event(void)
 			// Set Line1 display update flag
 			display.flag.line2_full_update = 1;
 	
-			// Clear button flag	
-			button.flag.down = 0;
+			// Clear button event	
+			sButton.event = 0;
 		}			
+		
+		// Double-clicks (follow their second short press) and backlight are not bound in menu
+		sButton.event = 0;
 	}
 	
 	// Process internal events
@@ -579,53 +608,124 @@ void wakeup_event(void)
 
 // *************************************************************************************************
 // @fn          process_requests
-// @brief       Process requested actions outside ISR context.
+// @brief       Process events queued by ISRs and logic modules outside ISR context, oldest first.
+//				A button event is handed over in sButton.event. The events behind it wait in the 
+//				ring until the main loop or the nested loop of a logic module has cleared it.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void process_requests(void)
 {
-	// Do temperature measurement
-	if (request.flag.temperature_measurement) temperature_measurement(FILTER_ON);
+	s_event ev;
+	
+	while ((sButton.event == 0) && event_pop(&ev))
+	{
+		switch (ev.type)
+		{
+			// Button gesture, handled by wakeup_event() or a nested loop of a logic module
+			case EVENT_BUTTON:			sButton.event = ev.arg;
+										break;
+	
+			// Redraw requests of ISRs - display flags are written only outside ISR context
+			case EVENT_TIME:			display.flag.update_time = 1;
+										break;
+			case EVENT_DATE:			display.flag.update_date = 1;
+										break;
+			case EVENT_STOPWATCH:		display.flag.update_stopwatch = 1;
+										break;
+			case EVENT_REDRAW:			display.flag.full_update = 1;
+										break;
+	
+			// Message requests and clock tick that shows / erases the message
+			case EVENT_MESSAGE:			message_request(ev.arg);
+										break;
+	
+			// Do temperature measurement and compensate crystal
+			case EVENT_TEMPERATURE:		temperature_measurement(ev.arg);
+										rtc_set_temperature(sTemp.degrees);
+										break;
 	
-	// Do pressure measurement
 #ifdef CONFIG_ALTITUDE
-	#ifdef DONT_USE_FILTER
-  		if (request.flag.altitude_measurement) do_altitude_measurement(FILTER_OFF);
-	#else
-		if (request.flag.altitude_measurement) do_altitude_measurement(FILTER_ON);
-	#endif
+			// Start reading pressure sample, bus transfers follow in main loop
+			case EVENT_ALTITUDE:		ps_acquire();
+										break;
 #endif
-	
 
+#ifdef FEATURE_PROVIDE_ACCEL
+			// Do acceleration measurement
+			case EVENT_ACCELERATION:	do_acceleration_measurement();
+										break;
+#endif
 	
-	#ifdef FEATURE_PROVIDE_ACCEL
-	// Do acceleration measurement
-	if (request.flag.acceleration_measurement) do_acceleration_measurement();
-	#endif
-	
-	#ifdef CONFIG_BATTERY
-	// Do voltage measurement
-	if (request.flag.voltage_measurement) battery_measurement();
-	#endif
+#ifdef CONFIG_BATTERY
+			// Do voltage measurement
+			case EVENT_VOLTAGE:			battery_measurement();
+										break;
+#endif
 	
-	#ifdef CONFIG_ALARM  // N8VI NOTE eggtimer may want in on this
-	// Generate alarm (two signals every second)
-	if (request.flag.buzzer) start_buzzer(2, BUZZER_ON_TICKS, BUZZER_OFF_TICKS);
-	#endif
+#ifdef CONFIG_ALARM  // N8VI NOTE eggtimer may want in on this
+			// Generate alarm (two signals every second)
+			case EVENT_BUZZER:			start_buzzer(2, BUZZER_ON_TICKS, BUZZER_OFF_TICKS);
+										break;
+										
+			// Ring due alarms and arm next one
+			case EVENT_ALARM:			check_alarm();
+										break;
+#endif
 	
 #ifdef CONFIG_STRENGTH
-	if (request.flag.strength_buzzer && strength_data.num_beeps != 0) 
-	{
-		start_buzzer(strength_data.num_beeps, 
-			     STRENGTH_BUZZER_ON_TICKS, 
-			     STRENGTH_BUZZER_OFF_TICKS);
-		strength_data.num_beeps = 0;
-	}
+			case EVENT_STRENGTH_BUZZER:	if (strength_data.num_beeps != 0) 
+										{
+											start_buzzer(strength_data.num_beeps, 
+											     STRENGTH_BUZZER_ON_TICKS, 
+											     STRENGTH_BUZZER_OFF_TICKS);
+											strength_data.num_beeps = 0;
+										}
+										break;
 #endif
+		}
+	}
+}
+
 
-	// Reset request flag
-	request.all_flags = 0;
+// *************************************************************************************************
+// @fn          message_request
+// @brief       Prepare message requested by an ISR, or show / erase message at clock tick. Message 
+//				flags are written only outside ISR context.
+// @param       u8 request		MESSAGE_xxx
+// @return      none
+// *************************************************************************************************
+void message_request(u8 request)
+{
+	switch (request)
+	{
+		case MESSAGE_TICK:			if (message.flag.prepare)
+									{
+										message.flag.prepare = 0;
+										message.flag.show    = 1;
+									}
+									else if (message.flag.erase) // message cycle is over, so erase it
+									{
+										message.flag.erase       = 0;
+										message.flag.block_line1 = 0;
+										message.flag.block_line2 = 0;
+										display.flag.full_update = 1;
+									}
+									return;
+		case MESSAGE_LOBATT:		message.flag.type_lobatt 		= 1;
+									break;
+		case MESSAGE_LOCKED:		message.flag.type_locked 		= 1;
+									break;
+		case MESSAGE_UNLOCKED:		message.flag.type_unlocked 		= 1;
+									break;
+		case MESSAGE_NO_BEEP_ON:	message.flag.type_no_beep_on 	= 1;
+									break;
+		case MESSAGE_NO_BEEP_OFF:	message.flag.type_no_beep_off 	= 1;
+									break;
+	}
+	
+	// Show message synchronously with next clock tick
+	message.flag.prepare = 1;
 }
 
 
@@ -666,6 +766,10 @@ void display_update(void)
 		fptr_lcd_function_line2(LINE2, DISPLAY_LINE_UPDATE_PARTIAL);
 	}
 
+	// ---------------------------------------------------------------------
+	// Draw jobs queued in ISR context
+	display_deferred();
+
 	// ---------------------------------------------------------------------
 	// If message text should be displayed
 	if (message.flag.show)
@@ -746,6 +850,9 @@ void display_update(void)
 // *************************************************************************************************
 void to_lpm(void)
 {
+	// Show what has been drawn since last LPM entry
+	display_commit();
+
 	// Go to LPM3
 	_BIS_SR(LPM3_bits + GIE); 
 	__no_operation();
@@ -754,19 +861,38 @@ void to_lpm(void)
 
 // *************************************************************************************************
 // @fn          idle_loop
-// @brief       Go to LPM. Service watchdog timer when waking up.
+// @brief       Go to LPM. Service watchdog timer and take queued events when waking up.
+//				Only modules that are active arm a clock tick deadline before LPM is entered.
+//				Nested loops of logic modules call this function, too, and find their next 
+//				button event in sButton.event.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void idle_loop(void)
 {
-	// To low power mode
-	to_lpm();
+	// Arm clock tick deadlines of all active modules
+	Timer0_A0_Refresh();
+
+	// Stay awake while events can be taken - check with IRQs off, so an event queued right 
+	// before LPM entry still ends LPM
+	__disable_interrupt();
+	if ((sButton.event == 0) && is_event_pending())
+	{
+		__enable_interrupt();
+	}
+	else
+	{
+		// To low power mode
+		to_lpm();
+	}
 
 #ifdef USE_WATCHDOG
-	// Service watchdog (reset counter)
-	WDTCTL = (WDTCTL &0xff) | WDTPW | WDTCNTCL;
+	// Service watchdog (reset counter) - radio loops may have left the 16 sec interval set
+	WDTCTL = WDTPW + WDTIS__8192K + WDTSSEL__ACLK + WDTCNTCL;
 #endif
+	
+	// Take queued events
+	process_requests();
 }
 
 
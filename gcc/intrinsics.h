@@ -18,6 +18,13 @@ extern "C"
   /* Insert a delay with a specific number of cycles. */
   void __delay_cycles(unsigned long __cycles);
 
+  /* Decimal (BCD) addition of two packed 8-digit values, as IAR __bcd_add_long. */
+  static inline unsigned long __bcd_add_long(unsigned long __a, unsigned long __b)
+  {
+    __asm__("clrc\n\tdadd %A1, %A0\n\tdadd %B1, %B0" : "+r" (__a) : "r" (__b));
+    return __a;
+  }
+
 #ifdef __cplusplus
 }
 #endif
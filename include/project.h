@@ -64,6 +64,14 @@
 #define FILTER_OFF						(0u)
 #define FILTER_ON						(1u)
 
+// Messages requested by ISRs, argument of EVENT_MESSAGE
+#define MESSAGE_TICK					(0u)	// Clock tick: show prepared message or erase shown one
+#define MESSAGE_LOBATT					(1u)
+#define MESSAGE_LOCKED					(2u)
+#define MESSAGE_UNLOCKED				(3u)
+#define MESSAGE_NO_BEEP_ON				(4u)
+#define MESSAGE_NO_BEEP_OFF				(5u)
+
 
 // *************************************************************************************************
 // Macro section
@@ -109,25 +117,6 @@ typedef union
 extern volatile s_system_flags sys;
 
 
-// Set of request flags
-typedef union
-{
-  struct
-  {
-    u16 temperature_measurement 	: 1;    // 1 = Measure temperature
-    u16 voltage_measurement    		: 1;    // 1 = Measure voltage
-    u16 altitude_measurement    	: 1;    // 1 = Measure air pressure
-    u16	acceleration_measurement	: 1; 	// 1 = Measure acceleration
-    u16 buzzer   			: 1;    // 1 = Output buzzer for alarm
-#ifdef CONFIG_STRENGTH
-    u16 strength_buzzer 		: 1;    // 1 = Output buzzer from strength_data
-#endif
-  } flag;
-  u16 all_flags;            // Shortcut to all display flags (for reset)
-} s_request_flags;
-extern volatile s_request_flags request;
-
-
 // Set of message flags
 typedef union
 {
@@ -178,9 +167,12 @@ extern volatile s_message_flags message;
   #define SIMPLICITI_TX_ONLY_REQ
 #endif
 
-#if defined(CONFIG_INFOMEM) &&  !defined(CONFIG_SIDEREAL)
-	//undefine feature if it is not used by any option
-	#undef CONFIG_INFOMEM
+#if defined (CONFIG_SIDEREAL)
+  #define FEATURE_VCLOCK
+#endif
+
+#if defined (CONFIG_STOP_WATCH) || defined (CONFIG_EGGTIMER) || defined (CONFIG_STRENGTH)
+  #define FEATURE_CHRONO
 #endif
 
 #endif /*PROJECT_H_*/
@@ -47,15 +47,24 @@
 #include "display.h"
 #include "buzzer.h"
 #include "ports.h"
+#include "rtc.h"
+#include "calendar.h"
+#include "retain.h"
+#ifdef CONFIG_INFOMEM
+#include "infomem.h"
+#endif
 
 // logic
 #include "alarm.h"
 #include "clock.h"
+#include "date.h"
 #include "user.h"
 
 
 // *************************************************************************************************
 // Prototypes section
+void alarm_load(void);
+void display_selection_Alarm(u8 segments, u32 index, u8 digits, u8 blanks, u8 dummy);
 
 
 // *************************************************************************************************
@@ -66,51 +75,210 @@
 // Global Variable section
 struct alarm sAlarm;
 
+// Alarm menu presets: weekday mask, mode and LINE2 text
+const u8 alarm_preset_days[ALARM_PRESETS] = 
+{
+	ALARM_DAYS_OFF, ALARM_DAYS_DAILY, ALARM_DAYS_WORK, ALARM_DAYS_WEEKEND, ALARM_DAYS_DAILY
+};
+const u8 selection_Alarm[ALARM_PRESETS][6] =
+{
+	"  OFF", "DAILY", " WORK", "WKEND", " ONCE"
+};
+
 
 // *************************************************************************************************
 // Extern section
 
 
 // *************************************************************************************************
-// @fn          clearalarmData
-// @brief       Resets alarmData to 06:30
+// @fn          reset_alarm
+// @brief       Restore alarm entries from information memory. Defaults to a daily alarm at 06:30.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void reset_alarm(void) 
 {
-	// Default alarm time 06:30
-	sAlarm.hour   = 06;
-	sAlarm.minute = 30;
+	u8 i;
+	
+	// Default alarm time 06:30, other entries off
+	for (i = 0; i < ALARM_ENTRIES; i++)
+	{
+		sAlarm.entry[i].hour   = 06;
+		sAlarm.entry[i].minute = 30;
+		sAlarm.entry[i].days   = ALARM_DAYS_OFF;
+		sAlarm.entry[i].mode   = ALARM_REPEAT;
+	}
+	sAlarm.entry[0].days = ALARM_DAYS_DAILY;
+	sAlarm.index = 0;
 
 	// Alarm is initially off	
 	sAlarm.duration = ALARM_ON_DURATION;
 	sAlarm.state 	= ALARM_DISABLED;
 	sAlarm.hourly 	= ALARM_DISABLED;
+	
+	alarm_load();
+	alarm_schedule();
+}
+
+
+// *************************************************************************************************
+// @fn          alarm_load
+// @brief       Read switches and entries stored by alarm_save.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void alarm_load(void)
+{
+#ifdef CONFIG_INFOMEM
+	u16 data[ALARM_INFOMEM_WORDS];
+	u8 * src = (u8 *)&data[1];
+	u8 * dst = (u8 *)sAlarm.entry;
+	u8 i;
+	
+	if (infomem_app_amount(ALARM_INFOMEM_ID) < ALARM_INFOMEM_WORDS) return;
+	infomem_app_read(ALARM_INFOMEM_ID, data, ALARM_INFOMEM_WORDS, 0);
+	
+	if (data[0] & 0x01) sAlarm.state = ALARM_ENABLED;
+	if (data[0] & 0x02) sAlarm.hourly = ALARM_ENABLED;
+	for (i = 0; i < sizeof(sAlarm.entry); i++) dst[i] = src[i];
+#endif
+}
+
+
+// *************************************************************************************************
+// @fn          alarm_save
+// @brief       Keep switches and entries over battery change and warm reset.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void alarm_save(void)
+{
+#ifdef CONFIG_INFOMEM
+	u16 data[ALARM_INFOMEM_WORDS];
+	u8 * src = (u8 *)sAlarm.entry;
+	u8 * dst = (u8 *)&data[1];
+	u8 i;
+	
+	data[0] = 0;
+	if (sAlarm.state != ALARM_DISABLED) data[0] |= 0x01;
+	if (sAlarm.hourly == ALARM_ENABLED) data[0] |= 0x02;
+	for (i = 0; i < sizeof(sAlarm.entry); i++) dst[i] = src[i];
+	
+	infomem_app_replace(ALARM_INFOMEM_ID, data, ALARM_INFOMEM_WORDS);
+#endif
+	retain_save();
+}
+
+
+// *************************************************************************************************
+// @fn          alarm_schedule
+// @brief       Find the next time any entry rings and arm the RTC_A alarm for exactly that date 
+//				and time. Must be called whenever entries, alarm state or the clock change.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void alarm_schedule(void)
+{
+	struct calendar next;
+	u32 now, midnight, fire;
+	u16 today;
+	u8 i, d, weekday;
+
+	sAlarm.next 	 = 0;
+	sAlarm.next_mask = 0;
+	
+	if (sAlarm.state != ALARM_DISABLED)
+	{
+		now 	 = calendar_now();
+		today 	 = calendar_days(sDate.year, sDate.month, sDate.day);
+		weekday  = calendar_weekday(today);
+		midnight = (u32)today * CALENDAR_DAY;
+		
+		for (i = 0; i < ALARM_ENTRIES; i++)
+		{
+			if (sAlarm.entry[i].days == ALARM_DAYS_OFF) continue;
+			
+			// First enabled weekday after now - a week later at most if only today is enabled
+			fire = midnight + sAlarm.entry[i].hour * 3600ul + sAlarm.entry[i].minute * 60ul;
+			for (d = 0; d <= 7; d++)
+			{
+				if ((sAlarm.entry[i].days & (1u << ((weekday + d) % 7u))) && (fire > now)) break;
+				fire += CALENDAR_DAY;
+			}
+			
+			if ((sAlarm.next == 0) || (fire < sAlarm.next))
+			{
+				sAlarm.next 	 = fire;
+				sAlarm.next_mask = 1u << i;
+			}
+			else if (fire == sAlarm.next)
+			{
+				sAlarm.next_mask |= 1u << i;
+			}
+		}
+	}
+	
+	if (sAlarm.next == 0)
+	{
+		rtc_disable_alarm();
+	}
+	else
+	{
+		// Day of month is unique within the next 8 days, so RTC_A matches only once
+		calendar_split(sAlarm.next, &next);
+		rtc_set_alarm(next.day, next.hour, next.minute);
+	}
+}
+
+
+// *************************************************************************************************
+// @fn          alarm_set_time
+// @brief       Set time of an entry and reschedule.
+// @param       u8 index		0 .. ALARM_ENTRIES-1
+//				u8 hour			0 .. 23
+//				u8 minute		0 .. 59
+// @return      none
+// *************************************************************************************************
+void alarm_set_time(u8 index, u8 hour, u8 minute)
+{
+	if ((index >= ALARM_ENTRIES) || (hour > 23) || (minute > 59)) return;
+	
+	sAlarm.entry[index].hour   = hour;
+	sAlarm.entry[index].minute = minute;
+	alarm_schedule();
+	alarm_save();
 }
 
 
 // *************************************************************************************************
 // @fn          check_alarm
-// @brief       Check if current time matches alarm time
+// @brief       Called for EVENT_ALARM when RTC_A alarm matched. Rings the due entries, switches off
+//				one-shot entries and arms the next alarm.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void check_alarm(void) 
 {
-	// Return if alarm is not enabled
-	if (sAlarm.state != ALARM_ENABLED) return;
+	u8 i;
+	u8 changed = 0;
 	
-	// Compare current time and alarm time
-	// Start with minutes - only 1/60 probability to match
-	if (sTime.minute == sAlarm.minute)
+	// Ignore stale match
+	if ((sAlarm.next == 0) || (calendar_now() < sAlarm.next)) return;
+	
+	for (i = 0; i < ALARM_ENTRIES; i++)
 	{
-		if (sTime.hour == sAlarm.hour)
+		if ((sAlarm.next_mask & (1u << i)) && (sAlarm.entry[i].mode == ALARM_ONCE))
 		{
-			// Indicate that alarm is beeping
-			sAlarm.state = ALARM_ON;
+			sAlarm.entry[i].days = ALARM_DAYS_OFF;
+			changed = 1;
 		}
 	}
+	
+	// Indicate that alarm is beeping
+	if (sAlarm.state == ALARM_ENABLED) sAlarm.state = ALARM_ON;
+	
+	alarm_schedule();
+	if (changed) alarm_save();
 }	
 
 
@@ -130,6 +298,21 @@ void stop_alarm(void)
 }	
 
 
+// *************************************************************************************************
+// @fn          display_selection_Alarm
+// @brief       Display alarm preset.
+// @param       u8 segments			Target segments where to display information
+//				u32 index			ALARM_PRESET_xxx
+//				u8 digits			Not used
+//				u8 blanks			Not used
+// @return      none
+// *************************************************************************************************
+void display_selection_Alarm(u8 segments, u32 index, u8 digits, u8 blanks, u8 dummy)
+{
+	if (index < ALARM_PRESETS) display_chars(segments, (u8 *)selection_Alarm[index], SEG_ON_BLINK_ON);
+}
+
+
 // *************************************************************************************************
 // @fn          sx_alarm
 // @brief       Sx button turns alarm on/off.
@@ -139,7 +322,7 @@ void stop_alarm(void)
 void sx_alarm(u8 line)
 {
 	// UP: Cycle through alarm modes
-	if(button.flag.up)
+	if(sButton.event == BUTTON_UP)
 	{
 		// Toggle alarm state
 		if (sAlarm.state == ALARM_DISABLED) {
@@ -169,31 +352,57 @@ void sx_alarm(u8 line)
 				message.flag.type_alarm_off_chime_off = 1;
 			}
 		}
+		
+		// RTC_A alarm is armed only while alarm is on
+		alarm_schedule();
+		alarm_save();
 	}
 }
 
 
 // *************************************************************************************************
 // @fn          mx_alarm
-// @brief       Set alarm time.
+// @brief       Select alarm entry, then set its time and weekdays.
 // @param       u8 line		LINE1
 // @return      none
 // *************************************************************************************************
 void mx_alarm(u8 line)
 {
 	u8 select;
+	u8 i;
+	s32 index;
 	s32 hours;
 	s32 minutes;
+	s32 preset;
 	u8 * str;
 	
 	// Clear display
 	clear_display_all();
 
+	// Select entry (LINE2)
+	index = sAlarm.index + 1;
+	display_chars(LCD_SEG_L2_4_2, (u8 *)"ALM", SEG_ON);
+	set_value(&index, 1, 0, 1, ALARM_ENTRIES, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L2_0, display_value1);
+	index--;
+	
 	// Keep global values in case new values are discarded
-	hours 		= sAlarm.hour;
-	minutes 	= sAlarm.minute;
+	hours 		= sAlarm.entry[index].hour;
+	minutes 	= sAlarm.entry[index].minute;
+	preset 		= ALARM_PRESET_OFF;
+	if (sAlarm.entry[index].mode == ALARM_ONCE) 
+	{
+		if (sAlarm.entry[index].days != ALARM_DAYS_OFF) preset = ALARM_PRESET_ONCE;
+	}
+	else
+	{
+		for (i = ALARM_PRESET_DAILY; i <= ALARM_PRESET_WEEKEND; i++)
+		{
+			if (sAlarm.entry[index].days == alarm_preset_days[i]) preset = i;
+		}
+	}
 
-	// Display HH:MM (LINE1) 
+	// Display HH:MM (LINE1) and preset (LINE2)
+	clear_line(LINE2);
 	str = itoa(hours, 2, 0);
 	display_chars(LCD_SEG_L1_3_2, str, SEG_ON);
 	display_symbol(LCD_SEG_L1_COL, SEG_ON);
@@ -201,8 +410,7 @@ void mx_alarm(u8 line)
 	str = itoa(minutes, 2, 0);
 	display_chars(LCD_SEG_L1_1_0, str, SEG_ON);
 	
-	// Display "ALARM" (LINE2)
-//	display_chars(LCD_SEG_L2_4_0, (u8 *)"ALARM", SEG_ON);
+	display_chars(LCD_SEG_L2_4_0, (u8 *)selection_Alarm[preset], SEG_ON);
 		
 	// Init value index
 	select = 0;	
@@ -214,11 +422,17 @@ void mx_alarm(u8 line)
 	  if (sys.flag.idle_timeout) break;
 
 	  // STAR (short): save, then exit
-	  if (button.flag.star)
+	  if (sButton.event == BUTTON_STAR)
 	  {
-	    // Store local variables in global alarm time
-	    sAlarm.hour = hours;
-	    sAlarm.minute = minutes;
+	    // Store local variables in alarm entry
+	    sAlarm.index = index;
+	    sAlarm.entry[index].hour   = hours;
+	    sAlarm.entry[index].minute = minutes;
+	    sAlarm.entry[index].days   = alarm_preset_days[preset];
+	    if (preset == ALARM_PRESET_ONCE) sAlarm.entry[index].mode = ALARM_ONCE;
+	    else							 sAlarm.entry[index].mode = ALARM_REPEAT;
+	    alarm_schedule();
+	    alarm_save();
 	    // Set display update flag
 	    display.flag.line1_full_update = 1;
 	    break;
@@ -233,13 +447,18 @@ void mx_alarm(u8 line)
 
 	  case 1:		// Set minutes
 	    set_value(&minutes, 2, 0, 0, 59, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0, display_value1);
+	    select = 2;
+	    break;
+	    
+	  case 2:		// Set weekdays
+	    set_value(&preset, 1, 0, 0, ALARM_PRESETS - 1, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_SELECTION + SETVALUE_NEXT_VALUE, LCD_SEG_L2_4_0, display_selection_Alarm);
 	    select = 0;
 	    break;
 	  }
 	}
 
 	// Clear button flag
-	button.all_flags = 0;
+	sButton.event = 0;
 
 	// Indicate to display function that new value is available
 	display.flag.update_alarm = 1;
@@ -258,8 +477,8 @@ void display_alarm(u8 line, u8 update)
 	
 	if (update == DISPLAY_LINE_UPDATE_FULL)			
 	{
-	  display_hours_12_or_24(switch_seg(line, LCD_SEG_L1_3_2, LCD_SEG_L2_3_2), sAlarm.hour, 2, 1, SEG_ON);
-	  display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sAlarm.minute, 2, 0), SEG_ON);
+	  display_hours_12_or_24(switch_seg(line, LCD_SEG_L1_3_2, LCD_SEG_L2_3_2), sAlarm.entry[sAlarm.index].hour, 2, 1, SEG_ON);
+	  display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sAlarm.entry[sAlarm.index].minute, 2, 0), SEG_ON);
 	  display_symbol(switch_seg(line, LCD_SEG_L1_COL, LCD_SEG_L2_COL0), SEG_ON);
 
 	  // Show blinking alarm icon
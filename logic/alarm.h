@@ -33,6 +33,9 @@
 //
 // *************************************************************************************************
 
+#ifndef ALARM_H_
+#define ALARM_H_
+
 
 // *************************************************************************************************
 // Include section
@@ -45,6 +48,9 @@
 extern void reset_alarm(void);
 extern void check_alarm(void);
 extern void stop_alarm(void);
+extern void alarm_schedule(void);
+extern void alarm_set_time(u8 index, u8 hour, u8 minute);
+extern void alarm_save(void);
 
 // menu functions
 extern void sx_alarm(u8 line);
@@ -63,9 +69,46 @@ extern void display_alarm(u8 line, u8 update);
 // Keep alarm for 10 on-off cycles
 #define ALARM_ON_DURATION	(10u)
 
+// Number of alarm entries
+#define ALARM_ENTRIES		(4u)
+
+// Weekday mask of an entry, bit 0 = Sunday as returned by calendar_weekday()
+#define ALARM_DAYS_OFF		(0x00u)
+#define ALARM_DAYS_DAILY	(0x7Fu)
+#define ALARM_DAYS_WORK		(0x3Eu)		// Monday .. Friday
+#define ALARM_DAYS_WEEKEND	(0x41u)		// Saturday, Sunday
+
+// Entry modes
+#define ALARM_REPEAT		(0u)
+#define ALARM_ONCE			(1u)		// Entry switches itself off after ringing
+
+// Alarm menu presets (weekday mask and mode)
+#define ALARM_PRESET_OFF	(0u)
+#define ALARM_PRESET_DAILY	(1u)
+#define ALARM_PRESET_WORK	(2u)
+#define ALARM_PRESET_WEEKEND (3u)
+#define ALARM_PRESET_ONCE	(4u)
+#define ALARM_PRESETS		(5u)
+
+// Persistent settings: one word for switches, then the entries
+#define ALARM_INFOMEM_ID	(0x12)
+#define ALARM_INFOMEM_WORDS	(1u + ALARM_ENTRIES * sizeof(struct alarm_entry) / 2u)
+
 
 // *************************************************************************************************
 // Global Variable section
+struct alarm_entry
+{
+	// Alarm hour
+	u8 hour;
+	// Alarm minute
+	u8 minute;
+	// Weekdays to ring on, ALARM_DAYS_OFF disables the entry
+	u8 days;
+	// ALARM_REPEAT, ALARM_ONCE
+	u8 mode;
+};
+
 struct alarm
 {
 	// ALARM_DISABLED, ALARM_ENABLED, ALARM_ON
@@ -74,10 +117,14 @@ struct alarm
 	u8 hourly;
 	// Alarm duration
 	u8 duration;
-	// Alarm hour
-	u8 hour;
-	// Alarm minute
-	u8 minute;
+	// Entry shown and edited in the alarm menu
+	u8 index;
+	// Alarm entries
+	struct alarm_entry entry[ALARM_ENTRIES];
+	// Next time any entry rings (seconds since calendar epoch), 0 = none
+	u32 next;
+	// Entries ringing at next - bit per entry
+	u8 next_mask;
 };
 extern struct alarm sAlarm;
 
@@ -85,3 +132,5 @@ extern struct alarm sAlarm;
 // *************************************************************************************************
 // Extern section
 
+
+#endif /*ALARM_H_*/
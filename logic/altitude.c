@@ -50,6 +50,7 @@
 #include "vti_ps.h"
 #include "ports.h"
 #include "timer.h"
+#include "retain.h"
 
 // logic
 #include "user.h"
@@ -95,6 +96,9 @@ void reset_altitude_measurement(void)
 	// Set default altitude value
 	sAlt.altitude		= 0;
 	
+	// Samples read in the background after DRDY
+	ps_set_callback(altitude_sample);
+	
 	// Pressure sensor ok?
 	if (ps_ok)
 	{
@@ -180,8 +184,17 @@ void start_altitude_measurement(void)
 		// Set timeout counter only if sensor status was OK
 		sAlt.timeout = ALTITUDE_MEASUREMENT_TIMEOUT;
 
+		// Sleep until first conversion is done
+		if (!ps_wait_ready())
+		{
+			// Sensor does not respond - keep it off until next reset
+			stop_altitude_measurement();
+			ps_ok = 0;
+			display_chars(LCD_SEG_L1_2_0, (u8*)"ERR", SEG_ON);
+			return;
+		}
+
 		// Get updated altitude
-		while((PS_INT_IN & PS_INT_PIN) == 0); 
 		do_altitude_measurement(FILTER_OFF);
 	}
 }
@@ -213,22 +226,55 @@ void stop_altitude_measurement(void)
 
 // *************************************************************************************************
 // @fn          do_altitude_measurement
-// @brief       Perform single altitude measurement
-// @param       none
+// @brief       Perform single altitude measurement, blocking until both sensor reads are done
+// @param       u8 filter		FILTER_ON, FILTER_OFF
 // @return      none
 // *************************************************************************************************
 void do_altitude_measurement(u8 filter)
 {
-	volatile u32 pressure;
-
+	u16 temperature;
+	
 	// If sensor is not ready, skip data read	
 	if ((PS_INT_IN & PS_INT_PIN) == 0) return;
 		
 	// Get temperature (format is *10?K) from sensor
-	sAlt.temperature = ps_get_temp();
+	temperature = ps_get_temp();
 
 	// Get pressure (format is 1Pa) from sensor
-	pressure = ps_get_pa();	
+	altitude_process(ps_get_pa(), temperature, filter);
+}
+
+
+// *************************************************************************************************
+// @fn          altitude_sample
+// @brief       Consumer of samples read in the background by ps_acquire.
+// @param       u32 pa				Pressure (Pa)
+//				u16 temperature		Temperature (10*K)
+// @return      none
+// *************************************************************************************************
+void altitude_sample(u32 pa, u16 temperature)
+{
+#ifdef DONT_USE_FILTER
+	altitude_process(pa, temperature, FILTER_OFF);
+#else
+	altitude_process(pa, temperature, FILTER_ON);
+#endif
+}
+
+
+// *************************************************************************************************
+// @fn          altitude_process
+// @brief       Filter pressure and convert sample to altitude
+// @param       u32 pa				Pressure (Pa)
+//				u16 temperature		Temperature (10*K)
+//				u8 filter			FILTER_ON, FILTER_OFF
+// @return      none
+// *************************************************************************************************
+void altitude_process(u32 pa, u16 temperature, u8 filter)
+{
+	volatile u32 pressure = pa;
+
+	sAlt.temperature = temperature;
 		
 	// Store measured pressure value
 	if (filter == FILTER_OFF) //sAlt.pressure == 0) 
@@ -262,6 +308,27 @@ void do_altitude_measurement(u8 filter)
 }
 
 
+// *************************************************************************************************
+// @fn          set_altitude_reference
+// @brief       Calibrate pressure table to a known altitude and keep the reference point, so the 
+//				table can be rebuilt after a warm reset.
+// @param       s16 altitude		Reference altitude
+//				u32 pressure		Pressure (Pa) at reference altitude
+//				u16 temperature		Temperature (10*K)
+// @return      none
+// *************************************************************************************************
+void set_altitude_reference(s16 altitude, u32 pressure, u16 temperature)
+{
+	sAlt.ref_altitude	 = altitude;
+	sAlt.ref_pressure	 = pressure;
+	sAlt.ref_temperature = temperature;
+	
+	update_pressure_table(altitude, pressure, temperature);
+	
+	retain_save();
+}
+
+
 // *************************************************************************************************
 // @fn          sx_altitude
 // @brief       Altitude direct function. Sx restarts altitude measurement.
@@ -288,7 +355,7 @@ void ax_altitude(u8 line)
 	// Restart altitude measurement 
 	//reset_altitude_measurement();
 	sAlt.altitude=0;
-	update_pressure_table(sAlt.altitude, sAlt.pressure, sAlt.temperature);
+	set_altitude_reference(sAlt.altitude, sAlt.pressure, sAlt.temperature);
 }
 // *************************************************************************************************
 // @fn          mx_altitude
@@ -350,7 +417,7 @@ void mx_altitude(u8 line)
 		if (sys.flag.idle_timeout) break;
 
 		// Button STAR (short): save, then exit 
-		if (button.flag.star) 
+		if (sButton.event == BUTTON_STAR) 
 		{
 			// When using English units, convert ft back to m before updating pressure table
 #ifndef CONFIG_METRIC_ONLY
@@ -358,7 +425,7 @@ void mx_altitude(u8 line)
 #endif
 
 			// Update pressure table
-			update_pressure_table((s16)altitude, sAlt.pressure, sAlt.temperature);
+			set_altitude_reference((s16)altitude, sAlt.pressure, sAlt.temperature);
 			
 			// Set display update flag
 			display.flag.line1_full_update = 1;
@@ -372,7 +439,7 @@ void mx_altitude(u8 line)
 	}		
 	
 	// Clear button flags
-	button.all_flags = 0;
+	sButton.event = 0;
 }
 
 
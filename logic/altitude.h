@@ -48,6 +48,9 @@ extern u8 is_altitude_measurement(void);
 extern void start_altitude_measurement(void);
 extern void stop_altitude_measurement(void);
 extern void do_altitude_measurement(u8 filter);
+extern void altitude_sample(u32 pa, u16 temperature);
+extern void altitude_process(u32 pa, u16 temperature, u8 filter);
+extern void set_altitude_reference(s16 altitude, u32 pressure, u16 temperature);
 
 // menu functions
 extern void ax_altitude(u8 line);
@@ -87,6 +90,11 @@ struct alt
 	
 	// Altitude offset stored during calibration
 	s16		altitude_offset;
+	
+	// Reference point of pressure table set by calibration, ref_pressure = 0: not calibrated
+	s16		ref_altitude;
+	u32		ref_pressure;
+	u16		ref_temperature;
 
 	// Timeout
 	u16		timeout;
@@ -138,7 +138,7 @@ void mx_bluerobin(u8 line)
 #endif
 
 	// Clear simulated button event
-	button.all_flags = 0;
+	sButton.event = 0;
 }
 
 
@@ -160,7 +160,7 @@ void sx_bluerobin(u8 line)
 	if (is_rf()) return;
 		
 	// UP: connect / disconnect transmitter
-	if(button.flag.up)
+	if(sButton.event == BUTTON_UP)
 	{
 		if (sBlueRobin.state == BLUEROBIN_OFF)
 		{
@@ -295,7 +295,7 @@ void mx_caldist(u8 line)
 		if (sys.flag.idle_timeout) break;
 
 		// Button STAR (short): save, then exit 
-		if (button.flag.star) 
+		if (sButton.event == BUTTON_STAR) 
 		{
 			// Store local variables in global structure
 			sBlueRobin.calories 	= kcalories*1000;
@@ -339,7 +339,7 @@ void mx_caldist(u8 line)
 	}	
 
 	// Clear button flags
-	button.all_flags = 0;
+	sButton.event = 0;
 }
 
 
@@ -46,6 +46,7 @@
 #include "ports.h"
 #include "display.h"
 #include "timer.h"
+#include "rtc.h"
 
 // logic
 #include "menu.h"
@@ -71,7 +72,6 @@
 // *************************************************************************************************
 // Prototypes section
 void reset_clock(void);
-void clock_tick(void);
 void mx_time(u8 line);
 void sx_time(u8 line);
 
@@ -104,13 +104,11 @@ const u8 selection_Timeformat[][4] =
 // *************************************************************************************************
 void reset_clock(void)
 {
-	// Set global system time to 0
-	sTime.system_time = 0;
-
 	// Set main 24H time to start value
-	sTime.hour   = 4;
-	sTime.minute = 30;
-	sTime.second = 0;
+	rtc_set_time(4, 30, 0);
+
+	// Set global system time to 0
+	Timer0_Set_Seconds(0);
 
 	// Display style of both lines is default (HH:MM)
 	sTime.line1ViewStyle = DISPLAY_DEFAULT_VIEW;
@@ -125,51 +123,6 @@ void reset_clock(void)
 }
 
 
-// *************************************************************************************************
-// @fn          clock_tick
-// @brief       Add 1 second to system time and to display time
-// @param       none
-// @return      none
-// *************************************************************************************************
-void clock_tick(void)
-{
-	// Use sTime.drawFlag to minimize display updates
-	// sTime.drawFlag = 1: second
-	// sTime.drawFlag = 2: minute, second
-	// sTime.drawFlag = 3: hour, minute
-	sTime.drawFlag = 1;
-
-	// Increase global system time
-	sTime.system_time++;
-
-	// Add 1 second
-	sTime.second++;
-
-	// Add 1 minute
-	if (sTime.second == 60)
-	{
-		sTime.second = 0;
-		sTime.minute++;
-		sTime.drawFlag++;
-
-		// Add 1 hour
-		if (sTime.minute == 60)
-		{
-			sTime.minute = 0;
-			sTime.hour++;
-			sTime.drawFlag++;
-
-			// Add 1 day
-			if (sTime.hour == 24)
-			{
-				sTime.hour = 0;
-				add_day();
-			}
-		}
-	}
-}
-
-
 // *************************************************************************************************
 // @fn          convert_hour_to_12H_format
 // @brief       Convert internal 24H time to 12H time.
@@ -257,6 +210,7 @@ void mx_time(u8 line)
     timeformat 	= TIMEFORMAT_24H;
   }
   timeformat1	= timeformat;
+  rtc_read();
   hours 		= sTime.hour;
   minutes 	= sTime.minute;
   seconds 	= sTime.second;
@@ -280,18 +234,10 @@ void mx_time(u8 line)
     }
 
     // Button STAR (short): save, then exit
-    if (button.flag.star)
+    if (sButton.event == BUTTON_STAR)
     {
-      // Stop clock timer
-      Timer0_Stop();
-
       // Store local variables in global clock time
-      sTime.hour 	 = hours;
-      sTime.minute = minutes;
-      sTime.second = seconds;
-
-      // Start clock timer
-      Timer0_Start();
+      rtc_set_time(hours, minutes, seconds);
 
       // Full display update is done when returning from function
       display_symbol(LCD_SYMB_AM, SEG_OFF);
@@ -352,7 +298,7 @@ void mx_time(u8 line)
   }
 
   // Clear button flags
-  button.all_flags = 0;
+  sButton.event = 0;
 
 #endif
 }
@@ -401,6 +347,9 @@ void display_time(u8 line, u8 update)
 	      // Seconds are always updated
 	      display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sTime.second, 2, 0), SEG_ON);
 	    }
+	    
+	    // Changes are drawn
+	    sTime.drawFlag = 0;
 	  }
 	}
 	else if (update == DISPLAY_LINE_UPDATE_FULL)
@@ -48,7 +48,6 @@
 extern void reset_clock(void);
 extern void sx_time(u8 line);
 extern void mx_time(u8 line);
-extern void clock_tick(void);
 extern void display_selection_Timeformat1(u8 segments, u32 index, u8 digits, u8 blanks, u8 dummy);
 extern void display_time(u8 line, u8 update);
 
@@ -61,8 +60,6 @@ extern u8 is_hour_am(u8 hour);
 // Global Variable section
 struct time
 {
-	u32 	system_time;
-
 	// Flag to minimize display updates
 	u8 		drawFlag;
 
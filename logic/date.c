@@ -45,6 +45,8 @@
 // driver
 #include "display.h"
 #include "ports.h"
+#include "rtc.h"
+#include "calendar.h"
 
 // logic
 #include "date.h"
@@ -58,8 +60,6 @@
 // *************************************************************************************************
 // Prototypes section
 void reset_date(void);
-u8 get_numberOfDays(u8 month, u16 year);
-void add_day(void);
 void mx_date(line_t line);
 void sx_date(line_t line);
 void display_date(line_t line, update_t update);
@@ -87,85 +87,13 @@ struct date sDate;
 void reset_date(void)
 {
 	// Set date 
-	sDate.year  = 2009;
-	sDate.month = 8;
-	sDate.day 	= 1;
+	rtc_set_date(2009, 8, 1);
 	
 	// Show default display
 	sDate.view = 0;
 }
 
 
-// *************************************************************************************************
-// @fn          get_NumberOfDays
-// @brief       Return number of days for a given month
-// @param       month		month as char
-//				year		year as int
-// @return      			day count for given month
-// *************************************************************************************************
-u8 get_numberOfDays(u8 month, u16 year)
-{
-   switch(month)
-   {
-      case 1: 	
-      case 3: 	
-      case 5: 	
-      case 7: 	
-      case 8: 	
-      case 10: 
-      case 12: 	return (31);
-
-      case 4: 	
-      case 6: 	
-      case 9: 	
-      case 11: 	return (30);
-
-	  // 1. A year that is divisible by 4 is a leap year. (Y % 4) == 0
-	  // 2. Exception to rule 1: a year that is divisible by 100 is not a leap year. (Y % 100) != 0
-	  // 3. Exception to rule 2: a year that is divisible by 400 is a leap year. (Y % 400) == 0 
-   
-      case 2: 	if ((year%4==0) && ((year%100!=0) || (year%400==0)))	
-      				return (29);
-				else
-					return (28);
-				
-      default: 	return (0);
-   }
-}
-
-
-// *************************************************************************************************
-// @fn          add_day
-// @brief       Add one day to current date. Called when clock changes from 23:59 to 00:00
-// @param       none
-// @return      none
-// *************************************************************************************************
-void add_day(void)
-{
-	// Add 1 day
-	sDate.day++;	
-	
-	// Check if day overflows into next month
-	if (sDate.day > get_numberOfDays(sDate.month, sDate.year))
-	{
-		// Add 1 month and reset to day to 1
-		sDate.day = 1;				
-		sDate.month++;	
-		
-		// Check if month overflows into next year
-		if (sDate.month > 12)
-		{
-			// Add 1 year and reset month and day to 1
-			sDate.day = 1;				
-			sDate.month = 1;	
-			sDate.year++;
-		}	
-	}
-	// Indicate to display function that new value is available
-	display.flag.update_date = 1;
-}
-
-
 // *************************************************************************************************
 // @fn          mx_date
 // @brief       Date set routine.
@@ -188,6 +116,7 @@ void mx_date(line_t line)
 	clear_display_all();
 			
 	// Convert global to local variables
+	rtc_read();
 	day 	= sDate.day;
 	month 	= sDate.month;
 	year 	= sDate.year;
@@ -212,12 +141,10 @@ void mx_date(line_t line)
 		if (sys.flag.idle_timeout) break;
 
 		// Button STAR (short): save, then exit 
-		if (button.flag.star) 
+		if (sButton.event == BUTTON_STAR) 
 		{
 			// Copy local variables to global variables
-			sDate.day = day;
-			sDate.month = month;
-			sDate.year = year;
+			rtc_set_date(year, month, day);
 			#ifdef CONFIG_SIDEREAL
 			if(sSidereal_time.sync>0)
 				sync_sidereal();
@@ -244,12 +171,12 @@ void mx_date(line_t line)
 		}
 		
 		// Check if day is still valid, if not clamp to last day of current month
-		max_days = get_numberOfDays(month, year);
+		max_days = calendar_month_days(year, month);
 		if (day > max_days) day = max_days;
 	}
 	
 	// Clear button flag
-	button.all_flags = 0;
+	sButton.event = 0;
 #endif
 }
 
@@ -292,43 +219,8 @@ void display_date(line_t line, update_t update)
 				str = itoa(sDate.day, 2, 1);
 				display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), str, SEG_ON);
 
-				//pfs BEGIN replace year display with day of week
-				//pfs algorith from http://klausler.com/new-dayofweek.html
-				#define BASE_YEAR 2001 // not a leap year, so no need to add 1
-				u8 skew;
-				skew = (sDate.year - BASE_YEAR)+(sDate.year - BASE_YEAR)/4; // compute number of leap years since BASE_YEAR
-				if ((29 == get_numberOfDays(2, sDate.year)) && (sDate.month < 3))
-				  skew--; // if this is a leap year but before February 29
-				skew = (skew + sDate.day); // add day of current month
-				//add this month's skew value
-				switch(sDate.month) {
-				  case 5:
-					skew += 1;
-					break;
-				  case 8:
-					skew += 2;
-					break;
-				  case 2:
-				  case 3:
-				  case 11:
-					skew += 3;
-					break;
-				  case 6:
-					skew += 4;
-					break;
-				  case 9:
-				  case 12:
-					skew += 5;
-					break;
-				  case 4:
-				  case 7:
-					skew += 6;
-					break;
-				  default:  //January and October
-					break;
-				}
-				skew = skew%7;
-				str = (u8 *)weekDayStr[skew];
+				// Replace year display with day of week
+				str = (u8 *)weekDayStr[calendar_weekday(calendar_days(sDate.year, sDate.month, sDate.day))];
 				display_chars(switch_seg(line, LCD_SEG_L1_3_2, LCD_SEG_L2_4_2), str, SEG_ON);
 				display_symbol(switch_seg(line, LCD_SEG_L1_DP1, LCD_SEG_L2_DP), SEG_ON);
 				break;
@@ -51,6 +51,7 @@
 #include "ports.h"
 #include "display.h"
 #include "timer.h"
+#include "chrono.h"
 #include "buzzer.h"
 #include "user.h"
 
@@ -63,8 +64,10 @@
 void start_eggtimer(void);
 void stop_eggtimer(void);
 void reset_eggtimer(void);
-void eggtimer_tick(void);
-void update_eggtimer_timer(void);
+u32 eggtimer_remaining(void);
+void eggtimer_expired(void);
+u16 eggtimer_refresh_delay(void);
+u8 eggtimer_keep_refresh(void);
 void mx_eggtimer(u8 line);
 void sx_eggtimer(u8 line);
 void display_eggtimer(u8 line, u8 update);
@@ -85,176 +88,70 @@ struct eggtimer seggtimer;
 
 
 // *************************************************************************************************
-// @fn          update_eggtimer_timer
-// @brief       Set new compare time for next 1/1Hz or 1/100Hz interrupt. Takes care for exact 1 second timing.
-// @param       ticks (1 tick = 1/32768 sec)
-// @return      none
+// @fn          eggtimer_remaining
+// @brief       Time left until eggtimer expires.
+// @param       none
+// @return      u32		Remaining time in 1/32768 sec
 // *************************************************************************************************
-void update_eggtimer_timer(void)
+u32 eggtimer_remaining(void)
 {
-    //Make sure eggtimer is running before we do anything else (this might slightly mess up my timing, but oh well)
-  if(seggtimer.state == EGGTIMER_RUN){
-	u16 value;
-
-	// Load CCR register with next capture time
-	if (seggtimer.viewStyle == DISPLAY_DEFAULT_VIEW) 
-	{
-		// Timer interrupts occur every 32768/100 = 328 ACLK
-		// --> eggtimer runs too slow (1 sec nominal != 100 interupts * 328 ACLK = 32800 ACLK = 1.00098 sec)
-		// --> ideally correct timer value every 10 ticks by (32768 - 32800)/10 = 3.2
-		// --> correct timer value every 10Hz by 3, 
-		// --> correct timer value every 1Hz correct by 5
-		value = TA0CCR2 + EGGTIMER_100HZ_TICK;
-
-		if (seggtimer.swtIs1Hz) 
-		{
-			value -= 5;
-			seggtimer.swtIs1Hz = 0;	
-			seggtimer.swtIs10Hz = 0;	
-		}
-		else if (seggtimer.swtIs10Hz) 
-		{
-			value -= 3;
-			seggtimer.swtIs10Hz = 0;	
-		}
-	}
-	else // Alternative view
-	{
-		// Timer interrupts occur every 32768/1 = 32768 ACLK
-		value = TA0CCR2 + EGGTIMER_1HZ_TICK;
-	}
+	u32 ticks = chrono_elapsed(CHRONO_EGGTIMER);
 	
-	// Update CCR
-	TA0CCR2 = value;   
-  }
+	if (ticks >= seggtimer.duration) return (0);
+	return (seggtimer.duration - ticks);
 }
 
 
 // *************************************************************************************************
-// @fn          eggtimer_tick
-// @brief       Called by 1/100Hz interrupt handler. 
-//				Decreases eggtimer counter and triggers display update.
+// @fn          eggtimer_expired
+// @brief       Called by timer engine when the count-down reaches 0.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void eggtimer_tick(void)
+void eggtimer_expired(void)
 {
-  //Make sure eggtimer is running before we do anything else (this might slightly mess up my timing, but oh well)
-  if(seggtimer.state == EGGTIMER_RUN){
-	static u8 delay = 0;
+	// When we reach 0, stop, reset, and beep (not able to stop beeping yet) 
+	stop_eggtimer();
+	reset_eggtimer();
+	start_buzzer(100, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(150));
+}
+
+
+// *************************************************************************************************
+// @fn          eggtimer_refresh_delay
+// @brief       Time to next digit change of running eggtimer. Called by the idle loop and by 
+//				Timer0_A4.
+// @param       none
+// @return      u16		Ticks to next digit change
+// *************************************************************************************************
+u16 eggtimer_refresh_delay(void)
+{
+	u32 ticks = eggtimer_remaining();
 	
-	// Default view (< 20 minutes): display and count MM:SS:hh
-	if (seggtimer.viewStyle == DISPLAY_DEFAULT_VIEW)
-	{
-		// Add 1/100 sec 
-		seggtimer.time[7]--;
-				
-		// Draw flag minimizes display update activity
-		//
-		// swt.drawFlag = 1: second L
-		// swt.drawFlag = 2: second H/L
-		// swt.drawFlag = 3: minutes L, second H/L
-		// swt.drawFlag = 4: minutes H/L, second H/L
-		// swt.drawFlag = 5: hours L, minutes H/L, second H/L
-		// swt.drawFlag = 6: hours H/L, minutes H/L, second H/L
-		// swt.drawFlag = 7: 1/10 sec, 1/100 sec
-		// swt.drawFlag = 8: 1/100 sec (every 17/100 sec to reduce display draw activity)
-		if (delay++ > 17) 
-		{
-			seggtimer.drawFlag = 8;
-			delay = 0;
-		}
+	// Count-down is over - nothing changes until the idle loop stops the refresh
+	if (ticks == 0) return ((u16)CHRONO_SECOND);
 	
-		// Subtract 1/10 sec 
-		if (seggtimer.time[7] == 0x2F)
-		{
-			seggtimer.time[7]='9';
-			seggtimer.time[6]--;
-			
-			// 1/10Hz trigger 
-			seggtimer.swtIs10Hz = 1;
-			
-			// Update draw flag
-			seggtimer.drawFlag = 7;
-		}
-	}
-	else // Alternative view (20 minutes .. 20 hours): display and count HH:MM:SS
-	{
-		// Just subtract 1 second
-		seggtimer.time[6] = 0x2F;
-	}
-			
-	// Second overflow?
-	if (seggtimer.time[6] == 0x2F)
-	{
-		// Reset draw flag
-		seggtimer.drawFlag = 1;
-
-		// 1Hz trigger 
-		seggtimer.swtIs1Hz = 1;
-		
-		// Subtract sequentially
-		seggtimer.time[6]='9';
-		seggtimer.time[5]--;							// second  L (0 - 9)
-		if (seggtimer.time[5] == 0x2F) 
-		{
-			seggtimer.drawFlag++;						// 2
-			seggtimer.time[5] = '9';
-			seggtimer.time[4]--;						// second  H (0 - 5)
-			if (seggtimer.time[4] == 0x2F) 
-			{
-				seggtimer.drawFlag ++;					// 3
-				seggtimer.time[4] = '5';
-				seggtimer.time[3]--;					// minutes L (0 - 9)
-				if (seggtimer.time[3] == 0x2F) 
-				{
-					seggtimer.drawFlag++;				// 4
-					seggtimer.time[3] = '9';
-					seggtimer.time[2]--;				// minutes H (0 - 5)
-					
-                                        if (seggtimer.time[0]=='0'&&
-                                            seggtimer.time[1]=='0'&&
-                                            seggtimer.time[2]< '2')
-                                        {
-	                                        // SWT display changes from HH:MM:SS to MM:SS:hh when reaching 20 minutes 
-	                                        seggtimer.viewStyle = DISPLAY_DEFAULT_VIEW;
-	                                        display_eggtimer(LINE2, DISPLAY_LINE_UPDATE_FULL);
-	                                } 
-                                        
-					if (seggtimer.time[2] == 0x2F) 
-					{
-						seggtimer.drawFlag++;				// 5
-						seggtimer.time[2] = '5';
-						seggtimer.time[1]--;				// hours L (0-9)	
-
-						if (seggtimer.time[1] == 0x2F) 
-						{
-							seggtimer.drawFlag++;			// 6
-							seggtimer.time[1] = '9';
-							seggtimer.time[0]--;			// hours H (0-1)	
-
-		   				} 
-                                                if(seggtimer.time[0] ==0x2F)
-                                                  {
-                                                          // When we reach 0, stop, reset, and beep (not able to stop beeping yet) 
-                                                          stop_eggtimer();
-                                                          reset_eggtimer();
-                                                          display_eggtimer(LINE2, DISPLAY_LINE_UPDATE_FULL);
-                                                          start_buzzer(100, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(150));
-                                                  }
-	   				} 
-				}
-			}
-		}
-	}		
-        
-	// Always set display update flag (Only used in two places for no good reason, but whatever)
-        //seggtimer.update_eggtimer = 1;
-        display.flag.update_stopwatch = 1;
-  }
+	// MM:SS:hh view shows 1/10 sec digit changes, HH:MM:SS view only second changes 
+	if (ticks < EGGTIMER_VIEW_TICKS)	return (chrono_digit_delay(ticks, CHRONO_10HZ, 1));
+	else								return (chrono_digit_delay(ticks, CHRONO_1HZ, 1));
 }
 
 
+// *************************************************************************************************
+// @fn          eggtimer_keep_refresh
+// @brief       Start display refresh of running eggtimer. Called by the idle loop. Refresh is 
+//				aligned to the digits of the eggtimer.
+// @param       none
+// @return      u8		1 = eggtimer is running and visible
+// *************************************************************************************************
+u8 eggtimer_keep_refresh(void)
+{
+	if (!is_eggtimer()) return (0);
+	
+	chrono_refresh(eggtimer_refresh_delay);
+	return (1);
+}
+
 
 // *************************************************************************************************
 // @fn          reset_eggtimer
@@ -264,23 +161,19 @@ void eggtimer_tick(void)
 // *************************************************************************************************
 void reset_eggtimer(void)
 {
-	// Clear counter
+	// Count down from default time
 	memcpy(seggtimer.time, seggtimer.defaultTime, sizeof(seggtimer.time));
-
-	// Clear trigger
-	seggtimer.swtIs10Hz 	= 0;		// 1/10Hz trigger
-	seggtimer.swtIs1Hz  	= 0;		// 1Hz trigger
+	seggtimer.duration = (((seggtimer.time[0]-'0')*10 + (seggtimer.time[1]-'0')) * 3600ul
+					    + ((seggtimer.time[2]-'0')*10 + (seggtimer.time[3]-'0')) * 60u
+					    +  (seggtimer.time[4]-'0')*10 + (seggtimer.time[5]-'0')) * CHRONO_SECOND;
+	chrono_reset(CHRONO_EGGTIMER);
 	
 	// Init eggtimer state 'Off'
 	seggtimer.state 	  	= EGGTIMER_STOP;		
 	
 	// Default display style is MM:SS:HH
-        if(seggtimer.defaultTime[0]=='0'&&
-           seggtimer.defaultTime[1]=='0'&&
-           seggtimer.defaultTime[2]<'2')
-              seggtimer.viewStyle 	= DISPLAY_DEFAULT_VIEW;
-        else
-	      seggtimer.viewStyle 	= DISPLAY_ALTERNATIVE_VIEW;
+	if (seggtimer.duration < EGGTIMER_VIEW_TICKS)	seggtimer.viewStyle = DISPLAY_DEFAULT_VIEW;
+	else											seggtimer.viewStyle = DISPLAY_ALTERNATIVE_VIEW;
 }
 
 
@@ -298,26 +191,21 @@ u8 is_eggtimer(void)
 
 // *************************************************************************************************
 // @fn          start_eggtimer
-// @brief       Starts eggtimer timer interrupt and sets eggtimer state to on.
+// @brief       Starts eggtimer and sets eggtimer state to on.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void start_eggtimer(void)
 {
+	// Nothing to count down
+	if (seggtimer.duration == 0) return;
+	
 	// Set eggtimer run flag
 	seggtimer.state = EGGTIMER_RUN;	
 
-	// Init CCR register with current time
-	TA0CCR2 = TA0R;
-		
-	// Load CCR register with next capture time
-	update_eggtimer_timer();
-
-	// Reset IRQ flag    
-	TA0CCTL2 &= ~CCIFG; 
-	          
-	// Enable timer interrupt    
-	TA0CCTL2 |= CCIE; 
+	// Count down remaining time
+	chrono_set_function(CHRONO_EGGTIMER, seggtimer.duration, 0, eggtimer_expired);
+	chrono_start(CHRONO_EGGTIMER, Timer0_Ticks());
 	
 	// Set eggtimer icon (doesn't exist so I wont untill I'll use stopwatch for now)
 	display_symbol(LCD_ICON_RECORD, SEG_ON);
@@ -326,24 +214,24 @@ void start_eggtimer(void)
 
 // *************************************************************************************************
 // @fn          stop_eggtimer
-// @brief       Stops eggtimer timer interrupt and sets eggtimer state to off.
+// @brief       Stops eggtimer and sets eggtimer state to off.
 //				Does not reset eggtimer count.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void stop_eggtimer(void)
 {
-	// Clear timer interrupt enable   
-	TA0CCTL2 &= ~CCIE; 
+	chrono_stop(CHRONO_EGGTIMER, Timer0_Ticks());
 
 	// Clear eggtimer run flag
 	seggtimer.state = EGGTIMER_STOP;	
 	
 	// Clear eggtimer icon (doesn't exist so I'll use stopwatch for now)
-	display_symbol(LCD_ICON_RECORD, SEG_OFF);
+	// May be called in ISR context
+	display_defer_symbol(LCD_ICON_RECORD, SEG_OFF);
 
-	// Call draw routine immediately
-	display_eggtimer(LINE2, DISPLAY_LINE_UPDATE_FULL);
+	// Call draw routine before next LPM entry
+	display_defer_line(display_eggtimer, LINE2, DISPLAY_LINE_UPDATE_FULL);
 }
 
 
@@ -380,7 +268,7 @@ void mx_eggtimer(u8 line)
 void sx_eggtimer(u8 line)
 {
 	// S2: RUN, STOP
-	if(button.flag.down)
+	if(sButton.event == BUTTON_DOWN)
 	{
 		if (seggtimer.state == EGGTIMER_STOP)
 		{
@@ -406,48 +294,58 @@ void sx_eggtimer(u8 line)
 // *************************************************************************************************
 void display_eggtimer(u8 line, u8 update)
 {
+	u8 time[8];
+	u32 ticks;
+	u8 view;
+	u8 i;
+	
 	// Partial line update only
 	if (update == DISPLAY_LINE_UPDATE_PARTIAL)
 	{	
-//		if (seggtimer.update_eggtimer)
-                if (display.flag.update_stopwatch)
+		if (display.flag.update_stopwatch)
 		{
+			ticks = eggtimer_remaining();
+			chrono_digits(ticks, time);
+			
+			// Display changes from HH:MM:SS to MM:SS:hh when reaching 20 minutes 
+			view = (ticks < EGGTIMER_VIEW_TICKS) ? DISPLAY_DEFAULT_VIEW : DISPLAY_ALTERNATIVE_VIEW;
+			if (view != seggtimer.viewStyle)
+			{
+				seggtimer.viewStyle = view;
+				
+				// Refresh rate changes with view
+				chrono_stop_refresh();
+				display_eggtimer(line, DISPLAY_LINE_UPDATE_FULL);
+				return;
+			}
+			
+			// Draw changed digits only
 			if (seggtimer.viewStyle == DISPLAY_DEFAULT_VIEW)
 			{
 				// Display MM:SS:hh
-
-				// Check draw flag to minimize workload
-				if(seggtimer.drawFlag != 0) 
+				for (i=2; i<8; i++)
 				{
-					switch(seggtimer.drawFlag) 
-					{
-						case 4: display_char(LCD_SEG_L2_5, seggtimer.time[2], SEG_ON);
-						case 3: display_char(LCD_SEG_L2_4, seggtimer.time[3], SEG_ON);
-						case 2: display_char(LCD_SEG_L2_3, seggtimer.time[4], SEG_ON);
-						case 1: display_char(LCD_SEG_L2_2, seggtimer.time[5], SEG_ON);
-						case 7: display_char(LCD_SEG_L2_1, seggtimer.time[6], SEG_ON);
-						case 8:	display_char(LCD_SEG_L2_0, seggtimer.time[7], SEG_ON);
-					}
+					if (time[i] != seggtimer.time[i]) display_char(LCD_SEG_L2_5 + (i-2), time[i], SEG_ON);
 				}
 			}
 			else // DISPLAY_ALTERNATIVE_VIEW
 			{
 				// Display HH:MM:SS
-				switch(seggtimer.drawFlag) 
+				for (i=0; i<6; i++)
 				{
-					case 6: display_char(LCD_SEG_L2_5, seggtimer.time[0], SEG_ON);
-					case 5: display_char(LCD_SEG_L2_4, seggtimer.time[1], SEG_ON);
-					case 4: display_char(LCD_SEG_L2_3, seggtimer.time[2], SEG_ON);
-					case 3: display_char(LCD_SEG_L2_2, seggtimer.time[3], SEG_ON);
-					case 2: display_char(LCD_SEG_L2_1, seggtimer.time[4], SEG_ON);
-					case 1: display_char(LCD_SEG_L2_0, seggtimer.time[5], SEG_ON);
-				}		
+					if (time[i] != seggtimer.time[i]) display_char(LCD_SEG_L2_5 + i, time[i], SEG_ON);
+				}
 			}
+			memcpy(seggtimer.time, time, sizeof(seggtimer.time));
 		}
 	}
 	// Redraw whole line
 	else if (update == DISPLAY_LINE_UPDATE_FULL)	
 	{
+		ticks = eggtimer_remaining();
+		chrono_digits(ticks, seggtimer.time);
+		seggtimer.viewStyle = (ticks < EGGTIMER_VIEW_TICKS) ? DISPLAY_DEFAULT_VIEW : DISPLAY_ALTERNATIVE_VIEW;
+		
 		if (seggtimer.viewStyle == DISPLAY_DEFAULT_VIEW)
 		{
 			// Display MM:SS:hh
@@ -506,7 +404,7 @@ extern void set_eggtimer(void){
 		if (sys.flag.idle_timeout) break;
 		
 		// M2 (short): save, then exit 
-		if (button.flag.num) 
+		if (sButton.event == BUTTON_NUM) 
 		{
 			// Store local variables in global Eggtimer default
 			//sAlarm.hour = hours;
@@ -542,7 +440,7 @@ extern void set_eggtimer(void){
 	}
 	
 	// Clear button flag
-	button.all_flags = 0;
+	sButton.event = 0;
 	
 }
 
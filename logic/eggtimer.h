@@ -33,15 +33,10 @@
 //
 // *************************************************************************************************
 //
-// Eggtimer is currently just a copy of stopwatch.
-// I'm going to be turning it into a count down timer.
+// Eggtimer is a count down timer. Counting is done by the timer engine (chrono.c), which it
+// shares with the stopwatch, so both can run at the same time.
 //
 // TO DO:
-//    Make sure it doesn't interfere with stopwatch 
-//      (timer.c causing weird things especially relating to alt mode)
-//      (do NOT run both eggtimer and stopwatch at the same time)
-//      (this is because Stopwatch and Eggtimer both use the same Capture & Compare Register)
-//    Figure out why I have to use the stopwatch display update flag.
 //    Set it so stopwatch and eggtimer blink their respective icons when selected
 //      this prevents confusion as to which is currently selected.
 //    Change beeping so user can stop it at will, instead of having to wait.
@@ -62,8 +57,7 @@ extern void start_eggtimer(void);
 extern void stop_eggtimer(void);
 extern void reset_eggtimer(void);
 extern u8 is_eggtimer(void);
-extern void eggtimer_tick(void);
-extern void update_eggtimer_timer(void);
+extern u8 eggtimer_keep_refresh(void);
 extern void mx_eggtimer(u8 line);
 extern void sx_eggtimer(u8 line);
 extern void display_eggtimer(u8 line, u8 update);
@@ -72,8 +66,7 @@ extern void set_eggtimer(void);
 
 // *************************************************************************************************
 // Defines section
-#define EGGTIMER_1HZ_TICK			(32768/1)
-#define EGGTIMER_100HZ_TICK		(32768/100)
+#define EGGTIMER_VIEW_TICKS			(20ul*60ul*32768ul)		// MM:SS:hh view below 20 minutes
 #define EGGTIMER_STOP				(0u)
 #define EGGTIMER_RUN				(1u)
 #define EGGTIMER_HIDE				(2u)
@@ -85,9 +78,9 @@ struct eggtimer
 {
         //NOTE: u8 means unsigned char
 	u8 		state;
-	u8		drawFlag;
-	u8		swtIs1Hz;
-	u8		swtIs10Hz;
+	
+	// Count-down time in 1/32768 sec, counted time is kept by timer engine
+	u32		duration;
 	
 	//	time[0] 	hour H
 	//	time[1] 	hour L
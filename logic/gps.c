@@ -96,12 +96,12 @@ void sx_gps(u8 line)
 
 			}
 
-		if (button.flag.num)
+		if (sButton.event == BUTTON_NUM)
 		    {
 			  break;
 		    }
 
-		if (button.flag.down)
+		if (sButton.event == BUTTON_DOWN)
 		    {
 			// Clear display
 			clear_display_all();
@@ -128,13 +128,15 @@ void sx_gps(u8 line)
 			break;
 			}
 
+		// Drop button events without function here
+		sButton.event = 0;
 		idle_loop();
 	    }
 
 		// Clear timeout flag
 		sys.flag.idle_timeout = 0;
 		// Clear button flags
-	    button.all_flags = 0;
+	    sButton.event = 0;
 	    // Clear display
 		clear_display();
 		// Force full display update
@@ -155,13 +155,6 @@ u8 update_eggtimer(void)
 }
 #endif
 
-#ifdef CONFIG_SIDEREAL
-u8 update_sidereal(void)
-{
-	return (display.flag.update_sidereal_time);
-}
-#endif
-
 
 // *************************************************************************************************
 // User navigation ( [____] = default menu item after reset )
@@ -190,7 +183,7 @@ const struct menu menu_L1_Sidereal =
 	FUNCTION(mx_sidereal),		// sub menu function
 	FUNCTION(menu_skip_next),	// next item function
 	FUNCTION(display_sidereal),	// display function
-	FUNCTION(update_sidereal),	// new display data
+	FUNCTION(update_time),		// new display data
 	FUNCTION(dummy),		// alter function
 };
 #endif
@@ -446,6 +439,27 @@ const struct menu menu_L2_Gps =
 };
 #endif
 
+// *************************************************************************************************
+// @fn          menu_needs_second_tick
+// @brief       Check if a visible menu item has to be redrawn every second. Time in HH:MM view
+//				and items with their own update flags only need the 1/min clock tick.
+// @param       none
+// @return      u8		1 = refresh display every second
+// *************************************************************************************************
+u8 menu_needs_second_tick(void)
+{
+	if (ptrMenu_L1 == &menu_L1_Time)
+	{
+		if (sTime.line1ViewStyle != DISPLAY_DEFAULT_VIEW) return (1);
+	}
+	else if (ptrMenu_L1->display_update == update_time)
+	{
+		return (1);
+	}
+	return (ptrMenu_L2->display_update == update_time);
+}
+
+
 // *************************************************************************************************
 // menu array
 
@@ -73,6 +73,8 @@ struct menu
 // Extern section
 
 
+extern u8 menu_needs_second_tick(void);
+
 extern const struct menu *menu_L1[];
 extern const int menu_L1_size;
 extern int menu_L1_position;
@@ -161,7 +161,7 @@ void mx_phase(u8 line){
 			if (sys.flag.idle_timeout) break;
 		
 			// M2 (short): save, then exit 
-			if (button.flag.num) 
+			if (sButton.event == BUTTON_NUM) 
 			{
 				// Store local variables in global Eggtimer default
 				//sAlarm.hour = hours;
@@ -171,7 +171,7 @@ void mx_phase(u8 line){
 				display.flag.line2_full_update = 1;
 				break;
 			}
-			if (button.flag.star) 
+			if (sButton.event == BUTTON_STAR) 
                 mode = (mode+1)%2;
 
             switch (mode) {
@@ -188,7 +188,7 @@ void mx_phase(u8 line){
 		}
 	
 		// Clear button flag
-		button.all_flags = 0;
+		sButton.event = 0;
 		display_phase_clock(line, DISPLAY_LINE_UPDATE_FULL);
 }
 
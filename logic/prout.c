@@ -125,7 +125,7 @@ void stop_prout()
 
 void sx_prout(u8 line)
 {
-  if (button.flag.down)
+  if (sButton.event == BUTTON_DOWN)
     {
       if (sprouttimer.state == PROUT_STOP){
         start_prout();
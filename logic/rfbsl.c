@@ -63,6 +63,7 @@ u8 locked = 1;
 // *************************************************************************************************
 // Extern section
 extern void menu_skip_next(line_t line); //ezchronos.c
+extern void idle_loop(void); //ezchronos.c
 
 #ifndef CONFIG_USE_DISCRET_RFBSL
 // *************************************************************************************************
@@ -99,6 +100,7 @@ void mx_rfbsl(u8 line)
 	display_chars(LCD_SEG_L1_3_0, (u8 *)" RAM", SEG_ON);
 	
 	// Call RFBSL
+	display_commit();
 	CALL_RFSBL();
 
 
@@ -120,12 +122,12 @@ void sx_rfbsl(u8 line)
 	 while(1)
 	  {
 	    // Idle timeout: exit without saving
-	    if (sys.flag.idle_timeout || button.flag.num)
+	    if (sys.flag.idle_timeout || (sButton.event == BUTTON_NUM))
 	    {
 	      // Exit
 	      break;
 	    }
-	    if (button.flag.down)
+	    if (sButton.event == BUTTON_DOWN)
 	      {
 	    	// Exit if SimpliciTI stack is active
 	    	if (is_rf()) return;
@@ -139,8 +141,13 @@ void sx_rfbsl(u8 line)
 	    	display_chars(LCD_SEG_L1_3_0, (u8 *)" RAM", SEG_ON);
 
 	    	// Call RFBSL
+	    	display_commit();
 	    	CALL_RFSBL();
 	      }
+	    
+	    // Drop button events without function here, wait for next event
+	    sButton.event = 0;
+	    idle_loop();
 	  }
 
 #else
@@ -50,7 +50,10 @@
 #endif
 #include "ports.h"
 #include "timer.h"
+#include "rtc.h"
+#include "calendar.h"
 #include "radio.h"
+#include "event.h"
 
 // logic
 #ifdef FEATURE_PROVIDE_ACCEL
@@ -268,6 +271,9 @@ void start_simpliciti_tx_only(simpliciti_mode_t mode)
 	
 	// Set SimpliciTI timeout to save battery power
 	sRFsmpl.timeout = SIMPLICITI_TIMEOUT; 
+	
+	// Radio loops rely on a 1/s tick - TIMER0_A0_ISR keeps CCR0 running while is_rf()
+	Timer0_A0_Schedule(TICK_DISPLAY, 1);
 		
 	// Start SimpliciTI stack. Try to link to access point.
 	// Exit with timeout or by a button DOWN press.
@@ -299,7 +305,8 @@ void start_simpliciti_tx_only(simpliciti_mode_t mode)
 	// Clear last button events
 	Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
 	BUTTONS_IFG = 0x00;  
-	button.all_flags = 0;
+	event_discard(EVENT_BUTTON);
+	sButton.event = 0;
 	
 	// Clear icons
 	display_symbol(LCD_ICON_BEEPER1, SEG_OFF_BLINK_OFF);
@@ -405,12 +412,9 @@ WDTCTL = WDTPW + WDTHOLD;
 		// Wait for next sample
 		Timer0_A4_Delay(CONV_MS_TO_TICKS(5));	
 
-		// Read from sensor if DRDY pin indicates new data (set in PORT2 ISR)
-		if (request.flag.acceleration_measurement && ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN))
+		// Read from sensor if DRDY pin indicates new data
+		if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN)
 		{
-			// Clear flag
-			request.flag.acceleration_measurement = 0;
-			
 			// Get data from sensor
 			as_get_data(sAccel.xyz);
 			
@@ -462,12 +466,9 @@ WDTCTL = WDTPW + WDTHOLD;
 		// Wait for next sample
 		display_symbol(LCD_ICON_RECORD, SEG_ON);
 		Timer0_A4_Delay(CONV_MS_TO_TICKS(60));	
-		// Read from sensor if DRDY pin indicates new data (set in PORT2 ISR)
-		if (request.flag.acceleration_measurement && ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN))
+		// Read from sensor if DRDY pin indicates new data
+		if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN)
 		{
-			// Clear flag
-			request.flag.acceleration_measurement = 0;
-			
 			// Get data from sensor
 			as_get_data(sAccel.xyz);
 			
@@ -552,6 +553,7 @@ WDTCTL = WDTPW + WDTHOLD;
 		else
 		{
 			// Wait in LPM3 for next button press
+			display_commit();
 			_BIS_SR(LPM3_bits + GIE); 	
 			__no_operation();
 		}
@@ -613,7 +615,7 @@ void start_simpliciti_sync(void)
 	#endif
 
 	// Get updated altitude
-#ifdef CONFIG_ALTITUTDE
+#ifdef CONFIG_ALTITUDE
 	start_altitude_measurement();
 	stop_altitude_measurement();	
 #endif
@@ -637,6 +639,9 @@ void start_simpliciti_sync(void)
 	
 	// Set SimpliciTI timeout to save battery power
 	sRFsmpl.timeout = SIMPLICITI_TIMEOUT; 
+	
+	// Radio loops rely on a 1/s tick - TIMER0_A0_ISR keeps CCR0 running while is_rf()
+	Timer0_A0_Schedule(TICK_DISPLAY, 1);
 		
 	// Start SimpliciTI stack. Try to link to access point.
 	// Exit with timeout or by a button DOWN press.
@@ -656,7 +661,8 @@ void start_simpliciti_sync(void)
 	// Clear last button events
 	Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
 	BUTTONS_IFG = 0x00;  
-	button.all_flags = 0;
+	event_discard(EVENT_BUTTON);
+	sButton.event = 0;
 	
 	// Clear icons
 	display_symbol(LCD_ICON_BEEPER1, SEG_OFF_BLINK_OFF);
@@ -679,6 +685,7 @@ void simpliciti_sync_decode_ap_cmd_callback(void)
 {
 	u8 i;
 	s16 t1, offset;
+	u16 year;
 	
 	// Default behaviour is to send no reply packets
 	simpliciti_reply_count = 0;
@@ -695,15 +702,16 @@ void simpliciti_sync_decode_ap_cmd_callback(void)
 
 		case SYNC_AP_CMD_SET_WATCH:		// Set watch parameters
 										sys.flag.use_metric_units = (simpliciti_data[1] >> 7) & 0x01;
-										sTime.hour 			= simpliciti_data[1] & 0x7F;
-										sTime.minute 		= simpliciti_data[2];
-										sTime.second 		= simpliciti_data[3];
-										sDate.year 			= (simpliciti_data[4]<<8) + simpliciti_data[5];
-										sDate.month 		= simpliciti_data[6];
-										sDate.day 			= simpliciti_data[7];
+										rtc_sync_time(simpliciti_data[1] & 0x7F, simpliciti_data[2], simpliciti_data[3]);
+										year = (simpliciti_data[4]<<8) + simpliciti_data[5];
+										// Ignore dates out of calendar range
+										if ((year >= CALENDAR_EPOCH_YEAR) && (year <= CALENDAR_LAST_YEAR) && 
+											(simpliciti_data[7] >= 1) && (simpliciti_data[7] <= calendar_month_days(year, simpliciti_data[6])))
+										{
+											rtc_set_date(year, simpliciti_data[6], simpliciti_data[7]);
+										}
 										#ifdef CONFIG_ALARM
-										sAlarm.hour			= simpliciti_data[8];
-										sAlarm.minute		= simpliciti_data[9];
+										alarm_set_time(0, simpliciti_data[8], simpliciti_data[9]);
 										#endif
 										// Set temperature and temperature offset
 										t1 = (s16)((simpliciti_data[10]<<8) + simpliciti_data[11]);
@@ -775,6 +783,7 @@ void simpliciti_sync_get_data_callback(unsigned int index)
 	switch (simpliciti_data[0])
 	{
 		case SYNC_ED_TYPE_STATUS:		// Assemble status packet
+										rtc_read();
 										simpliciti_data[1]  = (sys.flag.use_metric_units << 7) | (sTime.hour & 0x7F);
 										simpliciti_data[2]  = sTime.minute;
 										simpliciti_data[3]  = sTime.second;
@@ -783,8 +792,8 @@ void simpliciti_sync_get_data_callback(unsigned int index)
 										simpliciti_data[6]  = sDate.month;
 										simpliciti_data[7]  = sDate.day;
 										#ifdef CONFIG_ALARM
-										simpliciti_data[8]  = sAlarm.hour;
-										simpliciti_data[9]  = sAlarm.minute;
+										simpliciti_data[8]  = sAlarm.entry[0].hour;
+										simpliciti_data[9]  = sAlarm.entry[0].minute;
 										#else
 										simpliciti_data[8]  = 4;
 										simpliciti_data[9]  = 30;
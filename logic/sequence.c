@@ -50,14 +50,19 @@ extern void idle_loop(void);
 u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH]);
 void doorlock_sequence_timer(void);
 void doorlock_sequence_pause_timer(void);
+void doorlock_sequence_pause_length(void);
+void doorlock_knock_feedback(void);
+void doorlock_knock_feedback_over(void);
 u8 sequence_compare(u8* sequence_a, u8* sequence_b);
 
 
 // *************************************************************************************************
 // Global variable section
 
-volatile u8 doorlock_sequence_pause = 0;
+u8 doorlock_sequence_pause = 0;
+volatile u8 doorlock_sequence_pause_over = 0;
 volatile u8 doorlock_sequence_timeout = 0;
+u32 doorlock_knock_time = 0;
 
 // *************************************************************************************************
 // @fn          doorlock_sequence
@@ -79,6 +84,7 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 	// initialize
 	memset(sequence, 0, sizeof(u8) * DOORLOCK_SEQUENCE_MAX_LENGTH);
 	doorlock_sequence_pause = 0;
+	doorlock_sequence_pause_over = 0;
 
 	// setup timeout
 	doorlock_sequence_timeout = DOORLOCK_SEQUENCE_TIMEOUT;
@@ -117,16 +123,14 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 		}
 
 		// were we interrupted because pause is too long?
-		if (doorlock_sequence_pause <= DOORLOCK_SEQUENCE_PAUSE_MAX_LENGTH)
+		if (!doorlock_sequence_pause_over)
 		{
-			// look for accelerometer data ready event
-			if (!request.flag.acceleration_measurement)
+			// look for accelerometer data ready (DRDY stays high until data is read)
+			if ((AS_INT_IN & AS_INT_PIN) != AS_INT_PIN)
 			{
 				continue;
 			}
 
-			request.flag.acceleration_measurement = 0;
-
 			// read accelerometer z-a
 			raw = as_get_z();
 			delta = raw - previous_raw;
@@ -141,8 +145,17 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 				continue;
 			}
 
+			// ignore vibration of our own feedback beep
+			if (Timer0_A4_Is_Active(TIMER0_A4_SEQUENCE))
+			{
+				continue;
+			}
+
 			Timer0_A1_Stop();
 
+			// length of pause since previous knock
+			doorlock_sequence_pause_length();
+
 			// first tap?
 			if (length == 0)
 			{
@@ -154,15 +167,11 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 				++ length;
 
 				// successfully detected a knock, beep once to signal that
-				display_symbol(LCD_ICON_RECORD, SEG_ON);
-				start_buzzer(1, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(10));
-				Timer0_A4_Delay(CONV_MS_TO_TICKS(30));
-				stop_buzzer();
-				display_symbol(LCD_ICON_RECORD, SEG_OFF);
+				doorlock_knock_feedback();
 
 				// start pause timer
 				fptr_Timer0_A1_function = doorlock_sequence_pause_timer;
-				Timer0_A1_Start(DOORLOCK_SEQUENCE_PAUSE_RESOLUTION);
+				Timer0_A1_Start(DOORLOCK_SEQUENCE_PAUSE_TIMEOUT);
 				continue;
 			}
 
@@ -178,11 +187,7 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 				}
 
 				// successfully detected a knock, beep once to signal that
-				display_symbol(LCD_ICON_RECORD, SEG_ON);
-				start_buzzer(1, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(10));
-				Timer0_A4_Delay(CONV_MS_TO_TICKS(30));
-				stop_buzzer();
-				display_symbol(LCD_ICON_RECORD, SEG_OFF);
+				doorlock_knock_feedback();
 			}
 
 			doorlock_sequence_pause = 0;
@@ -192,7 +197,7 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 			{
 				// start pause timer
 				fptr_Timer0_A1_function = doorlock_sequence_pause_timer;
-				Timer0_A1_Start(DOORLOCK_SEQUENCE_PAUSE_RESOLUTION);
+				Timer0_A1_Start(DOORLOCK_SEQUENCE_PAUSE_TIMEOUT);
 				continue;
 			}
 
@@ -205,6 +210,7 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 			as_stop();
 
 			doorlock_sequence_pause = 0;
+			doorlock_sequence_pause_over = 0;
 
 			// is sequence too short?
 			if (length <= DOORLOCK_SEQUENCE_MIN_LENGTH)
@@ -237,6 +243,35 @@ u8 doorlock_sequence(u8 sequence[DOORLOCK_SEQUENCE_MAX_LENGTH])
 }
 
 
+// *************************************************************************************************
+// @fn          doorlock_knock_feedback
+// @brief       Beep once and show record symbol to signal a detected knock. Does not wait,
+//				so the pause timer keeps running while the beep is audible.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void doorlock_knock_feedback(void)
+{
+	display_symbol(LCD_ICON_RECORD, SEG_ON);
+
+	// One buzzer cycle - buzzer stops by itself after on and off time
+	start_buzzer(1, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(10));
+	Timer0_A4_Start(TIMER0_A4_SEQUENCE, CONV_MS_TO_TICKS(30), 0, doorlock_knock_feedback_over);
+}
+
+
+// *************************************************************************************************
+// @fn          doorlock_knock_feedback_over
+// @brief       Called by Timer0_A4 when the knock feedback beep is over.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void doorlock_knock_feedback_over(void)
+{
+	display_defer_symbol(LCD_ICON_RECORD, SEG_OFF);
+}
+
+
 // *************************************************************************************************
 // @fn          doorlock_sequence_timer
 // @brief       timer for timing out sequence input (if the user don't input unlock sequence for
@@ -258,22 +293,30 @@ void doorlock_sequence_timer(void)
 
 // *************************************************************************************************
 // @fn          doorlock_sequence_pause_timer
-// @brief       timer callback to time the length of a pause
+// @brief       timer callback when a pause is longer than the maximum pause length
 // @param       none
 // @return      none
 // *************************************************************************************************
 void doorlock_sequence_pause_timer(void)
 {
-	if (doorlock_sequence_pause > DOORLOCK_SEQUENCE_PAUSE_MAX_LENGTH)
-    {
-            // stop timer
-            Timer0_A1_Stop();
-    }
-    else
-    {
-            // Increment pause length
-            ++ doorlock_sequence_pause;
-    }
+	doorlock_sequence_pause_over = 1;
+	Timer0_A1_Stop();
+}
+
+// *************************************************************************************************
+// @fn          doorlock_sequence_pause_length
+// @brief       measure the pause since the previous knock from time stamps and start a new pause
+// @param       none
+// @return      none
+// *************************************************************************************************
+void doorlock_sequence_pause_length(void)
+{
+	u32 now = Timer0_Ticks();
+	u32 pause = (now - doorlock_knock_time) / DOORLOCK_SEQUENCE_PAUSE_RESOLUTION;
+
+	if (pause > DOORLOCK_SEQUENCE_PAUSE_MAX_LENGTH) pause = DOORLOCK_SEQUENCE_PAUSE_MAX_LENGTH;
+	doorlock_sequence_pause = pause;
+	doorlock_knock_time = now;
 }
 
 u8 sequence_compare(u8* sequence_a, u8* sequence_b)
@@ -26,6 +26,7 @@
 #define DOORLOCK_SEQUENCE_PAUSE_RESOLUTION			(32768u/200u)
 #define DOORLOCK_SEQUENCE_PAUSE_MAX_LENGTH			(1200u/5u)
 #define DOORLOCK_SEQUENCE_PAUSE_MIN_LENGTH			(15u/5u)
+#define DOORLOCK_SEQUENCE_PAUSE_TIMEOUT				(DOORLOCK_SEQUENCE_PAUSE_RESOLUTION * (DOORLOCK_SEQUENCE_PAUSE_MAX_LENGTH + 1u))
 #define	DOORLOCK_SEQUENCE_TAP_THRESHOLD				(120)
 #define	DOORLOCK_SEQUENCE_TIMEOUT					(30u)
 
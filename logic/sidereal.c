@@ -49,6 +49,7 @@
 #include "ports.h"
 #include "display.h"
 #include "timer.h"
+#include "calendar.h"
 
 #ifdef CONFIG_INFOMEM
 #include "infomem.h"
@@ -69,7 +70,7 @@
 // *************************************************************************************************
 // Prototypes section
 void reset_sidereal_clock(void);
-void clock_sidereal_tick(void);
+void update_sidereal_clock(void);
 void mx_time(u8 line);
 void sx_time(u8 line);
 
@@ -82,35 +83,15 @@ void sx_time(u8 line);
 
 //fixed starting point: 1. Jan 2000 12:00:00 UTC :: sid_seconds=18.697374558*60*60=67310.5484088
 //						1. Jan 2000 12:00:00 UTC +165s = 1.1.2000 12:02:45 UTC :: sid_seconds=67476.00016
-const u8 fix_sec=45;
-const u8 fix_min=2;
-const u8 fix_hour=12;
-const u8 fix_day=1;
-const u8 fix_month=1;
-const u16 fix_year=2000;
+//fixed starting point in seconds since calendar epoch (1. Jan 2000 00:00:00)
+#define SIDEREAL_FIX_SECONDS (12ul*3600ul + 2ul*60ul + 45ul)
 
 const unsigned long fix_sidsec=67476;
 
 
-//rationalisations of 1.002737909350795
-const unsigned long rational[][2]={ {440501801,31055},{50828929,78494},{16958560,70591},{1776538,53402},{140253,54237},{46751,46879},{34698,34793},{12053,12086},{1461,1465},{1096,1099},{365,366},{183,184},{100,100},{1,1}};
-// rational[n][1] = round(1.002737909350795*rational[n][0]) % 86400
-// numbers where chosen to have very small errors from rounding
-
-// rational[n][0]:rational[n][1] ~ fabs(round(1.002737909350795*rational[n][0])-rational[n][1])
-//1:1 ~ 0.002737909351
-//183:184 ~ 0.4989625888
-//365:366 ~ 0.0006630869598
-//1096:1099 ~ 0.0007486484715
-//1461:1465 ~ 8.55615117e-05
-//12053:12086 ~ 2.140513243e-05
-//34698:34793 ~ 2.134610986e-05
-//46751:46879 ~ 5.902256817e-08
-//140253:140637 ~ 1.770677045e-07		1:54237
-//1776538:1781402 ~ 2.24285759e-06		20:53402
-//16958560:17004991 ~ 1.862645149e-08	196:70591
-//50828929:50968094 ~ 0					589:78494
-//440501801:441707855 ~ 0				5112:31055
+// Sidereal seconds gained per solar second (0.002737909350795) in 8.40 fixed point.
+// Rounding of the constant adds less than 20us over the whole u32 range of solar seconds.
+#define SIDEREAL_GAIN_Q40 (3010363167ul)
 
 
 // *************************************************************************************************
@@ -122,61 +103,37 @@ struct sidereal_time sSidereal_time;
 // Extern section
 
 
-// *************************************************************************************************
-// @fn          secs_since_fix
-// @brief       calculates time difference in seconds since defined fixed point
-//              (leap day calculation is simplified and only works for specific fixed points)
-// @param       components of time/date
-// @return      seconds since fixed time (in solar seconds)
-// *************************************************************************************************
-unsigned long secs_since_fix(u8 sec, u8 min, u8 hour, u8 day, u8 month, u16 year)
-{
-	const int days_till_month[12] = {0,31,59,90,120,151,181,212,243,273,304,334};
-	
-		//assumes fixed point in leap year (years 2000) before feb 29
-		short num_leap_years=(year-fix_year)/4;
-		if(((year-fix_year)%4>=1) || month>=3 || (month==2 && day==29)) num_leap_years++;
-		
-		unsigned long result=
-		(
-			(
-				(unsigned long)(
-					(short)365*(year-fix_year)
-					+(short)(days_till_month[month-1]-days_till_month[fix_month-1])
-					+(short)(day-fix_day)
-					+num_leap_years //days
-				)*24+(long)(hour-fix_hour) //hours
-			)*60+(short)(min-fix_min) //minutes
-		)*60+(short)sec-fix_sec; //seconds
-		
-	return result;
-};
-
 // *************************************************************************************************
 // @fn          sidereal_seconds
 // @brief       calculates sidereal second of the day (for Greenwich) (since 00:00:00) from the
 //              number of solar seconds since the fixed time.
 //              The sidereal seconds of the fixed time are used as a start point
 //              deviation from apparent sidereal time (the "real" value) should be less than 2 seconds
+//              Constant time: the gained seconds are the upper bits of a 32x32 bit fixed point 
+//              product, built from four 16x16 bit hardware multiplications.
 // @param       solar seconds difference since fixed point
 // @return      sidereal seconds since 00:00:00
 // *************************************************************************************************
 unsigned long sidereal_seconds(unsigned long rawtime)
 {
-	unsigned long sidtime=fix_sidsec;
-	int currentindex=0;
-	while(rawtime>0){
-		//use rational approximation of 1.002737909350795 to prevent use of floating point
-		//some multiples of 86400 are already lost here
-		while(rational[currentindex][0]<=rawtime){
-			sidtime+=rational[currentindex][1];
-			rawtime-=rational[currentindex][0];
-		}
-		//skip to next (more inaccurate) rational approximation
-		currentindex++;
-	}
+	u16 a0 = (u16)rawtime;
+	u16 a1 = (u16)(rawtime >> 16);
+	u16 k0 = (u16)SIDEREAL_GAIN_Q40;
+	u16 k1 = (u16)(SIDEREAL_GAIN_Q40 >> 16);
+	unsigned long lo, mid0, mid1, hi, gain;
+	
+	// 64 bit product rawtime * SIDEREAL_GAIN_Q40, only upper 32 bits are kept
+	lo   = (unsigned long)a0 * k0;
+	mid0 = (unsigned long)a1 * k0;
+	mid1 = (unsigned long)a0 * k1;
+	hi   = (unsigned long)a1 * k1;
+	hi  += (mid0 >> 16) + (mid1 >> 16) + (((lo >> 16) + (mid0 & 0xFFFF) + (mid1 & 0xFFFF)) >> 16);
+	
+	// Remove 8 fraction bits left in upper 32 bits: seconds gained since fixed time
+	gain = hi >> 8;
+	
 	//get rid of multiples of days
-	return sidtime%86400;
+	return (fix_sidsec + rawtime%86400 + gain%86400)%86400;
 };
 
 
@@ -188,14 +145,14 @@ unsigned long sidereal_seconds(unsigned long rawtime)
 // *************************************************************************************************
 void sync_sidereal(void)
 {
-	unsigned long sidtime=sidereal_seconds(secs_since_fix(sTime.second, sTime.minute, sTime.hour, sDate.day, sDate.month, sDate.year)-360*sTime.UTCoffset);
+	unsigned long sidtime=sidereal_seconds(calendar_now()-SIDEREAL_FIX_SECONDS-360*sTime.UTCoffset);
 
 	//calculate difference of local time from greenwich time
 	long localcorr=	(long)(sSidereal_time.lon[sSidereal_time.lon_selection].deg*60
 					+ sSidereal_time.lon[sSidereal_time.lon_selection].min)*4
 					+ (sSidereal_time.lon[sSidereal_time.lon_selection].sec+7)/15; //round correctly
 	//prevent sidtime from becoming negative
-	if(localcorr<0 && -localcorr>sidtime)
+	if(localcorr<0 && (unsigned long)-localcorr>sidtime)
 	{
 		sidtime+=86400;
 	}
@@ -206,16 +163,9 @@ void sync_sidereal(void)
 		sidtime -=86400;
 	}
 	
-	// Disable interrupts to prevent race conditions
-	Timer0_A1_Stop();
 	// Set sidereal 24H time to calculated value
-	sSidereal_time.hour   = sidtime/3600;
-	sidtime %=3600;
-	sSidereal_time.minute = sidtime/60;
-	sidtime %=60;
-	sSidereal_time.second = sidtime;
-	// Set clock timer for one sidereal second in the future
-	Timer0_A1_Start();
+	vclock_set(&sSidereal_time.clock, sidtime);
+	sSidereal_time.drawFlag = 3;
 	
 	//sync=1: automatically sync only one time
 	if (sSidereal_time.sync==1)
@@ -245,6 +195,9 @@ void reset_sidereal_clock(void)
 	sTime.UTCoffset=0;
 	sSidereal_time.lon_selection=0;
 	
+	// Sidereal clock runs faster than solar time
+	vclock_init(&sSidereal_time.clock, SIDEREAL_RATE_NUM, SIDEREAL_RATE_DEN);
+	
 	
 	#ifdef CONFIG_INFOMEM
 	s16 read_size=infomem_app_amount(SIDEREAL_INFOMEM_ID);
@@ -274,43 +227,23 @@ void reset_sidereal_clock(void)
 
 
 // *************************************************************************************************
-// @fn          sidereal_clock_tick
-// @brief       Add 1 second to display sidereal time
+// @fn          update_sidereal_clock
+// @brief       Advance sidereal time to current system time. Sidereal time has no timer IRQ of 
+//				its own, it is only calculated when displayed.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void sidereal_clock_tick(void)
+void update_sidereal_clock(void)
 {
+	u8 changed;
+	
 	// Use sSidereal_time.drawFlag to minimize display updates
 	// sSidereal_time.drawFlag = 1: second
 	// sSidereal_time.drawFlag = 2: minute, second
 	// sSidereal_time.drawFlag = 3: hour, minute
-	sSidereal_time.drawFlag = 1;
-
-	// Add 1 second
-	sSidereal_time.second++;
-
-	// Add 1 minute
-	if (sSidereal_time.second == 60)
-	{
-		sSidereal_time.second = 0;
-		sSidereal_time.minute++;
-		sSidereal_time.drawFlag++;
-
-		// Add 1 hour
-		if (sSidereal_time.minute == 60)
-		{
-			sSidereal_time.minute = 0;
-			sSidereal_time.hour++;
-			sSidereal_time.drawFlag++;
-
-			// Next day
-			if (sSidereal_time.hour == 24)
-			{
-				sSidereal_time.hour = 0;
-			}
-		}
-	}
+	// Flag is cleared by display_sidereal(), so keep highest pending value
+	changed = vclock_update(&sSidereal_time.clock);
+	if (changed > sSidereal_time.drawFlag) sSidereal_time.drawFlag = changed;
 }
 
 
@@ -342,9 +275,10 @@ void mx_sidereal(u8 line)
 	clear_display_all();
 
 	// Convert global time to local variables
-	hours		= sSidereal_time.hour;
-	minutes 	= sSidereal_time.minute;
-	seconds 	= sSidereal_time.second;
+	update_sidereal_clock();
+	hours		= sSidereal_time.clock.hour;
+	minutes 	= sSidereal_time.clock.minute;
+	seconds 	= sSidereal_time.clock.second;
 	
 	sync		= sSidereal_time.sync;
 	
@@ -462,7 +396,7 @@ void mx_sidereal(u8 line)
 			
 
 		// Button STAR (short): save, then exit
-		if (button.flag.star)
+		if (sButton.event == BUTTON_STAR)
 		{
 			//store sync settings
 			sSidereal_time.sync=sync;
@@ -507,16 +441,8 @@ void mx_sidereal(u8 line)
 			}
 			else
 			{
-				// Disable interrupts to prevent race conditions
-				Timer0_A1_Stop();
-
 				// Store local variables in global sidereal clock time
-				sSidereal_time.hour   = hours;
-				sSidereal_time.minute = minutes;
-				sSidereal_time.second = seconds;
-
-				// Set clock timer for one sidereal second in the future
-				Timer0_A1_Start();
+				vclock_set(&sSidereal_time.clock, (u32)hours*3600 + minutes*60 + seconds);
 			}
 			
 			// Full display update is done when returning from function
@@ -651,7 +577,7 @@ void mx_sidereal(u8 line)
 	}
 
 	// Clear button flags
-	button.all_flags = 0;
+	sButton.event = 0;
 }
 
 
@@ -678,6 +604,9 @@ void sx_sidereal(u8 line)
 // *************************************************************************************************
 void display_sidereal(u8 line, u8 update)
 {
+	// Get current sidereal time
+	update_sidereal_clock();
+	
 	// Partial update
 	if (update == DISPLAY_LINE_UPDATE_PARTIAL)
 	{
@@ -688,16 +617,17 @@ void display_sidereal(u8 line, u8 update)
 				switch(sSidereal_time.drawFlag)
 				{
 					case 3:
-						display_hours_12_or_24(switch_seg(line, LCD_SEG_L1_3_2, LCD_SEG_L2_3_2), sSidereal_time.hour, 2, 1, SEG_ON);
+						display_hours_12_or_24(switch_seg(line, LCD_SEG_L1_3_2, LCD_SEG_L2_3_2), sSidereal_time.clock.hour, 2, 1, SEG_ON);
 					case 2:
-						display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.minute, 2, 0), SEG_ON);
+						display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.clock.minute, 2, 0), SEG_ON);
 				}
 			}
 			else
 			{
 				// Seconds are always updated
-				display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.second, 2, 0), SEG_ON);
+				display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.clock.second, 2, 0), SEG_ON);
 			}
+			sSidereal_time.drawFlag = 0;
 		}
 	}
 	else if (update == DISPLAY_LINE_UPDATE_FULL)
@@ -711,15 +641,15 @@ void display_sidereal(u8 line, u8 update)
 		if ( ( line == LINE1 && sSidereal_time.line1ViewStyle == DISPLAY_DEFAULT_VIEW ) || ( line == LINE2 && sSidereal_time.line2ViewStyle == DISPLAY_DEFAULT_VIEW ) )
 		{
 			// Display hours
-			display_hours_12_or_24(switch_seg(line, LCD_SEG_L1_3_2, LCD_SEG_L2_3_2), sSidereal_time.hour, 2, 1, SEG_ON);
+			display_hours_12_or_24(switch_seg(line, LCD_SEG_L1_3_2, LCD_SEG_L2_3_2), sSidereal_time.clock.hour, 2, 1, SEG_ON);
 			// Display minute
-			display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.minute, 2, 0), SEG_ON);
+			display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.clock.minute, 2, 0), SEG_ON);
 			display_symbol(switch_seg(line, LCD_SEG_L1_COL, LCD_SEG_L2_COL0), SEG_ON_BLINK_ON);
 		}
 		else
 		{
 			// Display seconds
-			display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.second, 2, 0), SEG_ON);
+			display_chars(switch_seg(line, LCD_SEG_L1_1_0, LCD_SEG_L2_1_0), itoa(sSidereal_time.clock.second, 2, 0), SEG_ON);
 			display_symbol(switch_seg(line, LCD_SEG_L1_DP1, LCD_SEG_L2_DP), SEG_ON);
 		}
 	}
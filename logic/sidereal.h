@@ -36,16 +36,24 @@
 #ifndef SIDEREALTIME_H_
 #define SIDEREALTIME_H_
 
+// *************************************************************************************************
+// Include section
+#include "vclock.h"
+
 // *************************************************************************************************
 // Defines section
 
+// Sidereal seconds per solar second: 1.002737909350795 ~ 46879/46751 (error ~1e-12)
+#define SIDEREAL_RATE_NUM (46879u)
+#define SIDEREAL_RATE_DEN (46751u)
+
 // *************************************************************************************************
 // Prototypes section
+extern unsigned long sidereal_seconds(unsigned long rawtime);
 extern void sync_sidereal(void);
 extern void reset_sidereal_clock(void);
 extern void sx_sidereal(u8 line);
 extern void mx_sidereal(u8 line);
-extern void sidereal_clock_tick(void);
 extern void display_sidereal(u8 line, u8 update);
 
 // *************************************************************************************************
@@ -72,10 +80,8 @@ struct sidereal_time
 	u8		line1ViewStyle;
 	u8		line2ViewStyle;
 	
-	// Time data
-	u8		hour;
-	u8		minute;
-	u8 		second;
+	// Time data, derived from system time at sidereal rate
+	struct vclock clock;
 	
 	//SIDEREAL_NUM_LON different longitudes
 	struct longitude lon[SIDEREAL_NUM_LON];
@@ -49,6 +49,8 @@
 #include "ports.h"
 #include "display.h"
 #include "timer.h"
+#include "chrono.h"
+#include "retain.h"
 
 // logic
 #include "menu.h"
@@ -56,12 +58,13 @@
 
 // *************************************************************************************************
 // Prototypes section
-void start_stopwatch(void);
-void stop_stopwatch(void);
+void start_stopwatch(u32 ticks);
+void stop_stopwatch(u32 ticks);
 void reset_stopwatch(void);
-void split_stopwatch(void);
-void stopwatch_tick(void);
-void update_stopwatch_timer(void);
+void split_stopwatch(u32 ticks);
+u32 stopwatch_elapsed_at(u32 ticks);
+u16 stopwatch_refresh_delay(void);
+u8 stopwatch_keep_refresh(void);
 void mx_stopwatch(u8 line);
 void sx_stopwatch(u8 line);
 void display_stopwatch(u8 line, u8 update);
@@ -81,171 +84,72 @@ struct stopwatch sStopwatch;
 extern void menu_skip_next(line_t line); //ezchronos.c
 
 // *************************************************************************************************
-// @fn          update_stopwatch_timer
-// @brief       Set new compare time for next 1/1Hz or 1/100Hz interrupt. Takes care for exact 1 second timing.
-// @param       ticks (1 tick = 1/32768 sec)
-// @return      none
+// @fn          stopwatch_elapsed_at
+// @brief       Counted time of stopwatch, starts over after 20 hours. The timer engine is valid up 
+//				to 36 hours, so the wrap is applied to the engine whenever the time is read. 
+//				retain_save() reads it every minute.
+// @param       u32 ticks		Time stamp (Timer0_Ticks)
+// @return      u32				Counted time in 1/32768 sec, < STOPWATCH_WRAP_TICKS
 // *************************************************************************************************
-void update_stopwatch_timer(void)
+u32 stopwatch_elapsed_at(u32 ticks)
 {
-	u16 value;
-	if(!(sStopwatch.state & STOPWATCH_RUN)) return;
-	// Load CCR register with next capture time
-	if (sStopwatch.viewStyle == DISPLAY_DEFAULT_VIEW) 
+	istate_t int_state;
+	
+	// Only one caller may start over
+	int_state = __get_interrupt_state();
+	__disable_interrupt();
+	
+	ticks = chrono_elapsed_at(CHRONO_STOPWATCH, ticks);
+	if (ticks > 0xFFFFFFFFul - 2ul * CHRONO_SECOND)
 	{
-		// Timer interrupts occur every 32768/100 = 328 ACLK
-		// --> stopwatch runs too slow (1 sec nominal != 100 interupts * 328 ACLK = 32800 ACLK = 1.00098 sec)
-		// --> ideally correct timer value every 10 ticks by (32768 - 32800)/10 = 3.2
-		// --> correct timer value every 10Hz by 3, 
-		// --> correct timer value every 1Hz correct by 5
-		value = TA0CCR2 + STOPWATCH_100HZ_TICK;
-
-		if (sStopwatch.swtIs1Hz) 
-		{
-			value -= 5;
-			sStopwatch.swtIs1Hz = 0;	
-			sStopwatch.swtIs10Hz = 0;	
-		}
-		else if (sStopwatch.swtIs10Hz) 
-		{
-			value -= 3;
-			sStopwatch.swtIs10Hz = 0;	
-		}
+		// Time stamp of a button edge (< 2 sec old) taken before the last start over
+		ticks += STOPWATCH_WRAP_TICKS;
 	}
-	else // Alternative view
+	else if (ticks >= STOPWATCH_WRAP_TICKS)
 	{
-		// Timer interrupts occur every 32768/1 = 32768 ACLK
-		value = TA0CCR2 + STOPWATCH_1HZ_TICK;
+		chrono_rewind(CHRONO_STOPWATCH, STOPWATCH_WRAP_TICKS);
+		ticks -= STOPWATCH_WRAP_TICKS;
 	}
 	
-	// Update CCR
-	TA0CCR2 = value;   
+	__set_interrupt_state(int_state);
+	
+	return (ticks);
 }
 
 
 // *************************************************************************************************
-// @fn          stopwatch_tick
-// @brief       Called by 1/100Hz interrupt handler. 
-//				Increases stopwatch counter and triggers display update.
+// @fn          stopwatch_refresh_delay
+// @brief       Time to next digit change of running stopwatch. Called by the idle loop and by 
+//				Timer0_A4.
 // @param       none
-// @return      none
+// @return      u16		Ticks to next digit change
 // *************************************************************************************************
-void stopwatch_tick(void)
+u16 stopwatch_refresh_delay(void)
 {
-	static u8 delay = 0;
+	u32 ticks = stopwatch_elapsed_at(Timer0_Ticks());
 	
-	if(!(sStopwatch.state & STOPWATCH_RUN)) return;
-	// Default view (< 20 minutes): display and count MM:SS:hh
-	if (sStopwatch.viewStyle == DISPLAY_DEFAULT_VIEW)
-	{
-		// Add 1/100 sec 
-		sStopwatch.time[7]++;
-				
-		// Draw flag minimizes display update activity
-		//
-		// swt.drawFlag = 1: second L
-		// swt.drawFlag = 2: second H/L
-		// swt.drawFlag = 3: minutes L, second H/L
-		// swt.drawFlag = 4: minutes H/L, second H/L
-		// swt.drawFlag = 5: hours L, minutes H/L, second H/L
-		// swt.drawFlag = 6: hours H/L, minutes H/L, second H/L
-		// swt.drawFlag = 7: 1/10 sec, 1/100 sec
-		// swt.drawFlag = 8: 1/100 sec (every 17/100 sec to reduce display draw activity)
-		if (delay++ > 17) 
-		{
-			sStopwatch.drawFlag = 8;
-			delay = 0;
-		}
-	
-		// Add 1/10 sec 
-		if (sStopwatch.time[7] == 0x3A)
-		{
-			sStopwatch.time[7]='0';
-			sStopwatch.time[6]++;
-			
-			// 1/10Hz trigger 
-			sStopwatch.swtIs10Hz = 1;
-			
-			// Update draw flag
-			sStopwatch.drawFlag = 7;
-		}
-	} 
-	else // Alternative view (20 minutes .. 20 hours): display and count HH:MM:SS
-	{
-		// Just add 1 second
-		sStopwatch.time[6] = 0x3A;
-	}
-			
-	// Second overflow?
-	if (sStopwatch.time[6] == 0x3A)
-	{
-		// Reset draw flag
-		sStopwatch.drawFlag = 1;
+	// MM:SS:hh view shows 1/10 sec digit changes, HH:MM:SS view only second changes 
+	if (ticks < STOPWATCH_VIEW_TICKS)	return (chrono_digit_delay(ticks, CHRONO_10HZ, 0));
+	else								return (chrono_digit_delay(ticks, CHRONO_1HZ, 0));
+}
 
-		// 1Hz trigger 
-		sStopwatch.swtIs1Hz = 1;
-		
-		// Add data
-		sStopwatch.time[6]='0';
-		sStopwatch.time[5]++;							// second  L (0 - 9)
-		if (sStopwatch.time[5] == 0x3A) 
-		{
-			sStopwatch.drawFlag++;						// 2
-			sStopwatch.time[5] = '0';
-			sStopwatch.time[4]++;						// second  H (0 - 5)
-			if (sStopwatch.time[4] == '6') 
-			{
-				sStopwatch.drawFlag ++;					// 3
-				sStopwatch.time[4] = '0';
-				sStopwatch.time[3]++;					// minutes L (0 - 9)
-				if (sStopwatch.time[3] == 0x3A) 
-				{
-					sStopwatch.drawFlag++;				// 4
-					sStopwatch.time[3] = '0';
-					sStopwatch.time[2]++;				// minutes H (0 - 5)
-					if (sStopwatch.time[2] == '2')
-					{
-						// SWT display changes from MM:SS:hh to HH:MM:SS when reaching 20 minutes 
-						sStopwatch.viewStyle = DISPLAY_ALTERNATIVE_VIEW;
-						display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_FULL);
-						
-	   				} 
-					else if (sStopwatch.time[2] == '6') 
-					{
-						sStopwatch.drawFlag++;				// 5
-						sStopwatch.time[2] = '0';
-						sStopwatch.time[1]++;				// hours L (0-9)	
-
-						if (sStopwatch.time[1] == 0x3A) 
-						{
-							sStopwatch.drawFlag++;			// 6
-							sStopwatch.time[1] = '0';
-							sStopwatch.time[0]++;			// hours H (0-1)	
-
-							if (sStopwatch.time[0] == '2') 
-							{
-								// When reaching 20 hours, start over 
-								reset_stopwatch();
-								sStopwatch.state = STOPWATCH_RUN;
-								display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_FULL);
-							}
-		   				} 
-	   				} 
-				}
-			}
-		}
-	}		
+
+// *************************************************************************************************
+// @fn          stopwatch_keep_refresh
+// @brief       Start display refresh of running stopwatch. Called by the idle loop. Refresh is 
+//				aligned to the digits of the stopwatch.
+// @param       none
+// @return      u8		1 = stopwatch is running and visible
+// *************************************************************************************************
+u8 stopwatch_keep_refresh(void)
+{
+	if (!is_stopwatch_run()) return (0);
 	
-	//do not do partial update when in SPLIT mode
-	if(!(sStopwatch.state & STOPWATCH_SPLIT))
-	{
-		// Always set display update flag
-		display.flag.update_stopwatch = 1;
-	}
+	chrono_refresh(stopwatch_refresh_delay);
+	return (1);
 }
 
 
-
 // *************************************************************************************************
 // @fn          reset_stopwatch
 // @brief       Clears stopwatch counter and sets stopwatch state to reset (off).
@@ -256,16 +160,15 @@ void reset_stopwatch(void)
 {
 	// Clear counter
 	memcpy(sStopwatch.time, "00000000", sizeof(sStopwatch.time));
-
-	// Clear trigger
-	sStopwatch.swtIs10Hz 	= 0;		// 1/10Hz trigger
-	sStopwatch.swtIs1Hz  	= 0;		// 1Hz trigger
+	chrono_reset(CHRONO_STOPWATCH);
 	
 	// Init stopwatch state 'Reset' ('Off')
 	sStopwatch.state 	  	= STOPWATCH_RESET;		
 	
 	// Default display style is MM:SS:HH
 	sStopwatch.viewStyle 	= DISPLAY_DEFAULT_VIEW;
+	
+	retain_save();
 }
 
 
@@ -293,12 +196,15 @@ u8 is_stopwatch_stop(void)
 
 // *************************************************************************************************
 // @fn          start_stopwatch
-// @brief       Starts stopwatch timer interrupt and sets stopwatch state to on.
-// @param       none
+// @brief       Starts stopwatch and sets stopwatch state to on.
+// @param       u32 ticks		Time stamp of start (Timer0_Ticks)
 // @return      none
 // *************************************************************************************************
-void start_stopwatch(void)
+void start_stopwatch(u32 ticks)
 {
+	// Continue counting from elapsed time
+	chrono_start(CHRONO_STOPWATCH, ticks);
+
 	if(sStopwatch.state == STOPWATCH_SPLIT_STOP)
 	{
 		// Set stopwatch split flag
@@ -310,35 +216,25 @@ void start_stopwatch(void)
 		sStopwatch.state = STOPWATCH_RUN;
 	}
 
-	// Init CCR register with current time
-	TA0CCR2 = TA0R;
-		
-	// Load CCR register with next capture time
-	update_stopwatch_timer();
-
-	// Reset IRQ flag    
-	TA0CCTL2 &= ~CCIFG; 
-	          
-	// Enable timer interrupt    
-	TA0CCTL2 |= CCIE; 
+	// Set stopwatch icon (may be called in ISR context)
+	display_defer_symbol(LCD_ICON_STOPWATCH, SEG_ON);
 	
-	// Set stopwatch icon
-	display_symbol(LCD_ICON_STOPWATCH, SEG_ON);
+	// Keep counting over warm reset
+	retain_save();
 }
 
 
 // *************************************************************************************************
 // @fn          stop_stopwatch
-// @brief       Stops stopwatch timer interrupt and sets stopwatch state to off.
+// @brief       Stops stopwatch and sets stopwatch state to off.
 //				Does not reset stopwatch count.
-// @param       none
+// @param       u32 ticks		Time stamp of stop (Timer0_Ticks)
 // @return      none
 // *************************************************************************************************
-void stop_stopwatch(void)
+void stop_stopwatch(u32 ticks)
 {
-	// Clear timer interrupt enable   
-	TA0CCTL2 &= ~CCIE; 
-
+	chrono_stop(CHRONO_STOPWATCH, ticks);
+	
 	if(sStopwatch.state == STOPWATCH_RUN)
 	{
 		// Clear stopwatch run flag
@@ -350,33 +246,38 @@ void stop_stopwatch(void)
 		sStopwatch.state = STOPWATCH_SPLIT_STOP;
 	}
 	
-	// Clear stopwatch icon
-	display_symbol(LCD_ICON_STOPWATCH, SEG_OFF);
+	// Clear stopwatch icon (may be called in ISR context)
+	display_defer_symbol(LCD_ICON_STOPWATCH, SEG_OFF);
 
-	// Call draw routine immediately
-	display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_FULL);
+	// Call draw routine before next LPM entry
+	display_defer_line(display_stopwatch, LINE2, DISPLAY_LINE_UPDATE_FULL);
+	
+	retain_save();
 }
 
 
 // *************************************************************************************************
 // @fn          split_stopwatch
 // @brief       activate or deactivate split (lap time)
-// @param       none
+// @param       u32 ticks		Time stamp of split (Timer0_Ticks)
 // @return      none
 // *************************************************************************************************
-void split_stopwatch(void)
+void split_stopwatch(u32 ticks)
 {
 	if(sStopwatch.state == STOPWATCH_RUN)
 	{
 		sStopwatch.state = STOPWATCH_SPLIT_RUN;
-		memcpy(sStopwatch.time_split, sStopwatch.time, sizeof(sStopwatch.time));
-		sStopwatch.viewStyle_split=sStopwatch.viewStyle;
+		ticks = stopwatch_elapsed_at(ticks);
+		chrono_digits(ticks, sStopwatch.time_split);
+		if (ticks < STOPWATCH_VIEW_TICKS)	sStopwatch.viewStyle_split = DISPLAY_DEFAULT_VIEW;
+		else								sStopwatch.viewStyle_split = DISPLAY_ALTERNATIVE_VIEW;
+		display_defer_line(display_stopwatch, LINE2, DISPLAY_LINE_UPDATE_FULL);
 	}
 	else
 	{
 		//clear split bit
 		sStopwatch.state &= ~STOPWATCH_SPLIT;
-		display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_FULL);
+		display_defer_line(display_stopwatch, LINE2, DISPLAY_LINE_UPDATE_FULL);
 	}
 
 }
@@ -399,7 +300,7 @@ void mx_stopwatch(u8 line)
 	else if(sStopwatch.state == STOPWATCH_STOP)
 	{
 		// Stop stopwatch
-		stop_stopwatch();
+		stop_stopwatch(Timer0_Ticks());
 				
 		// Reset stopwatch count
 		reset_stopwatch();	
@@ -409,7 +310,7 @@ void mx_stopwatch(u8 line)
 	}
 	else
 	{
-		split_stopwatch();
+		split_stopwatch(Timer0_Ticks());
 	}
 }
 
@@ -426,17 +327,17 @@ void sx_stopwatch(u8 line)
 	//start_stopwatch and stop_stopwatch are called directly in ports.c
 	
 	// DOWN: RUN, STOP
-	if(button.flag.down)
+	if(sButton.event == BUTTON_DOWN)
 	{
 		if((sStopwatch.state & STOPWATCH_STOP) || sStopwatch.state == STOPWATCH_RESET )
 		{
 			// (Re)start stopwatch
-			start_stopwatch();
+			start_stopwatch(Timer0_Ticks());
 		}
 		else 
 		{
 			// Stop stopwatch 
-			stop_stopwatch();
+			stop_stopwatch(Timer0_Ticks());
 		}
 			
 	}
@@ -452,42 +353,49 @@ void sx_stopwatch(u8 line)
 // *************************************************************************************************
 void display_stopwatch(u8 line, u8 update)
 {
+	u8 time[8];
+	u32 ticks;
+	u8 view;
+	u8 i;
+	
 	// Partial line update only
 	if (update == DISPLAY_LINE_UPDATE_PARTIAL)
 	{	
 		if (display.flag.update_stopwatch && !(sStopwatch.state & STOPWATCH_SPLIT))
 		{
+			ticks = stopwatch_elapsed_at(Timer0_Ticks());
+			chrono_digits(ticks, time);
+			
+			// SWT display changes from MM:SS:hh to HH:MM:SS when reaching 20 minutes 
+			view = (ticks < STOPWATCH_VIEW_TICKS) ? DISPLAY_DEFAULT_VIEW : DISPLAY_ALTERNATIVE_VIEW;
+			if (view != sStopwatch.viewStyle)
+			{
+				sStopwatch.viewStyle = view;
+				
+				// Refresh rate changes with view
+				chrono_stop_refresh();
+				display_stopwatch(line, DISPLAY_LINE_UPDATE_FULL);
+				return;
+			}
+			
+			// Draw changed digits only
 			if (sStopwatch.viewStyle == DISPLAY_DEFAULT_VIEW)
 			{
 				// Display MM:SS:hh
-
-				// Check draw flag to minimize workload
-				if(sStopwatch.drawFlag != 0) 
+				for (i=2; i<8; i++)
 				{
-					switch(sStopwatch.drawFlag) 
-					{
-						case 4: display_char(LCD_SEG_L2_5, sStopwatch.time[2], SEG_ON);
-						case 3: display_char(LCD_SEG_L2_4, sStopwatch.time[3], SEG_ON);
-						case 2: display_char(LCD_SEG_L2_3, sStopwatch.time[4], SEG_ON);
-						case 1: display_char(LCD_SEG_L2_2, sStopwatch.time[5], SEG_ON);
-						case 7: display_char(LCD_SEG_L2_1, sStopwatch.time[6], SEG_ON);
-						case 8:	display_char(LCD_SEG_L2_0, sStopwatch.time[7], SEG_ON);
-					}
+					if (time[i] != sStopwatch.time[i]) display_char(LCD_SEG_L2_5 + (i-2), time[i], SEG_ON);
 				}
 			}
 			else // DISPLAY_ALTERNATIVE_VIEW
 			{
 				// Display HH:MM:SS
-				switch(sStopwatch.drawFlag) 
+				for (i=0; i<6; i++)
 				{
-					case 6: display_char(LCD_SEG_L2_5, sStopwatch.time[0], SEG_ON);
-					case 5: display_char(LCD_SEG_L2_4, sStopwatch.time[1], SEG_ON);
-					case 4: display_char(LCD_SEG_L2_3, sStopwatch.time[2], SEG_ON);
-					case 3: display_char(LCD_SEG_L2_2, sStopwatch.time[3], SEG_ON);
-					case 2: display_char(LCD_SEG_L2_1, sStopwatch.time[4], SEG_ON);
-					case 1: display_char(LCD_SEG_L2_0, sStopwatch.time[5], SEG_ON);
-				}		
+					if (time[i] != sStopwatch.time[i]) display_char(LCD_SEG_L2_5 + i, time[i], SEG_ON);
+				}
 			}
+			memcpy(sStopwatch.time, time, sizeof(sStopwatch.time));
 		}
 	}
 	// Redraw whole line
@@ -508,6 +416,10 @@ void display_stopwatch(u8 line, u8 update)
 		}
 		else
 		{
+			ticks = stopwatch_elapsed_at(Timer0_Ticks());
+			chrono_digits(ticks, sStopwatch.time);
+			sStopwatch.viewStyle = (ticks < STOPWATCH_VIEW_TICKS) ? DISPLAY_DEFAULT_VIEW : DISPLAY_ALTERNATIVE_VIEW;
+			
 			if (sStopwatch.viewStyle == DISPLAY_DEFAULT_VIEW)
 			{
 				// Display MM:SS:hh
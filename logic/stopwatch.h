@@ -43,14 +43,14 @@
 
 // *************************************************************************************************
 // Prototypes section
-extern void start_stopwatch(void);
-extern void stop_stopwatch(void);
+extern void start_stopwatch(u32 ticks);
+extern void stop_stopwatch(u32 ticks);
 extern void reset_stopwatch(void);
-extern void split_stopwatch(void);
+extern void split_stopwatch(u32 ticks);
+extern u32 stopwatch_elapsed_at(u32 ticks);
 extern u8 is_stopwatch_run(void);
 extern u8 is_stopwatch_stop(void);
-extern void stopwatch_tick(void);
-extern void update_stopwatch_timer(void);
+extern u8 stopwatch_keep_refresh(void);
 extern void mx_stopwatch(u8 line);
 extern void sx_stopwatch(u8 line);
 extern void display_stopwatch(u8 line, u8 update);
@@ -58,8 +58,8 @@ extern void display_stopwatch(u8 line, u8 update);
 
 // *************************************************************************************************
 // Defines section
-#define STOPWATCH_1HZ_TICK			(32768/1)
-#define STOPWATCH_100HZ_TICK		328 // PFS corrected(32768/100)
+#define STOPWATCH_VIEW_TICKS		(20ul*60ul*32768ul)			// MM:SS:hh view up to 20 minutes
+#define STOPWATCH_WRAP_TICKS		(20ul*3600ul*32768ul)		// Start over after 20 hours
 #define STOPWATCH_RESET				0x0
 #define STOPWATCH_STOP				0x1
 #define STOPWATCH_RUN				0x2
@@ -77,9 +77,6 @@ extern void display_stopwatch(u8 line, u8 update);
 struct stopwatch
 {
 	u8 		state;
-	u8		drawFlag;
-	u8		swtIs1Hz;
-	u8		swtIs10Hz;
 	
 	//	time[0] 	hour H
 	//	time[1] 	hour L
@@ -89,7 +86,7 @@ struct stopwatch
 	//	time[5] 	second L
 	//	time[6] 	1/10 sec 
 	//	time[7] 	1/100 sec
-	u8		time[8]; //ASCII codes
+	u8		time[8]; //ASCII codes of last drawn time
 	u8		time_split[8];
 	
 	// Display style
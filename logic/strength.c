@@ -16,6 +16,9 @@
 
 // driver
 #include "display.h"
+#include "event.h"
+#include "timer.h"
+#include "chrono.h"
 
 // logic
 #include "menu.h"
@@ -58,7 +61,8 @@ void display_strength_time(u8 line, u8 update)
 
 // *************************************************************************************************
 // @fn          strength_tick
-// @brief       A second has passed. Recompute strength state. To be called from timer int handler.
+// @brief       A second has passed. Recompute strength state. Called by the timer engine in ISR context
+//              once per second since the start button was pressed.
 // @return      none
 // Precondition: the running flag is true. (Just don't call this if Strength is in stopped state)
 // *************************************************************************************************
@@ -98,6 +102,7 @@ void strength_tick(void)
 		case STRENGTH_THRESHOLD_END: 
 			strength_data.num_beeps = 4;
 			strength_data.flags.running = 0;
+			chrono_stop(CHRONO_STRENGTH, Timer0_Ticks());
 			break;
 		}
 
@@ -119,11 +124,11 @@ void strength_tick(void)
 
 	// strength_data.num_beeps describes the beeping pattern,
 	// but since beeping is done in the process_requests phase,
-	// we have to set a request flag so that process_requests 
+	// we have to queue an event so that process_requests 
 	// is called at all.
 	if (strength_data.num_beeps != 0) 
 	{
-		request.flag.strength_buzzer = 1;
+		event_push(EVENT_STRENGTH_BUZZER, 0);
 	}
 	
 }
@@ -156,6 +161,7 @@ void strength_sx(u8 line)
 	{
 		// stop running, but display the result
 		strength_data.flags.running = 0;
+		chrono_stop(CHRONO_STRENGTH, Timer0_Ticks());
 	}
 	else 
 	{
@@ -167,6 +173,10 @@ void strength_sx(u8 line)
 		}
 		else
 		{	
+			// count seconds from button press
+			chrono_reset(CHRONO_STRENGTH);
+			chrono_set_function(CHRONO_STRENGTH, CHRONO_SECOND, CHRONO_SECOND, strength_tick);
+			chrono_start(CHRONO_STRENGTH, Timer0_Ticks());
 			strength_data.flags.running = 1;
 		}
 	}
@@ -224,7 +224,7 @@ void mx_temperature(u8 line)
 		if (sys.flag.idle_timeout) break;
 
 		// Button STAR (short): save, then exit 
-		if (button.flag.star) 
+		if (sButton.event == BUTTON_STAR) 
 		{
 			// For English units, convert set F to C
 #ifdef CONFIG_METRIC_ONLY
@@ -263,7 +263,7 @@ void mx_temperature(u8 line)
 	}	
 	
 	// Clear button flags
-	button.all_flags = 0;
+	sButton.event = 0;
 }
 
 
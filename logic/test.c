@@ -52,6 +52,7 @@
 #include "vti_ps.h"
 #include "ports.h"
 #include "timer.h"
+#include "event.h"
 
 // logic
 #ifdef FEATURE_PROVIDE_ACCEL
@@ -113,6 +114,7 @@ void test_mode(void)
 	WDTCTL = WDTPW + WDTHOLD;
 
 	// Wait for button press 
+	display_commit();
 	_BIS_SR(LPM3_bits + GIE); 
 	__no_operation();
 
@@ -160,7 +162,7 @@ void test_mode(void)
 								display_altitude(LINE1, DISPLAY_LINE_UPDATE_FULL);
 								for (i=0; i<2; i++)
 								{
-									while((PS_INT_IN & PS_INT_PIN) == 0); 
+									if (!ps_wait_ready()) break;
 									do_altitude_measurement(FILTER_OFF);
 									display_altitude(LINE1, DISPLAY_LINE_UPDATE_PARTIAL);
 								}
@@ -194,7 +196,7 @@ void test_mode(void)
 						//pfs
 						#ifndef ELIMINATE_BLUEROBIN
 						case 4:	// BlueRobin test
-								button.flag.up = 1;
+								sButton.event = BUTTON_UP;
 								sx_bluerobin(LINE1);
 								Timer0_A4_Delay(CONV_MS_TO_TICKS(100));
 								get_bluerobin_data();
@@ -256,10 +258,11 @@ void test_mode(void)
 				}
 				
 #ifdef USE_WATCHDOG		
-				// Service watchdog
-				WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
+				// Service watchdog - only buttons and the minute IRQ wake up this loop
+				WDTCTL = WDTPW + WDTIS__8192K + WDTSSEL__ACLK + WDTCNTCL;
 #endif
 				// To LPM3
+				display_commit();
 				_BIS_SR(LPM3_bits + GIE);  
 				__no_operation();
 			}
@@ -268,7 +271,8 @@ void test_mode(void)
 		{
 			// Debounce button
 			Timer0_A4_Delay(CONV_MS_TO_TICKS(100));
-			button.all_flags = 0;
+			event_discard(EVENT_BUTTON);
+			sButton.event = 0;
 			break;
 		}
 	}
@@ -278,13 +282,11 @@ void test_mode(void)
 
 void display_all_on(void)
 {
-	u8 * lcdptr = (u8*)0x0A20;
 	u8 i;
 	
-	for (i=1; i<=12; i++) 
+	for (i=0; i<LCD_MEM_SIZE; i++) 
 	{
-		*lcdptr = 0xFF; 
-		lcdptr++;
+		write_lcd_mem(LCD_MEM_1 + i, 0xFF, 0xFF, SEG_ON);
 	}
 }
 
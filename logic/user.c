@@ -116,7 +116,7 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
 	s32 orig_val=*value;
 	
 	// Clear button flags
-	button.all_flags = 0;
+	sButton.event = 0;
 	
 	// Clear blink memory
 	clear_blink_mem();
@@ -149,16 +149,16 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
 		if (sys.flag.idle_timeout) break;
 
 		// Button STAR (short) button: exit function
-		if (button.flag.star) break;
+		if (sButton.event == BUTTON_STAR) break;
 
 		// NUM button: exit function and goto to next value (if available)
-		if (button.flag.num)
+		if (sButton.event == BUTTON_NUM)
 		{
 			if ((mode & SETVALUE_NEXT_VALUE) == SETVALUE_NEXT_VALUE) break;
 		}
 
 		// UP button: increase value
-		if(button.flag.up)
+		if(sButton.event == BUTTON_UP)
 		{
 			// Increase value
 			* value = * value + stepValue;
@@ -185,11 +185,11 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
 			update = 1;
 			
 			// Clear button flag
-			button.flag.up = 0;
+			sButton.event = 0;
 		}
 		
 		// DOWN button: decrease value
-		if(button.flag.down)
+		if(sButton.event == BUTTON_DOWN)
 		{
 			// Decrease value
 			* value = * value - stepValue;
@@ -216,9 +216,11 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
 			update = 1;
 
 			// Clear button flag	
-			button.flag.down = 0;
+			sButton.event = 0;
 		}
 
+		// Drop button events without function here
+		sButton.event = 0;
 		
 		// When fast mode is enabled, increase step size if Sx button is continuously
 		if ((mode & SETVALUE_FAST_MODE) == SETVALUE_FAST_MODE)
@@ -0,0 +1,161 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Host build replacement of the CC430F6137 device header. Peripheral registers are plain 
+// variables (defined in host.c), bit constants have the values of the device header. Only the 
+// names used by the modules under test are listed.
+// *************************************************************************************************
+
+#ifndef __CC430F6137_HOST
+#define __CC430F6137_HOST
+
+#define HOST_REG(name)						extern volatile unsigned short name
+
+// Status register
+#define CPUOFF								(0x0010u)
+#define GIE									(0x0008u)
+#define SCG0								(0x0040u)
+#define SCG1								(0x0080u)
+#define LPM0_bits							(CPUOFF)
+#define LPM3_bits							(SCG1+SCG0+CPUOFF)
+
+#define BIT0								(0x0001u)
+#define BIT1								(0x0002u)
+#define BIT2								(0x0004u)
+#define BIT3								(0x0008u)
+#define BIT4								(0x0010u)
+#define BIT5								(0x0020u)
+#define BIT6								(0x0040u)
+#define BIT7								(0x0080u)
+#define BIT8								(0x0100u)
+#define BIT9								(0x0200u)
+#define BITA								(0x0400u)
+#define BITB								(0x0800u)
+#define BITC								(0x1000u)
+#define BITD								(0x2000u)
+#define BITE								(0x4000u)
+#define BITF								(0x8000u)
+
+// Ports
+HOST_REG(P2IN);
+HOST_REG(P2OUT);
+HOST_REG(P2DIR);
+HOST_REG(P2IES);
+HOST_REG(P2IE);
+HOST_REG(P2IFG);
+HOST_REG(P2REN);
+HOST_REG(P5DIR);
+HOST_REG(P5SEL);
+HOST_REG(PJIN);
+HOST_REG(PJOUT);
+HOST_REG(PJDIR);
+
+// Watchdog
+HOST_REG(WDTCTL);
+#define WDTPW								(0x5A00u)
+#define WDTHOLD								(0x0080u)
+#define WDTSSEL__ACLK						(0x0020u)
+#define WDTCNTCL							(0x0008u)
+#define WDTIS__8192K						(0x0002u)
+#define WDTIS__512K							(0x0003u)
+
+// Timer0_A5
+HOST_REG(TA0CTL);
+HOST_REG(TA0R);
+HOST_REG(TA0IV);
+HOST_REG(TA0CCTL0);
+HOST_REG(TA0CCTL1);
+HOST_REG(TA0CCTL2);
+HOST_REG(TA0CCTL3);
+HOST_REG(TA0CCTL4);
+HOST_REG(TA0CCR0);
+HOST_REG(TA0CCR1);
+HOST_REG(TA0CCR2);
+HOST_REG(TA0CCR3);
+HOST_REG(TA0CCR4);
+#define TASSEL0								(0x0100u)
+#define MC1									(0x0020u)
+#define MC_2								(0x0020u)
+#define TACLR								(0x0004u)
+#define CCIE								(0x0010u)
+#define CCIFG								(0x0001u)
+
+// RTC_A
+HOST_REG(RTCCTL01);
+HOST_REG(RTCCTL2);
+HOST_REG(RTCIV);
+HOST_REG(RTCPS);
+HOST_REG(RTCSEC);
+HOST_REG(RTCMIN);
+HOST_REG(RTCHOUR);
+HOST_REG(RTCDOW);
+HOST_REG(RTCDAY);
+HOST_REG(RTCMON);
+HOST_REG(RTCYEAR);
+HOST_REG(RTCAMIN);
+HOST_REG(RTCAHOUR);
+HOST_REG(RTCADOW);
+HOST_REG(RTCADAY);
+#define RTCAIFG								(0x0002u)
+#define RTCAIE								(0x0020u)
+#define RTCTEVIE							(0x0040u)
+#define RTCTEV_0							(0x0000u)
+#define RTCMODE								(0x2000u)
+#define RTCHOLD								(0x4000u)
+#define RTCCALS								(0x0080u)
+#define RTCAE								(0x0080u)
+
+// LCD_B
+HOST_REG(LCDBCTL0);
+HOST_REG(LCDBPCTL0);
+HOST_REG(LCDBPCTL1);
+HOST_REG(LCDBBLKCTL);
+HOST_REG(LCDBMEMCTL);
+#define LCDON								(0x0001u)
+#define LCD4MUX								(0x0018u)
+#define LCDPRE0								(0x0100u)
+#define LCDPRE1								(0x0200u)
+#define LCDDIV0								(0x0800u)
+#define LCDDIV1								(0x1000u)
+#define LCDDIV2								(0x2000u)
+#define LCDBLKMOD0							(0x0001u)
+#define LCDBLKPRE0							(0x0004u)
+#define LCDBLKPRE1							(0x0008u)
+#define LCDBLKDIV0							(0x0020u)
+#define LCDBLKDIV1							(0x0040u)
+#define LCDBLKDIV2							(0x0080u)
+#define LCDCLRM								(0x0002u)
+#define LCDCLRBM							(0x0004u)
+
+#endif /* __CC430F6137_HOST */
@@ -0,0 +1,61 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Peripheral registers and CPU state of the host build.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+#include "project.h"
+#include "../test.h"
+
+
+// *************************************************************************************************
+// Global Variable section
+istate_t host_sr;
+unsigned long host_lpm_exits;
+
+volatile unsigned short P2IN, P2OUT, P2DIR, P2IES, P2IE, P2IFG, P2REN, P5DIR, P5SEL, PJIN, PJOUT, PJDIR;
+volatile unsigned short WDTCTL;
+volatile unsigned short TA0CTL, TA0R, TA0IV;
+volatile unsigned short TA0CCTL0, TA0CCTL1, TA0CCTL2, TA0CCTL3, TA0CCTL4;
+volatile unsigned short TA0CCR0, TA0CCR1, TA0CCR2, TA0CCR3, TA0CCR4;
+volatile unsigned short RTCCTL01, RTCCTL2, RTCIV, RTCPS;
+volatile unsigned short RTCSEC, RTCMIN, RTCHOUR, RTCDOW, RTCDAY, RTCMON, RTCYEAR;
+volatile unsigned short RTCAMIN, RTCAHOUR, RTCADOW, RTCADAY;
+volatile unsigned short LCDBCTL0, LCDBPCTL0, LCDBPCTL1, LCDBBLKCTL, LCDBMEMCTL;
+
+// Failed checks of the running test
+int test_failures;
@@ -0,0 +1,83 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Host build replacement of the compiler intrinsics. Interrupt state is a plain variable, and 
+// leaving a low power mode on RETI is counted so tests can see how often the CPU wakes up.
+// *************************************************************************************************
+
+#ifndef __INTRINSICS_H
+#define __INTRINSICS_H
+
+#include <signal.h>
+
+typedef unsigned short istate_t;
+
+// Status register as seen by the firmware, GIE is set while "interrupts are enabled"
+extern istate_t host_sr;
+
+// Bits cleared by _BIC_SR_IRQ(), summed over all calls, and the number of calls
+extern unsigned long host_lpm_exits;
+
+#define __get_interrupt_state()				(host_sr)
+#define __set_interrupt_state(x)			(host_sr = (x))
+#define __disable_interrupt()				(host_sr &= ~GIE)
+#define __enable_interrupt()				(host_sr |= GIE)
+#define __no_operation()
+#define __even_in_range(value, bound)		(value)
+#define __delay_cycles(cycles)
+
+#define _BIS_SR(x)							(host_sr |= (x))
+#define _BIC_SR(x)							(host_sr &= ~(x))
+#define _BIC_SR_IRQ(x)						(host_lpm_exits++)
+#define __bic_SR_register_on_exit(x)		(host_lpm_exits++)
+
+// Decimal (BCD) addition of two packed 8-digit values, DADD done digit by digit
+static inline unsigned long __bcd_add_long(unsigned long __a, unsigned long __b)
+{
+	unsigned long sum = 0;
+	unsigned int digit, carry = 0, i;
+	
+	for (i=0; i<32; i+=4)
+	{
+		digit = ((__a >> i) & 0xF) + ((__b >> i) & 0xF) + carry;
+		carry = (digit > 9);
+		if (carry) digit -= 10;
+		sum |= (unsigned long)digit << i;
+	}
+	
+	return (sum & 0xFFFFFFFFul);
+}
+
+
+#endif /* __INTRINSICS_H */
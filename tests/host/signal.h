@@ -0,0 +1,2 @@
+// Host build: interrupt service routines become plain functions the tests can call
+#define interrupt(x) void
@@ -0,0 +1,297 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// *************************************************************************************************
+// Button gestures through the event ring. Every press is queued as its own typed event in the 
+// order and with the TA0R stamp of its edge - fast presses are neither merged nor lost.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include "test.h"
+
+// driver
+#include "ports.h"
+#include "event.h"
+#include "timer.h"
+
+
+// *************************************************************************************************
+// Defines section
+
+#define MS(x)						((u16)CONV_MS_TO_TICKS(x))
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Modules of the firmware that are not part of this test
+volatile s_system_flags sys;
+
+// Simulated TA0R
+u16 sim_now;
+
+// Simulated one-shot gesture timer (0 = stopped)
+u16 sim_timer;
+void (*sim_timer_fptr)(void);
+
+
+// *************************************************************************************************
+// Extern section
+extern void button_gesture_reset(void);
+extern u8 button_gesture_edge(u16 stamp);
+extern void button_gesture_tick(void);
+
+
+// *************************************************************************************************
+// @fn          Timer0_A4_Start
+// @brief       Record the gesture timer instead of programming TA0CCR4.
+// @param       u8 timer		Timer0_A4 channel
+//				u16 ticks		Delay until callback
+//				u16 period		Reload value
+//				void (*fptr)	Callback
+// @return      none
+// *************************************************************************************************
+void Timer0_A4_Start(u8 timer, u16 ticks, u16 period, void (*fptr)(void))
+{
+	if (timer != TIMER0_A4_GESTURE) return;
+	sim_timer = ticks;
+	sim_timer_fptr = fptr;
+}
+
+
+// *************************************************************************************************
+// @fn          Timer0_A4_Stop
+// @brief       Stop the recorded gesture timer.
+// @param       u8 timer		Timer0_A4 channel
+// @return      none
+// *************************************************************************************************
+void Timer0_A4_Stop(u8 timer)
+{
+	if (timer == TIMER0_A4_GESTURE) sim_timer = 0;
+}
+
+
+// *************************************************************************************************
+// @fn          sim_edge
+// @brief       Set button levels and classify the edges like the debounce timer does.
+// @param       u8 level		Held buttons
+//				u16 ms			Time since last edge
+// @return      none
+// *************************************************************************************************
+void sim_edge(u8 level, u16 ms)
+{
+	sim_now += MS(ms);
+	TA0R = sim_now;
+	BUTTONS_IN = level;
+	button_gesture_edge(sim_now);
+}
+
+
+// *************************************************************************************************
+// @fn          sim_expire
+// @brief       Advance TA0R to the gesture timer and run its callback like TIMER0_A1_5_ISR does.
+// @param       none
+// @return      u16				Ticks the timer was armed for, 0 if it was stopped
+// *************************************************************************************************
+u16 sim_expire(void)
+{
+	u16 ticks = sim_timer;
+	
+	if (ticks == 0) return (0);
+	sim_timer = 0;
+	sim_now += ticks;
+	TA0R = sim_now;
+	sim_timer_fptr();
+	return (ticks);
+}
+
+
+// *************************************************************************************************
+// @fn          sim_pop
+// @brief       Take next event from ring and compare it.
+// @param       u8 arg			Expected button event
+//				u16 stamp		Expected TA0R stamp
+// @return      u8				1 = event matches
+// *************************************************************************************************
+u8 sim_pop(u8 arg, u16 stamp)
+{
+	s_event ev;
+	
+	if (!event_pop(&ev)) return (0);
+	return ((ev.type == EVENT_BUTTON) && (ev.arg == arg) && (ev.stamp == stamp));
+}
+
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Queue fast clicks, overlapping presses, long presses and a chord, drop button 
+//				events, coalesce redraw requests and fill the ring.
+// @param       none
+// @return      int				0 if all checks passed
+// *************************************************************************************************
+int main(void)
+{
+	s_event ev;
+	u16 release[5];
+	u16 press;
+	u8 i;
+	
+	// Five fast UP clicks: five short presses, the second click of each pair is a double-click
+	event_reset();
+	button_gesture_reset();
+	for (i=0; i<5; i++)
+	{
+		sim_edge(BUTTON_UP_PIN, 50);
+		sim_edge(0, 50);
+		release[i] = sim_now;
+	}
+	CHECK(sim_pop(BUTTON_UP, release[0]), "fast clicks: 1st press");
+	CHECK(sim_pop(BUTTON_UP, release[1]), "fast clicks: 2nd press");
+	CHECK(sim_pop(BUTTON_UP | BUTTON_DOUBLE, release[1]), "fast clicks: 1st double-click");
+	CHECK(sim_pop(BUTTON_UP, release[2]), "fast clicks: 3rd press");
+	CHECK(sim_pop(BUTTON_UP, release[3]), "fast clicks: 4th press");
+	CHECK(sim_pop(BUTTON_UP | BUTTON_DOUBLE, release[3]), "fast clicks: 2nd double-click");
+	CHECK(sim_pop(BUTTON_UP, release[4]), "fast clicks: 5th press");
+	CHECK(!is_event_pending(), "fast clicks: extra events");
+	
+	// Overlapping presses of different buttons keep the order of their releases
+	event_reset();
+	button_gesture_reset();
+	sim_edge(BUTTON_STAR_PIN, 1000);
+	sim_edge(BUTTON_STAR_PIN | BUTTON_NUM_PIN, 30);
+	sim_edge(BUTTON_NUM_PIN, 30);
+	release[0] = sim_now;
+	sim_edge(0, 30);
+	release[1] = sim_now;
+	CHECK(sim_pop(BUTTON_STAR, release[0]), "rollover: STAR");
+	CHECK(sim_pop(BUTTON_NUM, release[1]), "rollover: NUM");
+	CHECK(!is_event_pending(), "rollover: extra events");
+	
+	// Long press released before gesture timer saw it
+	event_reset();
+	button_gesture_reset();
+	sim_edge(BUTTON_DOWN_PIN, 1000);
+	sim_edge(0, BUTTONS_LONG_TIME + 10);
+	CHECK(sim_pop(BUTTON_DOWN | BUTTON_LONG, sim_now), "long press");
+	
+	// Held long press is reported by the gesture timer exactly at long press time
+	event_reset();
+	button_gesture_reset();
+	sim_edge(BUTTON_DOWN_PIN, 1000);
+	press = sim_now;
+	CHECK(sim_expire() == MS(BUTTONS_LONG_TIME), "held long press: timer %u", sim_timer);
+	CHECK(sim_pop(BUTTON_DOWN | BUTTON_LONG, press + MS(BUTTONS_LONG_TIME)), "held long press: event");
+	CHECK(sim_timer == 0, "held long press: timer still running");
+	sim_edge(0, 500);
+	CHECK(!is_event_pending(), "held long press: extra events");
+	
+	// Click of another button while one is held does not delay its long press
+	event_reset();
+	button_gesture_reset();
+	sim_edge(BUTTON_DOWN_PIN, 1000);
+	press = sim_now;
+	sim_edge(BUTTON_DOWN_PIN | BUTTON_STAR_PIN, 300);
+	sim_edge(BUTTON_DOWN_PIN, 50);
+	CHECK(sim_pop(BUTTON_STAR, sim_now), "held long press with click: click");
+	while (sim_expire() && !is_event_pending());
+	CHECK(sim_pop(BUTTON_DOWN | BUTTON_LONG, press + MS(BUTTONS_LONG_TIME)), "held long press with click: event");
+	
+	// Chord is detected when its last button reaches long press time
+	event_reset();
+	button_gesture_reset();
+	sys.flag.no_beep = 0;
+	sim_edge(BUTTON_STAR_PIN, 1000);
+	sim_edge(BUTTON_STAR_PIN | BUTTON_UP_PIN, 100);
+	press = sim_now;
+	while (sim_expire() && !sys.flag.no_beep);
+	CHECK(sys.flag.no_beep, "chord: beep not toggled");
+	CHECK(event_pop(&ev) && (ev.type == EVENT_MESSAGE) && (ev.arg == MESSAGE_NO_BEEP_ON), "chord: message");
+	CHECK((u16)(sim_now - press) == MS(BUTTONS_LONG_TIME), "chord: detected after %u ticks", (u16)(sim_now - press));
+	CHECK(sim_timer == 0, "chord: timer still running");
+	sim_edge(0, 50);
+	CHECK(!is_event_pending(), "chord: extra events");
+	
+	// Double-click candidate stops the gesture timer when it expires
+	event_reset();
+	button_gesture_reset();
+	sim_edge(BUTTON_UP_PIN, 1000);
+	sim_edge(0, 50);
+	CHECK(sim_expire() == MS(BUTTONS_DOUBLE_TIME) + 1, "double-click expiry");
+	CHECK(sim_timer == 0, "double-click expiry: timer still running");
+	
+	// Dropping button events keeps the other events in order
+	event_reset();
+	button_gesture_reset();
+	sim_edge(BUTTON_UP_PIN, 1000);
+	event_push(EVENT_VOLTAGE, 0);
+	sim_edge(0, 50);
+	event_push(EVENT_ALARM, 1);
+	sim_edge(BUTTON_DOWN_PIN, 500);
+	sim_edge(0, 50);
+	event_push(EVENT_BUZZER, 2);
+	event_discard(EVENT_BUTTON);
+	CHECK(event_pop(&ev) && (ev.type == EVENT_VOLTAGE), "discard: 1st event");
+	CHECK(event_pop(&ev) && (ev.type == EVENT_ALARM) && (ev.arg == 1), "discard: 2nd event");
+	CHECK(event_pop(&ev) && (ev.type == EVENT_BUZZER) && (ev.arg == 2), "discard: 3rd event");
+	CHECK(!event_pop(&ev), "discard: extra events");
+	
+	// Redraw requests are queued once until the main loop takes them
+	event_reset();
+	event_push_level(EVENT_STOPWATCH);
+	event_push_level(EVENT_TIME);
+	event_push_level(EVENT_STOPWATCH);
+	CHECK(event_pop(&ev) && (ev.type == EVENT_STOPWATCH), "redraw: 1st event");
+	CHECK(event_pop(&ev) && (ev.type == EVENT_TIME), "redraw: 2nd event");
+	CHECK(!event_pop(&ev), "redraw: extra events");
+	event_push_level(EVENT_STOPWATCH);
+	CHECK(event_pop(&ev) && (ev.type == EVENT_STOPWATCH), "redraw: queued again after taken");
+	
+	// Full ring drops and counts further presses, none is overwritten
+	event_reset();
+	button_gesture_reset();
+	for (i=0; i<EVENT_RING_SIZE; i++)
+	{
+		sim_edge(BUTTON_STAR_PIN, 1000);
+		sim_edge(0, 50);
+	}
+	CHECK(sEvent.overflow == 1, "ring full: %u dropped", sEvent.overflow);
+	for (i=0; i<EVENT_RING_SIZE-1; i++) CHECK(sim_pop(BUTTON_STAR, sEvent.ring[sEvent.tail].stamp), "ring full: press %u", i);
+	
+	return (TEST_RESULT());
+}
@@ -0,0 +1,139 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// *************************************************************************************************
+// calendar_seconds() and calendar_split() against the C library calendar for every day of the 
+// valid range 2000 .. 2135, and the round trip of both.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include <time.h>
+#include "project.h"
+#include "test.h"
+
+// driver
+#include "calendar.h"
+
+
+// *************************************************************************************************
+// @fn          golden_seconds
+// @brief       Seconds since the epoch from the C library.
+// @param       u16 year .. u8 second		Date and time
+// @return      long long					Seconds since 1. Jan 2000 00:00:00
+// *************************************************************************************************
+long long golden_seconds(u16 year, u8 month, u8 day, u8 hour, u8 minute, u8 second)
+{
+	struct tm tm = { 0 };
+	
+	tm.tm_year = year - 1900;
+	tm.tm_mon  = month - 1;
+	tm.tm_mday = day;
+	tm.tm_hour = hour;
+	tm.tm_min  = minute;
+	tm.tm_sec  = second;
+	
+	return ((long long)timegm(&tm) - 946684800ll);
+}
+
+
+// *************************************************************************************************
+// @fn          check_time
+// @brief       Convert a date and time both ways.
+// @param       u16 year .. u8 second		Date and time
+//				u16 days					Expected day count
+// @return      none
+// *************************************************************************************************
+void check_time(u16 year, u8 month, u8 day, u8 hour, u8 minute, u8 second, u16 days)
+{
+	struct calendar cal;
+	u32 seconds = calendar_seconds(year, month, day, hour, minute, second);
+	
+	CHECK(seconds == golden_seconds(year, month, day, hour, minute, second), 
+		  "calendar_seconds(%u-%02u-%02u %02u:%02u:%02u) = %lu, expected %lld", 
+		  year, month, day, hour, minute, second, (unsigned long)seconds, 
+		  golden_seconds(year, month, day, hour, minute, second));
+	
+	calendar_split(seconds, &cal);
+	CHECK((cal.year == year) && (cal.month == month) && (cal.day == day) && 
+		  (cal.hour == hour) && (cal.minute == minute) && (cal.second == second), 
+		  "calendar_split(%lu) = %u-%02u-%02u %02u:%02u:%02u, expected %u-%02u-%02u %02u:%02u:%02u", 
+		  (unsigned long)seconds, cal.year, cal.month, cal.day, cal.hour, cal.minute, cal.second, 
+		  year, month, day, hour, minute, second);
+	
+	CHECK(calendar_days(year, month, day) == days, "calendar_days(%u-%02u-%02u) = %u, expected %u", 
+		  year, month, day, calendar_days(year, month, day), days);
+}
+
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Walk all days of the valid range at midnight, noon and the last second of the day.
+// @param       none
+// @return      int				0 if all checks passed
+// *************************************************************************************************
+int main(void)
+{
+	struct tm * tm;
+	time_t t;
+	u16 year, days = 0;
+	u8 month, day, weekday = CALENDAR_EPOCH_WEEKDAY;
+	
+	for (year=CALENDAR_EPOCH_YEAR; year<=CALENDAR_LAST_YEAR; year++)
+	{
+		for (month=1; month<=12; month++)
+		{
+			// Month length from the C library: day 0 of next month is the last day of this month
+			t = (time_t)(golden_seconds(year, month + 1, 1, 0, 0, 0) - 86400ll + 946684800ll);
+			tm = gmtime(&t);
+			CHECK(calendar_month_days(year, month) == tm->tm_mday, "calendar_month_days(%u, %u) = %u", 
+				  year, month, calendar_month_days(year, month));
+			
+			for (day=1; day<=calendar_month_days(year, month); day++, days++)
+			{
+				check_time(year, month, day, 0, 0, 0, days);
+				check_time(year, month, day, 12, 34, 56, days);
+				check_time(year, month, day, 23, 59, 59, days);
+				
+				CHECK(calendar_weekday(days) == weekday, "calendar_weekday(%u) = %u", days, calendar_weekday(days));
+				weekday = (weekday + 1) % 7;
+			}
+		}
+	}
+	
+	return (TEST_RESULT());
+}
@@ -0,0 +1,141 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// *************************************************************************************************
+// itoa() converts to packed BCD with the decimal add intrinsic. Its result must equal the lowest
+// digits of a plain decimal conversion, with the same leading '0' blanking as before.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include <string.h>
+#include "project.h"
+#include "test.h"
+
+// driver
+#include "display.h"
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Modules of the firmware that are not part of this test
+void (*fptr_lcd_function_line1)(u8 line, u8 update);
+void (*fptr_lcd_function_line2)(u8 line, u8 update);
+
+
+// *************************************************************************************************
+// @fn          ref_itoa
+// @brief       Reference conversion with host division.
+// @param       u32 n			Integer to convert
+//				u8 digits		Number of digits
+//				u8 blanks		Number of leading '0' to replace by ' '
+//				char * str		Result string
+// @return      none
+// *************************************************************************************************
+void ref_itoa(u32 n, u8 digits, u8 blanks, char * str)
+{
+	u8 i;
+	
+	for (i=digits; i>0; i--)
+	{
+		str[i-1] = '0' + n % 10;
+		n /= 10;
+	}
+	str[digits] = 0;
+	
+	for (i=0; (i<digits-1) && (str[i] == '0') && (blanks > 0); i++, blanks--) str[i] = ' ';
+}
+
+
+// *************************************************************************************************
+// @fn          check_itoa
+// @brief       Compare itoa with reference for all digits and blanks.
+// @param       u32 n			Integer to convert
+// @return      none
+// *************************************************************************************************
+void check_itoa(u32 n)
+{
+	char ref[8];
+	u8 digits, blanks;
+	u8 * str;
+	
+	for (digits=1; digits<=7; digits++)
+	{
+		for (blanks=0; blanks<=digits; blanks++)
+		{
+			ref_itoa(n, digits, blanks, ref);
+			str = itoa(n, digits, blanks);
+			CHECK(memcmp(str, ref, digits) == 0, "itoa(%lu, %u, %u) = \"%.*s\", expected \"%s\"", 
+				  (unsigned long)n, digits, blanks, digits, str, ref);
+		}
+	}
+}
+
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Check all values below 10^5, powers of 10 and 2 and their neighbours, and the 
+//				largest u32 values.
+// @param       none
+// @return      int				0 if all checks passed
+// *************************************************************************************************
+int main(void)
+{
+	u32 n, p;
+	u8 i;
+	
+	for (n=0; n<100000; n++) check_itoa(n);
+	for (p=10, i=0; i<9; i++, p*=10)
+	{
+		check_itoa(p - 1);
+		check_itoa(p);
+		check_itoa(p + 1);
+	}
+	for (i=20; i<32; i++)
+	{
+		check_itoa((1ul << i) - 1);
+		check_itoa(1ul << i);
+	}
+	for (n=0xFFFFFFFF; n>=0xFFFFFF00; n--) check_itoa(n);
+	
+	// Invalid number of digits leaves preset string
+	CHECK(memcmp(itoa(123, 0, 0), "0000000", 7) == 0, "itoa with 0 digits");
+	CHECK(memcmp(itoa(123, 8, 0), "0000000", 7) == 0, "itoa with 8 digits");
+	
+	return (TEST_RESULT());
+}
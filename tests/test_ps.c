@@ -0,0 +1,104 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// *************************************************************************************************
+// Pressure sensor DATARD16 wrap carry. Between two reads of DATARD8, ps_get_pa() takes the 3 MSB of 
+// the raw pressure from the last sample. ps_carry_lsb() must carry a wrap of the 16 LSB into them 
+// for every pressure change of less than 8192 Pa between two samples.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include "test.h"
+
+// driver
+#include "vti_ps.h"
+
+
+// *************************************************************************************************
+// Prototypes section
+u32 ps_carry_lsb(u32 raw, u16 lsb);
+
+
+// *************************************************************************************************
+// Defines section
+
+// Raw pressure is 1/4 Pa, sensor range is 30000 .. 120000 Pa
+#define RAW_MIN						(30000ul * 4)
+#define RAW_MAX						(120000ul * 4)
+
+// Largest change of raw pressure between two samples that is carried correctly
+#define RAW_STEP					(32767l)
+
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Walk the sensor range and check all changes up to RAW_STEP in both directions.
+// @param       none
+// @return      int				0 if all checks passed
+// *************************************************************************************************
+int main(void)
+{
+	u32 raw, next, got;
+	s32 step;
+	
+	for (raw=RAW_MIN; raw<=RAW_MAX; raw+=257)
+	{
+		for (step=-RAW_STEP; step<=RAW_STEP; step+=13)
+		{
+			next = raw + step;
+			got = ps_carry_lsb(raw, (u16)next);
+			CHECK(got == next, "ps_carry_lsb(%lu, 0x%04X) = %lu, expected %lu", 
+				  (unsigned long)raw, (u16)next, (unsigned long)got, (unsigned long)next);
+		}
+	}
+	
+	// Every wrap of the 16 LSB in both directions, largest steps
+	for (raw=0x20000ul; raw<=0x70000ul; raw+=0x10000ul)
+	{
+		for (step=-RAW_STEP; step<=RAW_STEP; step++)
+		{
+			next = raw + step;
+			got = ps_carry_lsb(raw, (u16)next);
+			CHECK(got == next, "ps_carry_lsb(%lu, 0x%04X) = %lu, expected %lu", 
+				  (unsigned long)raw, (u16)next, (unsigned long)got, (unsigned long)next);
+		}
+	}
+	
+	return (TEST_RESULT());
+}
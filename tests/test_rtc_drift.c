@@ -0,0 +1,186 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// *************************************************************************************************
+// Crystal drift learning. A watch whose crystal has a fixed error is synced once a day with whole 
+// seconds of a reference clock. rtc_drift_learn() must bring the calibration of RTC_A close to the 
+// crystal error, and rtc_cal_register() must round it to the nearest RTCCAL step.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include <stdlib.h>
+#include <math.h>
+#include "project.h"
+#include "test.h"
+
+// driver
+#include "rtc.h"
+
+
+// *************************************************************************************************
+// Defines section
+
+#define SYNCS						(60u)		// Days simulated per crystal
+#define SETTLED						(20u)		// Syncs after which the calibration must have settled
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Pseudo random numbers
+unsigned long sim_seed = 12345;
+
+
+// *************************************************************************************************
+// @fn          sim_random
+// @brief       Pseudo random number (LCG).
+// @param       none
+// @return      double			0 <= x < 1
+// *************************************************************************************************
+double sim_random(void)
+{
+	sim_seed = sim_seed * 1103515245ul + 12345ul;
+	return ((double)((sim_seed >> 8) & 0xFFFFFF) / 16777216.0);
+}
+
+
+// *************************************************************************************************
+// @fn          cal_ppm
+// @brief       Rate correction of RTC_A for a calibration register value.
+// @param       u8 reg			RTCCTL2 value
+// @return      s16				Correction in ppm (< 0: clock slowed down)
+// *************************************************************************************************
+s16 cal_ppm(u8 reg)
+{
+	if (reg & RTCCALS)	return (4 * (reg & 0x3F));
+	else				return (-2 * (reg & 0x3F));
+}
+
+
+// *************************************************************************************************
+// @fn          sim_crystal
+// @brief       Sync a watch about once a day and learn its crystal error like rtc_sync_time().
+// @param       s16 crystal		Crystal error in ppm
+//				double * worst	Largest remaining clock error after SETTLED syncs in ppm
+// @return      double			Mean remaining clock error after SETTLED syncs in ppm
+// *************************************************************************************************
+double sim_crystal(s16 crystal, double * worst)
+{
+	double now, offset, rate, sum = 0;
+	s32 error;
+	u32 interval;
+	u8 i;
+	
+	*worst = 0;
+	rtc_set_drift(0);
+	now = sim_random() * 86400.0;
+	
+	// Watch set to whole second of reference, prescaler phase is random
+	offset = floor(now) + sim_random() - now;
+	
+	for (i=0; i<SYNCS; i++)
+	{
+		// Next sync 18 .. 30 hours later
+		interval = 64800ul + (u32)(sim_random() * 43200.0);
+		rate = crystal + cal_ppm(RTCCTL2);
+		offset += rate * interval / 1e6;
+		now += interval;
+		
+		// Both clocks show whole seconds
+		error = (s32)(floor(now + offset) - floor(now));
+		if ((error <= RTC_DRIFT_MAX_ERROR) && (error >= -RTC_DRIFT_MAX_ERROR))
+		{
+			rtc_set_drift(rtc_drift_learn(sRtcDrift.ppm, error, interval));
+		}
+		offset = floor(now) + sim_random() - now;
+		
+		if (i >= SETTLED)
+		{
+			rate = crystal + cal_ppm(RTCCTL2);
+			sum += rate;
+			if (fabs(rate) > *worst) *worst = fabs(rate);
+		}
+	}
+	
+	return (sum / (SYNCS - SETTLED));
+}
+
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Check calibration steps and drift learning for fast and slow crystals.
+// @param       none
+// @return      int				0 if all checks passed
+// *************************************************************************************************
+int main(void)
+{
+	static const s16 crystals[] = { 0, 3, -3, 20, -20, 37, -80, 125, -250 };
+	static const s16 outside[] = { 200, -300 };
+	double mean, worst;
+	s16 ppm;
+	u8 i;
+	
+	// Nearest step: 2 ppm for fast crystals, 4 ppm for slow crystals, limited to 63 steps
+	for (ppm=-400; ppm<=400; ppm++)
+	{
+		s16 want = (ppm > RTC_DRIFT_PPM_MAX) ? RTC_DRIFT_PPM_MAX : (ppm < RTC_DRIFT_PPM_MIN) ? RTC_DRIFT_PPM_MIN : ppm;
+		s16 got  = -cal_ppm(rtc_cal_register(ppm));
+		
+		CHECK(abs(got - want) <= ((want >= 0) ? 1 : 2), "rtc_cal_register(%d) corrects %d ppm", ppm, got);
+		CHECK((rtc_cal_register(ppm) & 0x3F) <= 63, "rtc_cal_register(%d) out of range", ppm);
+	}
+	
+	// Learned calibration: one second in a day is 11.6 ppm. Halving the correction damps this to 
+	// a few ppm around the crystal error.
+	for (i=0; i<sizeof(crystals)/sizeof(crystals[0]); i++)
+	{
+		mean = sim_crystal(crystals[i], &worst);
+		CHECK(fabs(mean) <= 1.0, "crystal %d ppm: mean remaining error %.2f ppm", crystals[i], mean);
+		CHECK(worst <= 8.0, "crystal %d ppm: remaining error up to %.2f ppm", crystals[i], worst);
+	}
+	
+	// Crystal errors outside the RTCCAL range stay at the limit
+	for (i=0; i<sizeof(outside)/sizeof(outside[0]); i++)
+	{
+		sim_crystal(outside[i], &worst);
+		ppm = (outside[i] > 0) ? RTC_DRIFT_PPM_MAX : RTC_DRIFT_PPM_MIN;
+		CHECK(sRtcDrift.ppm == ppm, "crystal %d ppm: calibration %d ppm", outside[i], sRtcDrift.ppm);
+	}
+	
+	return (TEST_RESULT());
+}
@@ -0,0 +1,148 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// *************************************************************************************************
+// sidereal_seconds() against golden values over 100 years. The 32x32 bit product built from four
+// 16x16 bit products must equal the exact 64 bit product with SIDEREAL_GAIN_Q40, and the result
+// must stay within one truncated second of a long double evaluation of the sidereal rate.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+#include "test.h"
+
+// logic
+#include "sidereal.h"
+
+
+// *************************************************************************************************
+// Defines section
+
+// Must match logic/sidereal.c - fixed time is 67476.00016 sidereal seconds, the firmware starts 
+// at the whole second
+#define FIX_SIDSEC					(67476ul)
+#define SIDEREAL_RATE				(1.002737909350795L)
+#define SIDEREAL_GAIN_Q40			(3010363167ull)
+
+// Rounding of SIDEREAL_GAIN_Q40 over 100 years
+#define GAIN_ROUNDING				(20e-6L)
+
+#define CENTURY						(36525ul * 86400ul)
+
+
+// *************************************************************************************************
+// @fn          exact_seconds
+// @brief       Sidereal second of the day with the exact 64 bit product of the firmware constant.
+// @param       u32 rawtime			Solar seconds since fixed time
+// @return      u32					Sidereal seconds since 00:00:00
+// *************************************************************************************************
+u32 exact_seconds(u32 rawtime)
+{
+	unsigned long long gain = ((unsigned long long)rawtime * SIDEREAL_GAIN_Q40) >> 40;
+	
+	return ((FIX_SIDSEC + rawtime % 86400 + gain % 86400) % 86400);
+}
+
+
+// *************************************************************************************************
+// @fn          golden_seconds
+// @brief       Sidereal time of the day from the sidereal rate in long double.
+// @param       u32 rawtime			Solar seconds since fixed time
+// @return      long double			Sidereal seconds since 00:00:00, with fraction
+// *************************************************************************************************
+long double golden_seconds(u32 rawtime)
+{
+	long double sid = FIX_SIDSEC + (long double)rawtime * SIDEREAL_RATE;
+	
+	return (sid - 86400.0L * (unsigned long long)(sid / 86400.0L));
+}
+
+
+// *************************************************************************************************
+// @fn          check_seconds
+// @brief       Compare sidereal_seconds() with exact product and golden value. The golden value
+//				must be truncated to the same second, unless it is so close to a whole second 
+//				that the rounding of the gain constant decides.
+// @param       u32 rawtime			Solar seconds since fixed time
+// @return      none
+// *************************************************************************************************
+void check_seconds(u32 rawtime)
+{
+	u32 got = sidereal_seconds(rawtime);
+	long double diff = golden_seconds(rawtime) - got;
+	
+	// Wrap at midnight
+	if (diff > 43200.0L)  diff -= 86400.0L;
+	if (diff < -43200.0L) diff += 86400.0L;
+	
+	CHECK(got == exact_seconds(rawtime), "sidereal_seconds(%lu) = %lu, exact product gives %lu", 
+		  (unsigned long)rawtime, (unsigned long)got, (unsigned long)exact_seconds(rawtime));
+	CHECK((diff >= -GAIN_ROUNDING) && (diff < 1.0L + GAIN_ROUNDING), "sidereal_seconds(%lu) = %lu, golden %.6Lf", 
+		  (unsigned long)rawtime, (unsigned long)got, golden_seconds(rawtime));
+}
+
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Check every 997 s over 100 years, and operands whose partial products carry.
+// @param       none
+// @return      int				0 if all checks passed
+// *************************************************************************************************
+int main(void)
+{
+	u32 rawtime, a0, a1;
+	u8 i, j;
+	static const u16 halves[] = { 0x0000, 0x0001, 0x7FFF, 0x8000, 0xFFFE, 0xFFFF };
+	
+	for (rawtime=0; rawtime<CENTURY; rawtime+=997) check_seconds(rawtime);
+	
+	// Low halves of all partial products overflow into the upper 32 bits
+	for (i=0; i<sizeof(halves)/sizeof(halves[0]); i++)
+	{
+		for (j=0; j<sizeof(halves)/sizeof(halves[0]); j++)
+		{
+			a1 = halves[i];
+			a0 = halves[j];
+			rawtime = (a1 << 16) | a0;
+			if (rawtime < CENTURY) check_seconds(rawtime);
+			CHECK(sidereal_seconds(rawtime) == exact_seconds(rawtime), "sidereal_seconds(0x%08lX) carry", (unsigned long)rawtime);
+		}
+	}
+	
+	return (TEST_RESULT());
+}
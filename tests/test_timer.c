@@ -0,0 +1,397 @@
+// *************************************************************************************************
+//
+//	Copyright (C) 2009 Texas Instruments Incorporated - http://www.ti.com/ 
+//	 
+//	 
+//	  Redistribution and use in source and binary forms, with or without 
+//	  modification, are permitted provided that the following conditions 
+//	  are met:
+//	
+//	    Redistributions of source code must retain the above copyright 
+//	    notice, this list of conditions and the following disclaimer.
+//	 
+//	    Redistributions in binary form must reproduce the above copyright
+//	    notice, this list of conditions and the following disclaimer in the 
+//	    documentation and/or other materials provided with the   
+//	    distribution.
+//	 
+//	    Neither the name of Texas Instruments Incorporated nor the names of
+//	    its contributors may be used to endorse or promote products derived
+//	    from this software without specific prior written permission.
+//	
+//	  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+//	  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+//	  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//	  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+//	  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+//	  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+//	  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+//	  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//	  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+//	  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+//	  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *************************************************************************************************
+// Wakeups of TIMER0_A0_ISR and RTC_ISR over 24 hours. RTC_A and Timer0_A5 are simulated from one
+// 32768 Hz clock, the main loop only re-arms the deadline slots before going back to LPM3. 
+// With only the clock on screen the CPU must wake up once a minute and CCR0 must stay off.
+// A count-down of the timer engine must not step TA0CCR2 while its expiry is far away.
+// *************************************************************************************************
+
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include <string.h>
+#include "project.h"
+#include "test.h"
+
+// driver
+#include "timer.h"
+#include "rtc.h"
+#include "calendar.h"
+#include "display.h"
+#include "event.h"
+#include "ports.h"
+#include "retain.h"
+#include "chrono.h"
+#include "vti_as.h"
+
+// logic
+#include "clock.h"
+#include "date.h"
+#include "alarm.h"
+#include "altitude.h"
+#include "acceleration.h"
+#include "temperature.h"
+#include "menu.h"
+#include "rfsimpliciti.h"
+#include "stopwatch.h"
+
+
+// *************************************************************************************************
+// Defines section
+
+#define DAY_TICKS					(CALENDAR_DAY * 32768ull)
+
+// TA0R is not in phase with the RTC prescaler
+#define TA0R_PHASE					(12345u)
+
+// Count-down of the timer engine: 1 hour and a fraction of a second
+#define CHRONO_DUE					(3600ul * 32768ul + 4321ul)
+
+
+// *************************************************************************************************
+// Global Variable section
+
+// Modules of the firmware that are not part of this test
+volatile s_display_flags display;
+volatile s_system_flags sys;
+volatile s_message_flags message;
+volatile struct struct_button sButton;
+struct time sTime;
+struct date sDate;
+struct alarm sAlarm;
+struct alt sAlt;
+struct accel sAccel;
+struct RFsmpl sRFsmpl;
+unsigned char simpliciti_flag;
+
+// Simulated ACLK ticks since start
+unsigned long long sim_ticks;
+
+// Interrupts taken, tick of first CCR0 IRQ
+unsigned long sim_ccr0_irqs;
+unsigned long long sim_ccr0_first;
+unsigned long sim_ccr0_idle;
+unsigned long sim_rtc_irqs;
+unsigned long sim_ccr2_irqs;
+
+// Tick of timer engine expiry, 0 = not expired
+unsigned long long sim_expired;
+
+// Views that show seconds
+u8 sim_second_view;
+
+
+// *************************************************************************************************
+// Extern section
+extern void TIMER0_A0_ISR(void);
+extern void TIMER0_A1_5_ISR(void);
+extern void RTC_ISR(void);
+
+
+// *************************************************************************************************
+// Firmware functions called by timer.c and rtc.c
+u8 menu_needs_second_tick(void) { return (sim_second_view); }
+u8 is_rf(void) { return (0); }
+u8 is_temp_measurement(void) { return (0); }
+u8 is_altitude_measurement(void) { return (0); }
+u8 is_acceleration_measurement(void) { return (0); }
+u8 stopwatch_keep_refresh(void) { return (0); }
+u8 event_push(u8 type, u8 arg) { return (1); }
+void event_push_level(u8 type) { }
+void retain_save(void) { }
+void alarm_schedule(void) { }
+void stop_alarm(void) { }
+void stop_altitude_measurement(void) { }
+void as_stop(void) { }
+void display_defer_chars(u8 segments, u8 * str, u8 mode) { }
+void display_defer_symbol(u8 symbol, u8 mode) { }
+
+
+// *************************************************************************************************
+// @fn          sim_rtc_load
+// @brief       Load RTC_A calendar registers.
+// @param       u32 seconds		Seconds since calendar epoch
+// @return      none
+// *************************************************************************************************
+void sim_rtc_load(u32 seconds)
+{
+	struct calendar cal;
+	
+	calendar_split(seconds, &cal);
+	RTCYEAR = cal.year;
+	RTCMON  = cal.month;
+	RTCDAY  = cal.day;
+	RTCHOUR = cal.hour;
+	RTCMIN  = cal.minute;
+	RTCSEC  = cal.second;
+}
+
+
+// *************************************************************************************************
+// @fn          sim_expire
+// @brief       Expiry function of the timer engine.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void sim_expire(void)
+{
+	sim_expired = sim_ticks;
+}
+
+
+// *************************************************************************************************
+// @fn          sim_to_ccr
+// @brief       Ticks until a capture compare register matches.
+// @param       u16 cctl		TA0CCTLx
+//				u16 ccr			TA0CCRx
+// @return      unsigned long long	Ticks, ~0 = IRQ disabled
+// *************************************************************************************************
+unsigned long long sim_to_ccr(u16 cctl, u16 ccr)
+{
+	if (!(cctl & CCIE)) return (~0ull);
+	if (cctl & CCIFG)	return (0);
+	if (ccr == TA0R)	return (0x10000);
+	return ((u16)(ccr - TA0R));
+}
+
+
+// *************************************************************************************************
+// @fn          sim_advance
+// @brief       Let ACLK run until the next RTC second, CCR0 or CCR2 match and take the interrupt. 
+//				The main loop re-arms the deadline slots after every wakeup.
+// @param       unsigned long long until		Stop at this tick if nothing happens before
+// @return      none
+// *************************************************************************************************
+void sim_advance(unsigned long long until)
+{
+	unsigned long long to_second, to_ccr0, to_ccr2;
+	unsigned long exits;
+	u32 seconds;
+	
+	to_second = 32768 - (sim_ticks & 0x7FFF);
+	to_ccr0 = sim_to_ccr(TA0CCTL0, TA0CCR0);
+	to_ccr2 = sim_to_ccr(TA0CCTL2, TA0CCR2);
+	
+	exits = host_lpm_exits;
+	if ((to_second > until - sim_ticks) && (to_ccr0 > until - sim_ticks) && (to_ccr2 > until - sim_ticks))
+	{
+		sim_ticks = until;
+		TA0R  = (u16)(sim_ticks + TA0R_PHASE);
+		RTCPS = (u16)(sim_ticks & 0x7FFF);
+		return;
+	}
+	
+	if ((to_second <= to_ccr0) && (to_second <= to_ccr2))
+	{
+		sim_ticks += to_second;
+		TA0R  = (u16)(sim_ticks + TA0R_PHASE);
+		RTCPS = 0;
+		
+		seconds = calendar_seconds(RTCYEAR, RTCMON, RTCDAY, RTCHOUR, RTCMIN, RTCSEC) + 1;
+		sim_rtc_load(seconds);
+		if (RTCSEC == 0)
+		{
+			sim_rtc_irqs++;
+			RTCIV = RTC_IV_MINUTE;
+			RTC_ISR();
+		}
+	}
+	else if (to_ccr2 < to_ccr0)
+	{
+		sim_ticks += to_ccr2;
+		TA0R  = (u16)(sim_ticks + TA0R_PHASE);
+		RTCPS = (u16)(sim_ticks & 0x7FFF);
+		
+		sim_ccr2_irqs++;
+		TA0CCTL2 |= CCIFG;
+		TA0IV = 0x04;
+		TIMER0_A1_5_ISR();
+	}
+	else
+	{
+		sim_ticks += to_ccr0;
+		TA0R  = (u16)(sim_ticks + TA0R_PHASE);
+		RTCPS = (u16)(sim_ticks & 0x7FFF);
+		
+		if (sim_ccr0_irqs++ == 0) sim_ccr0_first = sim_ticks;
+		TA0CCTL0 |= CCIFG;
+		TIMER0_A0_ISR();
+		if (host_lpm_exits == exits) sim_ccr0_idle++;
+	}
+	
+	// Main loop
+	if (host_lpm_exits != exits) Timer0_A0_Refresh();
+}
+
+
+// *************************************************************************************************
+// @fn          sim_digit_steps
+// @brief       Step a timer value by chrono_digit_delay() like the display refresh does. Each step 
+//				must end exactly where the shown digits change.
+// @param       u32 from		Start value (1/32768 sec)
+//				u32 to			Stop counting up at this value
+//				u8 rate			CHRONO_10HZ or CHRONO_1HZ
+//				u8 down			1 = count down to 0
+// @return      unsigned long	Number of steps, 0 if a step missed a digit change
+// *************************************************************************************************
+unsigned long sim_digit_steps(u32 from, u32 to, u8 rate, u8 down)
+{
+	unsigned long steps = 0;
+	u8 now[8], before[8], after[8];
+	u8 shown = (rate == CHRONO_10HZ) ? 7 : 6;
+	u32 ticks = from;
+	u16 delay;
+	
+	while (down ? (ticks > 0) : (ticks < to))
+	{
+		delay = chrono_digit_delay(ticks, rate, down);
+		if (down && (delay > ticks)) break;
+		
+		ticks = down ? (ticks - delay) : (ticks + delay);
+		chrono_digits(ticks, after);
+		chrono_digits(down ? (ticks + delay) : (ticks - delay), now);
+		chrono_digits(down ? (ticks + 1) : (ticks - 1), before);
+		if (memcmp(now, before, shown) || !memcmp(before, after, shown)) return (0);
+		steps++;
+	}
+	
+	return (steps);
+}
+
+
+// *************************************************************************************************
+// @fn          sim_reset
+// @brief       Power-up: RTC at 1. Aug 2009 04:30:00, system time 0, nothing scheduled.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void sim_reset(void)
+{
+	memset(&sTimer, 0, sizeof(sTimer));
+	sim_ticks = 0;
+	TA0R = TA0R_PHASE;
+	TA0CCTL0 = 0;
+	TA0CCTL2 = 0;
+	memset(sChrono, 0, sizeof(sChrono));
+	RTCPS = 0;
+	sim_rtc_load(calendar_seconds(2009, 8, 1, 4, 30, 0));
+	
+	Timer0_Init();
+	Timer0_Set_Seconds(0);
+	host_sr = GIE;
+	
+	sim_ccr0_irqs = sim_ccr0_idle = sim_rtc_irqs = sim_ccr2_irqs = 0;
+	sim_expired = 0;
+	host_lpm_exits = 0;
+	sim_second_view = 0;
+	sButton.backlight_status = 0;
+	
+	Timer0_A0_Refresh();
+}
+
+
+// *************************************************************************************************
+// @fn          main
+// @brief       Count wakeups for clock only, seconds view, a far deadline, a clock set and a 
+//				count-down of the timer engine.
+// @param       none
+// @return      int				0 if all checks passed
+// *************************************************************************************************
+int main(void)
+{
+	unsigned long long due;
+	
+	// Only hours and minutes on screen: RTC_A minute IRQ, nothing else
+	sim_reset();
+	while (sim_ticks < DAY_TICKS) sim_advance(DAY_TICKS);
+	CHECK(sim_ccr0_irqs == 0, "clock only: %lu CCR0 IRQs", sim_ccr0_irqs);
+	CHECK(host_lpm_exits == 1440, "clock only: %lu wakeups", host_lpm_exits);
+	CHECK(Timer0_Seconds() == CALENDAR_DAY, "clock only: system time %lu", (unsigned long)Timer0_Seconds());
+	
+	// Seconds on screen: one CCR0 IRQ per second, each one due. The IRQ of the last second comes
+	// TIMER0_A0_LATE ticks after the end of the day.
+	sim_reset();
+	sim_second_view = 1;
+	Timer0_A0_Refresh();
+	while (sim_ticks < DAY_TICKS) sim_advance(DAY_TICKS);
+	CHECK(sim_ccr0_irqs == CALENDAR_DAY - 1, "seconds view: %lu CCR0 IRQs", sim_ccr0_irqs);
+	CHECK(sim_ccr0_idle == 0, "seconds view: %lu CCR0 IRQs without work", sim_ccr0_idle);
+	CHECK(host_lpm_exits == CALENDAR_DAY - 1 + 1440, "seconds view: %lu wakeups", host_lpm_exits);
+	
+	// Deadline minutes ahead: left to the minute IRQ until the last minute, then CCR0 steps of
+	// up to 2 seconds without wakeup. Due second must have started when the slot is serviced.
+	sim_reset();
+	sButton.backlight_status = 1;
+	Timer0_A0_Schedule(TICK_BACKLIGHT, 150);
+	while (sButton.backlight_status) sim_advance(~0ull);
+	due = 150 * 32768ull;
+	CHECK((sim_ticks >= due) && (sim_ticks <= due + TIMER0_A0_LATE), "deadline 150 s: serviced at tick %llu", sim_ticks);
+	CHECK(sim_ccr0_first + 60 * 32768ull >= due, "deadline 150 s: first CCR0 IRQ at tick %llu", sim_ccr0_first);
+	CHECK(sim_ccr0_irqs <= 31, "deadline 150 s: %lu CCR0 IRQs", sim_ccr0_irqs);
+	CHECK(host_lpm_exits == 2 + 1, "deadline 150 s: %lu wakeups", host_lpm_exits);
+	
+	// Clock set 3 hours back while a deadline is armed: system time and deadline keep their pace
+	sim_reset();
+	while (sim_ticks < 10 * 32768ull + 5000) sim_advance(10 * 32768ull + 5000);
+	sButton.backlight_status = 1;
+	Timer0_A0_Schedule(TICK_BACKLIGHT, 20);
+	rtc_set_time(1, 30, 10);
+	CHECK(Timer0_Seconds() == 10, "clock set: system time %lu", (unsigned long)Timer0_Seconds());
+	while (sButton.backlight_status) sim_advance(~0ull);
+	due = 30 * 32768ull;
+	CHECK((sim_ticks >= due) && (sim_ticks <= due + TIMER0_A0_LATE), "clock set: serviced at tick %llu", sim_ticks);
+	
+	// Count-down an hour ahead: TA0CCR2 stays off until less than two seconds are left. Deadline 
+	// slot TICK_CHRONO gets there with CCR0 steps that wake nobody.
+	sim_reset();
+	chrono_set_function(CHRONO_EGGTIMER, CHRONO_DUE, 0, sim_expire);
+	chrono_start(CHRONO_EGGTIMER, Timer0_Ticks());
+	while (!sim_expired) sim_advance(~0ull);
+	CHECK(sim_expired == CHRONO_DUE, "count-down: expired at tick %llu", sim_expired);
+	CHECK(sim_ccr2_irqs == 1, "count-down: %lu CCR2 IRQs", sim_ccr2_irqs);
+	CHECK(sim_ccr0_irqs == sim_ccr0_idle, "count-down: %lu CCR0 IRQs with wakeup", sim_ccr0_irqs - sim_ccr0_idle);
+	CHECK(sim_ccr0_irqs <= 31, "count-down: %lu CCR0 IRQs", sim_ccr0_irqs);
+	CHECK(host_lpm_exits == 60 + 1, "count-down: %lu wakeups", host_lpm_exits);
+	
+	// Display refresh of 20 minutes: one step per shown digit change, none early or late
+	CHECK(sim_digit_steps(0, 1200 * 32768ul, CHRONO_10HZ, 0) == 12000, "refresh 10 Hz: steps");
+	CHECK(sim_digit_steps(TA0R_PHASE, 1200 * 32768ul, CHRONO_1HZ, 0) == 1200, "refresh 1 Hz: steps");
+	CHECK(sim_digit_steps(1200 * 32768ul, 0, CHRONO_10HZ, 1) == 12000, "refresh 10 Hz count-down: steps");
+	CHECK(sim_digit_steps(1200 * 32768ul + TA0R_PHASE, 0, CHRONO_1HZ, 1) == 1200, "refresh 1 Hz count-down: steps");
+	
+	return (TEST_RESULT());
+}
@@ -68,6 +68,12 @@ DATA["USE_LCD_CHARGE_PUMP"] = {
         "help": "Use the internal charge pump to make the display contrast contstant through the whole battery lifetime. As a downside this increases currency and reduces battery lifetime.",
 }
 
+DATA["USE_LCD_DOUBLE_BUFFER"] = {
+        "name": "Double buffered LCD updates",
+        "default": False,
+        "help": "Render each frame into the hidden LCD memory page and flip pages at once. Removes flicker of line redraws. Blinking segments are then timed by software with the 1 second clock tick.",
+}
+
 DATA["USE_WATCHDOG"] = {
         "name": "Use Watchdog (20 bytes)",
         "default": True,
@@ -178,10 +184,10 @@ DATA["CONFIG_SIDEREAL"] = {
 
 
 DATA["CONFIG_INFOMEM"] = {
-        "name": "Information Memory Driver (2934 bytes, requires sidereal clock)",
+        "name": "Information Memory Driver (2934 bytes)",
         "depends": [],
         "default": False,
-        "help": "Build driver for usage of the Information Memory.\n"
+        "help": "Build driver for usage of the Information Memory. Keeps sidereal clock settings and the learned crystal calibration over battery changes.\n"
                 "COMPILATION WILL LIKELY FAIL WITH mspgcc4 <20100829 !"
         }
 